@@ -3,7 +3,71 @@
 #include <vector>
 #include <cstdlib>
 #include <ctime>
+#include "temporizador_fases.h"
+#include "contadores_hardware.h"
+#include "memoria_nodo.h"
+
+// Genera cantidad_datos valores aleatorios en [valor_minimo, valor_maximo]
+void generar_datos(std::vector<float>& datos, int cantidad_datos, float valor_minimo, float valor_maximo) {
+    datos.resize(cantidad_datos);
+    for (int i = 0; i < cantidad_datos; i++) {
+        datos[i] = valor_minimo + (valor_maximo - valor_minimo) * ((float)rand() / RAND_MAX);
+    }
+}
+
+// Histograma distribuido: reparte los datos del proceso 0 con MPI_Scatter,
+// cuenta en cada proceso y suma los conteos en el proceso 0 con MPI_Reduce.
+// Con MEMORIA_NODO=1 cada nodo recibe los datos de sus procesos en copia_nodo
+// y cada proceso cuenta su parte ahí mismo. Los buffers los pasa quien llama
+// para poder reutilizarlos entre ejecuciones
+void calcular_histograma(const std::vector<float>& datos, int cantidad_datos, int numero_bins,
+                         float valor_minimo, float valor_maximo, int numero_procesos,
+                         std::vector<float>& mi_porcion_datos, VentanaNodo& copia_nodo,
+                         std::vector<int>& histograma_local, std::vector<int>& histograma_global) {
+    // Calcular cantidad de datos por proceso
+    int datos_locales = cantidad_datos / numero_procesos;
+
+    // Distribuir datos entre procesos
+    const float* porcion;
+    {
+        TemporizadorFase temporizador(FASE_DISTRIBUCION);
+        if (memoria_nodo_activa()) {
+            porcion = repartir_en_nodo(copia_nodo, datos.data(), datos_locales, MPI_FLOAT);
+        } else {
+            mi_porcion_datos.resize(datos_locales);
+            MPI_Scatter(datos.data(), datos_locales, MPI_FLOAT,
+                        mi_porcion_datos.data(), datos_locales, MPI_FLOAT, 0, MPI_COMM_WORLD);
+            porcion = mi_porcion_datos.data();
+        }
+    }
+
+    // Inicializar histograma local
+    histograma_local.assign(numero_bins, 0);
+    float ancho_bin = (valor_maximo - valor_minimo) / numero_bins;
+
+    // Calcular histograma local
+    {
+        TemporizadorFase temporizador(FASE_CALCULO);
+        MedicionHardware medicion("histograma", datos_locales, (double)datos_locales * sizeof(float));
+        for (int i = 0; i < datos_locales; i++) {
+            int indice_bin = (int)((porcion[i] - valor_minimo) / ancho_bin);
+            // Manejar casos límite
+            if (indice_bin >= numero_bins) indice_bin = numero_bins - 1;
+            if (indice_bin < 0) indice_bin = 0;
+            histograma_local[indice_bin]++;
+        }
+    }
+
+    // Buffer para el histograma global (solo se usa en el proceso 0)
+    histograma_global.resize(numero_bins);
+
+    // Reducir histogramas locales al histograma global
+    TemporizadorFase temporizador(FASE_REDUCCION);
+    MPI_Reduce(histograma_local.data(), histograma_global.data(), numero_bins, MPI_INT,
+               MPI_SUM, 0, MPI_COMM_WORLD);
+}
 
+#ifndef NUCLEOS_SIN_MAIN
 int main(int argc, char* argv[]) {
     int numero_procesos, mi_rango;
     MPI_Init(&argc, &argv);
@@ -26,12 +90,10 @@ int main(int argc, char* argv[]) {
         std::cout << "Ingrese valor máximo: ";
         std::cin >> valor_maximo;
 
-        // Generar datos aleatorios
-        datos.resize(cantidad_datos);
+        // Generar datos aleatorios (la lectura de std::cin queda fuera: incluye la espera al usuario)
+        TemporizadorFase temporizador(FASE_ENTRADA);
         srand(time(NULL));
-        for (int i = 0; i < cantidad_datos; i++) {
-            datos[i] = valor_minimo + (valor_maximo - valor_minimo) * ((float)rand() / RAND_MAX);
-        }
+        generar_datos(datos, cantidad_datos, valor_minimo, valor_maximo);
 
         std::cout << "\nDatos generados aleatoriamente entre " << valor_minimo
                   << " y " << valor_maximo << std::endl;
@@ -43,38 +105,18 @@ int main(int argc, char* argv[]) {
     MPI_Bcast(&valor_minimo, 1, MPI_FLOAT, 0, MPI_COMM_WORLD);
     MPI_Bcast(&valor_maximo, 1, MPI_FLOAT, 0, MPI_COMM_WORLD);
 
-    // Calcular cantidad de datos por proceso
-    int datos_locales = cantidad_datos / numero_procesos;
-    std::vector<float> mi_porcion_datos(datos_locales);
-
-    // Distribuir datos entre procesos
-    MPI_Scatter(datos.data(), datos_locales, MPI_FLOAT,
-                mi_porcion_datos.data(), datos_locales, MPI_FLOAT, 0, MPI_COMM_WORLD);
-
-    // Inicializar histograma local
-    histograma_local.resize(numero_bins, 0);
+    // Scatter, conteo local y reducción en el proceso 0
+    std::vector<float> mi_porcion_datos;
+    VentanaNodo copia_nodo;
+    calcular_histograma(datos, cantidad_datos, numero_bins, valor_minimo, valor_maximo, numero_procesos,
+                        mi_porcion_datos, copia_nodo, histograma_local, histograma_global);
+    copia_nodo.liberar();
+    informar_memoria_nodo();
     float ancho_bin = (valor_maximo - valor_minimo) / numero_bins;
 
-    // Calcular histograma local
-    for (int i = 0; i < datos_locales; i++) {
-        int indice_bin = (int)((mi_porcion_datos[i] - valor_minimo) / ancho_bin);
-        // Manejar casos límite
-        if (indice_bin >= numero_bins) indice_bin = numero_bins - 1;
-        if (indice_bin < 0) indice_bin = 0;
-        histograma_local[indice_bin]++;
-    }
-
-    // Preparar buffer para histograma global (solo en proceso 0)
-    if (mi_rango == 0) {
-        histograma_global.resize(numero_bins);
-    }
-
-    // Reducir histogramas locales al histograma global
-    MPI_Reduce(histograma_local.data(), histograma_global.data(), numero_bins, MPI_INT,
-               MPI_SUM, 0, MPI_COMM_WORLD);
-
     // El proceso 0 imprime el histograma final
     if (mi_rango == 0) {
+        TemporizadorFase temporizador(FASE_SALIDA);
         std::cout << "\n=== HISTOGRAMA FINAL ===" << std::endl;
         std::cout << "Rango\t\t\tFrecuencia" << std::endl;
         std::cout << "-----\t\t\t----------" << std::endl;
@@ -89,6 +131,9 @@ int main(int argc, char* argv[]) {
         std::cout << "\nTotal de datos procesados: " << cantidad_datos << std::endl;
     }
 
+    reportar_fases(MPI_COMM_WORLD);
+    reportar_contadores(MPI_COMM_WORLD);
     MPI_Finalize();
     return 0;
-}
\ No newline at end of file
+}
+#endif
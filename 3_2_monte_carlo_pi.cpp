@@ -3,7 +3,43 @@
 #include <cstdlib>
 #include <ctime>
 #include <random>
+#include "temporizador_fases.h"
+#include "contadores_hardware.h"
 
+// Lanza total_lanzamientos / numero_procesos dardos en cada proceso y suma con
+// MPI_Reduce los que caen dentro del círculo unitario (resultado en el proceso 0)
+long long int lanzar_dardos(long long int total_lanzamientos, int numero_procesos, std::mt19937& generador) {
+    // Calcular lanzamientos por proceso
+    long long int lanzamientos_locales = total_lanzamientos / numero_procesos;
+    long long int puntos_en_circulo_local = 0;
+    long long int puntos_en_circulo_global = 0;
+    std::uniform_real_distribution<double> distribucion(-1.0, 1.0);
+
+    // Realizar lanzamientos locales (simulación Monte Carlo)
+    {
+        TemporizadorFase temporizador(FASE_CALCULO);
+        MedicionHardware medicion("lanzamientos", lanzamientos_locales, 0);  // no recorre memoria
+        for (long long int lanzamiento = 0; lanzamiento < lanzamientos_locales; lanzamiento++) {
+            double x = distribucion(generador);  // Coordenada x aleatoria entre -1 y 1
+            double y = distribucion(generador);  // Coordenada y aleatoria entre -1 y 1
+
+            double distancia_cuadrada = x * x + y * y;
+
+            // Si el punto está dentro del círculo unitario
+            if (distancia_cuadrada <= 1.0) {
+                puntos_en_circulo_local++;
+            }
+        }
+    }
+
+    // Reducir resultados locales al resultado global
+    TemporizadorFase temporizador(FASE_REDUCCION);
+    MPI_Reduce(&puntos_en_circulo_local, &puntos_en_circulo_global, 1,
+               MPI_LONG_LONG_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+    return puntos_en_circulo_global;
+}
+
+#ifndef NUCLEOS_SIN_MAIN
 int main(int argc, char* argv[]) {
     int numero_procesos, mi_rango;
     MPI_Init(&argc, &argv);
@@ -11,8 +47,6 @@ int main(int argc, char* argv[]) {
     MPI_Comm_rank(MPI_COMM_WORLD, &mi_rango);
 
     long long int total_lanzamientos;
-    long long int puntos_en_circulo_local = 0;
-    long long int puntos_en_circulo_global = 0;
 
     // El proceso 0 lee el número total de lanzamientos
     if (mi_rango == 0) {
@@ -29,29 +63,19 @@ int main(int argc, char* argv[]) {
     long long int lanzamientos_locales = total_lanzamientos / numero_procesos;
 
     // Configurar generador de números aleatorios único para cada proceso
-    std::random_device dispositivo_aleatorio;
-    std::mt19937 generador(dispositivo_aleatorio() + mi_rango);
-    std::uniform_real_distribution<double> distribucion(-1.0, 1.0);
-
-    // Realizar lanzamientos locales (simulación Monte Carlo)
-    for (long long int lanzamiento = 0; lanzamiento < lanzamientos_locales; lanzamiento++) {
-        double x = distribucion(generador);  // Coordenada x aleatoria entre -1 y 1
-        double y = distribucion(generador);  // Coordenada y aleatoria entre -1 y 1
-
-        double distancia_cuadrada = x * x + y * y;
-
-        // Si el punto está dentro del círculo unitario
-        if (distancia_cuadrada <= 1.0) {
-            puntos_en_circulo_local++;
-        }
+    std::mt19937 generador;
+    {
+        TemporizadorFase temporizador(FASE_ENTRADA);
+        std::random_device dispositivo_aleatorio;
+        generador.seed(dispositivo_aleatorio() + mi_rango);
     }
 
-    // Reducir resultados locales al resultado global
-    MPI_Reduce(&puntos_en_circulo_local, &puntos_en_circulo_global, 1,
-               MPI_LONG_LONG_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+    // Lanzamientos locales y reducción al proceso 0
+    long long int puntos_en_circulo_global = lanzar_dardos(total_lanzamientos, numero_procesos, generador);
 
     // El proceso 0 calcula e imprime la estimación de π
     if (mi_rango == 0) {
+        TemporizadorFase temporizador(FASE_SALIDA);
         double estimacion_pi = 4.0 * puntos_en_circulo_global / ((double)total_lanzamientos);
 
         std::cout << "\n=== RESULTADOS ===" << std::endl;
@@ -66,6 +90,9 @@ int main(int argc, char* argv[]) {
                   << lanzamientos_locales << " lanzamientos" << std::endl;
     }
 
+    reportar_fases(MPI_COMM_WORLD);
+    reportar_contadores(MPI_COMM_WORLD);
     MPI_Finalize();
     return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -2,22 +2,25 @@
 #include <iostream>
 #include <cmath>
 #include <vector>
+#include "temporizador_fases.h"
 
-int main(int argc, char* argv[]) {
-    int numero_procesos, mi_rango;
-    MPI_Init(&argc, &argv);
-    MPI_Comm_size(MPI_COMM_WORLD, &numero_procesos);
-    MPI_Comm_rank(MPI_COMM_WORLD, &mi_rango);
+// Suma en árbol de los vectores suma_parcial de todos los procesos, elemento
+// a elemento (el programa usa un valor por proceso). El resultado queda en
+// suma_parcial del proceso 0; valor_recibido es el buffer de recepción, del
+// mismo tamaño, para poder reutilizarlo entre ejecuciones
+void suma_en_arbol(std::vector<double>& suma_parcial, std::vector<double>& valor_recibido,
+                   int mi_rango, int numero_procesos, bool mostrar) {
+    int cantidad = suma_parcial.size();
+    valor_recibido.resize(cantidad);
 
-    double mi_valor = mi_rango + 1;  // Cada proceso tiene un valor (1, 2, 3, ...)
-    double suma_parcial = mi_valor;
-    double suma_total;
-
-    std::cout << "Proceso " << mi_rango << " tiene valor inicial: " << mi_valor << std::endl;
+    // Toda la suma es la fase de reducción: las sumas locales van intercaladas con los mensajes
+    TemporizadorFase temporizador(FASE_REDUCCION);
 
     // Implementación para número de procesos que es potencia de 2
     if ((numero_procesos & (numero_procesos - 1)) == 0) {
-        std::cout << "Usando algoritmo para potencia de 2 (" << numero_procesos << " procesos)" << std::endl;
+        if (mostrar) {
+            std::cout << "Usando algoritmo para potencia de 2 (" << numero_procesos << " procesos)" << std::endl;
+        }
 
         // Suma con estructura de árbol (potencia de 2)
         for (int paso = 1; paso < numero_procesos; paso *= 2) {
@@ -25,61 +28,90 @@ int main(int argc, char* argv[]) {
                 // Proceso receptor
                 int proceso_fuente = mi_rango + paso;
                 if (proceso_fuente < numero_procesos) {
-                    double valor_recibido;
-                    MPI_Recv(&valor_recibido, 1, MPI_DOUBLE, proceso_fuente, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-                    suma_parcial += valor_recibido;
-                    std::cout << "Proceso " << mi_rango << " recibió " << valor_recibido
-                              << " del proceso " << proceso_fuente
-                              << ", suma parcial: " << suma_parcial << std::endl;
+                    MPI_Recv(valor_recibido.data(), cantidad, MPI_DOUBLE, proceso_fuente, 0, MPI_COMM_WORLD,
+                             MPI_STATUS_IGNORE);
+                    for (int i = 0; i < cantidad; i++) suma_parcial[i] += valor_recibido[i];
+                    if (mostrar) {
+                        std::cout << "Proceso " << mi_rango << " recibió " << valor_recibido[0]
+                                  << " del proceso " << proceso_fuente
+                                  << ", suma parcial: " << suma_parcial[0] << std::endl;
+                    }
                 }
             } else {
                 // Proceso emisor
                 int proceso_destino = mi_rango - paso;
                 if (proceso_destino >= 0 && (mi_rango % (2 * paso)) == paso) {
-                    MPI_Send(&suma_parcial, 1, MPI_DOUBLE, proceso_destino, 0, MPI_COMM_WORLD);
-                    std::cout << "Proceso " << mi_rango << " envió " << suma_parcial
-                              << " al proceso " << proceso_destino << std::endl;
+                    MPI_Send(suma_parcial.data(), cantidad, MPI_DOUBLE, proceso_destino, 0, MPI_COMM_WORLD);
+                    if (mostrar) {
+                        std::cout << "Proceso " << mi_rango << " envió " << suma_parcial[0]
+                                  << " al proceso " << proceso_destino << std::endl;
+                    }
                     break;  // Este proceso ya terminó su trabajo
                 }
             }
         }
     } else {
         // Implementación para cualquier número de procesos
-        std::cout << "Usando algoritmo general (" << numero_procesos << " procesos)" << std::endl;
+        if (mostrar) {
+            std::cout << "Usando algoritmo general (" << numero_procesos << " procesos)" << std::endl;
+        }
 
         int procesos_activos = numero_procesos;
         int mi_rango_virtual = mi_rango;
 
         while (procesos_activos > 1) {
+            // Con procesos_activos impar el proceso del medio no participa en este paso
             int mitad = procesos_activos / 2;
+            int resto = procesos_activos - mitad;
 
             if (mi_rango_virtual < mitad) {
                 // Proceso receptor en la mitad inferior
-                int proceso_fuente = mi_rango_virtual + mitad;
+                int proceso_fuente = mi_rango_virtual + resto;
                 if (proceso_fuente < procesos_activos) {
-                    double valor_recibido;
-                    MPI_Recv(&valor_recibido, 1, MPI_DOUBLE, proceso_fuente, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-                    suma_parcial += valor_recibido;
-                    std::cout << "Proceso " << mi_rango << " recibió " << valor_recibido
-                              << " del proceso " << proceso_fuente
-                              << ", suma parcial: " << suma_parcial << std::endl;
+                    MPI_Recv(valor_recibido.data(), cantidad, MPI_DOUBLE, proceso_fuente, 0, MPI_COMM_WORLD,
+                             MPI_STATUS_IGNORE);
+                    for (int i = 0; i < cantidad; i++) suma_parcial[i] += valor_recibido[i];
+                    if (mostrar) {
+                        std::cout << "Proceso " << mi_rango << " recibió " << valor_recibido[0]
+                                  << " del proceso " << proceso_fuente
+                                  << ", suma parcial: " << suma_parcial[0] << std::endl;
+                    }
                 }
-            } else if (mi_rango_virtual < procesos_activos) {
+            } else if (mi_rango_virtual >= resto && mi_rango_virtual < procesos_activos) {
                 // Proceso emisor en la mitad superior
-                int proceso_destino = mi_rango_virtual - mitad;
-                MPI_Send(&suma_parcial, 1, MPI_DOUBLE, proceso_destino, 0, MPI_COMM_WORLD);
-                std::cout << "Proceso " << mi_rango << " envió " << suma_parcial
-                          << " al proceso " << proceso_destino << std::endl;
+                int proceso_destino = mi_rango_virtual - resto;
+                MPI_Send(suma_parcial.data(), cantidad, MPI_DOUBLE, proceso_destino, 0, MPI_COMM_WORLD);
+                if (mostrar) {
+                    std::cout << "Proceso " << mi_rango << " envió " << suma_parcial[0]
+                              << " al proceso " << proceso_destino << std::endl;
+                }
                 break;  // Este proceso ya terminó su trabajo
             }
 
-            procesos_activos = mitad + (procesos_activos % 2);
+            procesos_activos = resto;
         }
     }
+}
+
+#ifndef NUCLEOS_SIN_MAIN
+int main(int argc, char* argv[]) {
+    int numero_procesos, mi_rango;
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(MPI_COMM_WORLD, &numero_procesos);
+    MPI_Comm_rank(MPI_COMM_WORLD, &mi_rango);
+
+    double mi_valor = mi_rango + 1;  // Cada proceso tiene un valor (1, 2, 3, ...)
+    std::vector<double> suma_parcial(1, mi_valor), valor_recibido;
+    double suma_total;
+
+    std::cout << "Proceso " << mi_rango << " tiene valor inicial: " << mi_valor << std::endl;
+
+    suma_en_arbol(suma_parcial, valor_recibido, mi_rango, numero_procesos, true);
 
     // El proceso 0 tiene la suma final
     if (mi_rango == 0) {
-        suma_total = suma_parcial;
+        TemporizadorFase temporizador(FASE_SALIDA);
+        suma_total = suma_parcial[0];
         std::cout << "\n=== RESULTADO FINAL ===" << std::endl;
         std::cout << "Suma total usando estructura de árbol: " << suma_total << std::endl;
 
@@ -94,6 +126,8 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    reportar_fases(MPI_COMM_WORLD);
     MPI_Finalize();
     return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -1,21 +1,26 @@
 #include <mpi.h>
 #include <iostream>
 #include <cmath>
+#include <vector>
+#include "temporizador_fases.h"
 
-int main(int argc, char* argv[]) {
-    int numero_procesos, mi_rango;
-    MPI_Init(&argc, &argv);
-    MPI_Comm_size(MPI_COMM_WORLD, &numero_procesos);
-    MPI_Comm_rank(MPI_COMM_WORLD, &mi_rango);
-
-    double mi_valor = mi_rango + 1;  // Cada proceso tiene un valor (1, 2, 3, ...)
-    double suma_parcial = mi_valor;
+// Suma tipo mariposa de los vectores suma_parcial de todos los procesos,
+// elemento a elemento (el programa usa un valor por proceso). Al terminar
+// todos los procesos tienen el resultado en suma_parcial; valor_recibido es
+// el buffer de intercambio, para poder reutilizarlo entre ejecuciones
+void suma_mariposa(std::vector<double>& suma_parcial, std::vector<double>& valor_recibido,
+                   int mi_rango, int numero_procesos, bool mostrar) {
+    int cantidad = suma_parcial.size();
+    valor_recibido.resize(cantidad);
 
-    std::cout << "Proceso " << mi_rango << " tiene valor inicial: " << mi_valor << std::endl;
+    // Toda la suma es la fase de reducción: las sumas locales van intercaladas con los mensajes
+    TemporizadorFase temporizador(FASE_REDUCCION);
 
     // Implementación tipo mariposa para potencia de 2
     if ((numero_procesos & (numero_procesos - 1)) == 0) {
-        std::cout << "Usando algoritmo mariposa para potencia de 2 (" << numero_procesos << " procesos)" << std::endl;
+        if (mostrar) {
+            std::cout << "Usando algoritmo mariposa para potencia de 2 (" << numero_procesos << " procesos)" << std::endl;
+        }
 
         // Algoritmo tipo mariposa (butterfly)
         for (int paso = 1; paso < numero_procesos; paso *= 2) {
@@ -23,25 +28,27 @@ int main(int argc, char* argv[]) {
             int socio = mi_rango ^ paso;  // XOR para encontrar el socio
 
             if (socio < numero_procesos) {
-                double valor_recibido;
-
                 // Intercambio simultáneo con el socio
-                MPI_Sendrecv(&suma_parcial, 1, MPI_DOUBLE, socio, 0,
-                            &valor_recibido, 1, MPI_DOUBLE, socio, 0,
+                MPI_Sendrecv(suma_parcial.data(), cantidad, MPI_DOUBLE, socio, 0,
+                            valor_recibido.data(), cantidad, MPI_DOUBLE, socio, 0,
                             MPI_COMM_WORLD, MPI_STATUS_IGNORE);
 
                 // Sumar el valor recibido
-                suma_parcial += valor_recibido;
-
-                std::cout << "Paso " << (int)log2(paso) + 1 << ": Proceso " << mi_rango
-                          << " intercambió con proceso " << socio
-                          << ", recibió " << valor_recibido
-                          << ", nueva suma: " << suma_parcial << std::endl;
+                for (int i = 0; i < cantidad; i++) suma_parcial[i] += valor_recibido[i];
+
+                if (mostrar) {
+                    std::cout << "Paso " << (int)log2(paso) + 1 << ": Proceso " << mi_rango
+                              << " intercambió con proceso " << socio
+                              << ", recibió " << valor_recibido[0]
+                              << ", nueva suma: " << suma_parcial[0] << std::endl;
+                }
             }
         }
     } else {
         // Implementación para cualquier número de procesos
-        std::cout << "Usando algoritmo mariposa generalizado (" << numero_procesos << " procesos)" << std::endl;
+        if (mostrar) {
+            std::cout << "Usando algoritmo mariposa generalizado (" << numero_procesos << " procesos)" << std::endl;
+        }
 
         // Encontrar la potencia de 2 más cercana y mayor
         int potencia_2 = 1;
@@ -54,36 +61,55 @@ int main(int argc, char* argv[]) {
 
             // Solo realizar intercambio si ambos procesos existen
             if (socio < numero_procesos) {
-                double valor_recibido;
-
-                MPI_Sendrecv(&suma_parcial, 1, MPI_DOUBLE, socio, 0,
-                            &valor_recibido, 1, MPI_DOUBLE, socio, 0,
+                MPI_Sendrecv(suma_parcial.data(), cantidad, MPI_DOUBLE, socio, 0,
+                            valor_recibido.data(), cantidad, MPI_DOUBLE, socio, 0,
                             MPI_COMM_WORLD, MPI_STATUS_IGNORE);
 
-                suma_parcial += valor_recibido;
+                for (int i = 0; i < cantidad; i++) suma_parcial[i] += valor_recibido[i];
 
-                std::cout << "Paso " << (int)log2(paso) + 1 << ": Proceso " << mi_rango
-                          << " intercambió con proceso " << socio
-                          << ", recibió " << valor_recibido
-                          << ", nueva suma: " << suma_parcial << std::endl;
-            } else {
+                if (mostrar) {
+                    std::cout << "Paso " << (int)log2(paso) + 1 << ": Proceso " << mi_rango
+                              << " intercambió con proceso " << socio
+                              << ", recibió " << valor_recibido[0]
+                              << ", nueva suma: " << suma_parcial[0] << std::endl;
+                }
+            } else if (mostrar) {
                 std::cout << "Paso " << (int)log2(paso) + 1 << ": Proceso " << mi_rango
                           << " no tiene socio válido (sería " << socio << ")" << std::endl;
             }
         }
     }
+}
+
+#ifndef NUCLEOS_SIN_MAIN
+int main(int argc, char* argv[]) {
+    int numero_procesos, mi_rango;
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(MPI_COMM_WORLD, &numero_procesos);
+    MPI_Comm_rank(MPI_COMM_WORLD, &mi_rango);
+
+    double mi_valor = mi_rango + 1;  // Cada proceso tiene un valor (1, 2, 3, ...)
+    std::vector<double> suma_parcial(1, mi_valor), valor_recibido;
+
+    std::cout << "Proceso " << mi_rango << " tiene valor inicial: " << mi_valor << std::endl;
+
+    suma_mariposa(suma_parcial, valor_recibido, mi_rango, numero_procesos, true);
 
     // Todos los procesos tienen la suma final en el algoritmo mariposa
-    std::cout << "\n=== RESULTADO EN PROCESO " << mi_rango << " ===" << std::endl;
-    std::cout << "Suma total usando algoritmo mariposa: " << suma_parcial << std::endl;
+    {
+        TemporizadorFase temporizador(FASE_SALIDA);
+        std::cout << "\n=== RESULTADO EN PROCESO " << mi_rango << " ===" << std::endl;
+        std::cout << "Suma total usando algoritmo mariposa: " << suma_parcial[0] << std::endl;
+    }
 
     // Verificar resultado solo en proceso 0
     if (mi_rango == 0) {
+        TemporizadorFase temporizador(FASE_SALIDA);
         double suma_esperada = numero_procesos * (numero_procesos + 1) / 2.0;
         std::cout << "\n=== VERIFICACIÓN ===" << std::endl;
         std::cout << "Suma esperada (1+2+...+" << numero_procesos << "): " << suma_esperada << std::endl;
 
-        if (std::abs(suma_parcial - suma_esperada) < 1e-10) {
+        if (std::abs(suma_parcial[0] - suma_esperada) < 1e-10) {
             std::cout << "✓ Resultado correcto!" << std::endl;
         } else {
             std::cout << "✗ Error en el cálculo!" << std::endl;
@@ -93,6 +119,8 @@ int main(int argc, char* argv[]) {
         std::cout << "      a diferencia del algoritmo de árbol donde solo el proceso 0 lo tiene." << std::endl;
     }
 
+    reportar_fases(MPI_COMM_WORLD);
     MPI_Finalize();
     return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -2,7 +2,120 @@
 #include <iostream>
 #include <vector>
 #include <iomanip>
+#include "temporizador_fases.h"
+#include "contadores_hardware.h"
+#include "memoria_nodo.h"
+#include "pool_buffers.h"
+
+// Llena la matriz de prueba A[i][j] = i + j + 1 (por filas) y el vector x[i] = i + 1
+void generar_matriz_vector_columnas(int n, std::vector<double>& matriz_completa, std::vector<double>& vector_completo) {
+    matriz_completa.resize(n * n);
+    vector_completo.resize(n);
+
+    // Llenar la matriz (por filas)
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            matriz_completa[i * n + j] = i + j + 1;  // Valores simples para verificación
+        }
+    }
+
+    // Llenar el vector
+    for (int i = 0; i < n; i++) {
+        vector_completo[i] = i + 1;
+    }
+}
+
+// y = A * x con la matriz repartida por bloques de columnas: el proceso 0
+// envía a cada proceso sus columnas y difunde x, cada proceso calcula su
+// contribución a todo el vector y, y MPI_Reduce la suma en el proceso 0. n
+// debe ser múltiplo del número de procesos. Con MEMORIA_NODO=1, x se guarda
+// una vez por nodo en copia_nodo en lugar de en cada proceso. Los buffers
+// los pasa quien llama para poder reutilizarlos entre ejecuciones
+void multiplicar_por_columnas(int n, const std::vector<double>& matriz_completa, std::vector<double>& vector_completo,
+                              std::vector<double>& resultado_completo, std::vector<double>& bloque_columnas,
+                              std::vector<double>& mi_resultado_parcial, VentanaNodo& copia_nodo, int mi_rango,
+                              int numero_procesos, bool mostrar) {
+    // Calcular cuántas columnas maneja cada proceso
+    int columnas_por_proceso = n / numero_procesos;
+
+    // Preparar buffer para el bloque de columnas de cada proceso
+    bloque_columnas.resize(n * columnas_por_proceso);
+
+    // El proceso 0 distribuye los bloques de columnas y difunde el vector
+    const double* x;
+    {
+        TemporizadorFase temporizador(FASE_DISTRIBUCION);
+        if (mi_rango == 0) {
+            // Copiar mi bloque (proceso 0)
+            for (int col = 0; col < columnas_por_proceso; col++) {
+                for (int fila = 0; fila < n; fila++) {
+                    bloque_columnas[col * n + fila] = matriz_completa[fila * n + col];
+                }
+            }
+
+            // Enviar bloques a otros procesos (el buffer temporal sale del
+            // pool: todos los envíos usan el mismo bloque)
+            for (int proceso = 1; proceso < numero_procesos; proceso++) {
+                BufferPool<double> bloque_temp(n * columnas_por_proceso);
+                int columna_inicio = proceso * columnas_por_proceso;
+
+                for (int col = 0; col < columnas_por_proceso; col++) {
+                    for (int fila = 0; fila < n; fila++) {
+                        bloque_temp[col * n + fila] = matriz_completa[fila * n + (columna_inicio + col)];
+                    }
+                }
+
+                MPI_Send(bloque_temp.data(), n * columnas_por_proceso, MPI_DOUBLE,
+                         proceso, 0, MPI_COMM_WORLD);
+            }
+        } else {
+            // Otros procesos reciben su bloque de columnas
+            MPI_Recv(bloque_columnas.data(), n * columnas_por_proceso, MPI_DOUBLE,
+                     0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        }
+
+        // Distribuir el vector completo a todos los procesos (o a una copia por nodo)
+        if (memoria_nodo_activa()) {
+            x = difundir_en_nodo(copia_nodo, vector_completo.data(), n, MPI_DOUBLE);
+        } else {
+            vector_completo.resize(n);
+            MPI_Bcast(vector_completo.data(), n, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+            x = vector_completo.data();
+        }
+    }
 
+    // Cada proceso calcula su contribución al resultado
+    mi_resultado_parcial.assign(n, 0.0);
+
+    {
+        TemporizadorFase temporizador(FASE_CALCULO);
+        // Elementos: productos; bytes: el bloque de columnas, su parte de x y el resultado parcial
+        double productos = (double)n * columnas_por_proceso;
+        MedicionHardware medicion("gemv_columnas", productos,
+                                  (productos + columnas_por_proceso + n) * sizeof(double));
+        for (int fila = 0; fila < n; fila++) {
+            for (int col = 0; col < columnas_por_proceso; col++) {
+                int columna_global = mi_rango * columnas_por_proceso + col;
+                mi_resultado_parcial[fila] += bloque_columnas[col * n + fila] * x[columna_global];
+            }
+        }
+    }
+
+    if (mostrar) {
+        std::cout << "Proceso " << mi_rango << " completó su cálculo parcial" << std::endl;
+    }
+
+    // Reducir resultados parciales al resultado final
+    if (mi_rango == 0) {
+        resultado_completo.resize(n);
+    }
+
+    TemporizadorFase temporizador(FASE_REDUCCION);
+    MPI_Reduce(mi_resultado_parcial.data(), resultado_completo.data(), n, MPI_DOUBLE,
+               MPI_SUM, 0, MPI_COMM_WORLD);
+}
+
+#ifndef NUCLEOS_SIN_MAIN
 int main(int argc, char* argv[]) {
     int numero_procesos, mi_rango;
     MPI_Init(&argc, &argv);
@@ -12,6 +125,7 @@ int main(int argc, char* argv[]) {
     int n;  // Orden de la matriz (n x n)
     std::vector<double> matriz_completa, vector_completo, resultado_completo;
     std::vector<double> bloque_columnas, mi_resultado_parcial;
+    VentanaNodo copia_nodo;
 
     // El proceso 0 lee la dimensión y genera/lee la matriz y vector
     if (mi_rango == 0) {
@@ -27,22 +141,10 @@ int main(int argc, char* argv[]) {
         }
 
         // Inicializar matriz y vector con valores de ejemplo
-        matriz_completa.resize(n * n);
-        vector_completo.resize(n);
-        resultado_completo.resize(n);
-
         std::cout << "Generando matriz y vector de prueba..." << std::endl;
-
-        // Llenar la matriz (por filas)
-        for (int i = 0; i < n; i++) {
-            for (int j = 0; j < n; j++) {
-                matriz_completa[i * n + j] = i + j + 1;  // Valores simples para verificación
-            }
-        }
-
-        // Llenar el vector
-        for (int i = 0; i < n; i++) {
-            vector_completo[i] = i + 1;
+        {
+            TemporizadorFase temporizador(FASE_ENTRADA);
+            generar_matriz_vector_columnas(n, matriz_completa, vector_completo);
         }
 
         // Mostrar datos si n es pequeño
@@ -66,67 +168,15 @@ int main(int argc, char* argv[]) {
     // Distribuir n a todos los procesos
     MPI_Bcast(&n, 1, MPI_INT, 0, MPI_COMM_WORLD);
 
-    // Calcular cuántas columnas maneja cada proceso
-    int columnas_por_proceso = n / numero_procesos;
-
-    // Preparar buffer para el bloque de columnas de cada proceso
-    bloque_columnas.resize(n * columnas_por_proceso);
-
-    // El proceso 0 distribuye los bloques de columnas
-    if (mi_rango == 0) {
-        // Copiar mi bloque (proceso 0)
-        for (int col = 0; col < columnas_por_proceso; col++) {
-            for (int fila = 0; fila < n; fila++) {
-                bloque_columnas[col * n + fila] = matriz_completa[fila * n + col];
-            }
-        }
-
-        // Enviar bloques a otros procesos
-        for (int proceso = 1; proceso < numero_procesos; proceso++) {
-            std::vector<double> bloque_temp(n * columnas_por_proceso);
-            int columna_inicio = proceso * columnas_por_proceso;
-
-            for (int col = 0; col < columnas_por_proceso; col++) {
-                for (int fila = 0; fila < n; fila++) {
-                    bloque_temp[col * n + fila] = matriz_completa[fila * n + (columna_inicio + col)];
-                }
-            }
-
-            MPI_Send(bloque_temp.data(), n * columnas_por_proceso, MPI_DOUBLE,
-                     proceso, 0, MPI_COMM_WORLD);
-        }
-    } else {
-        // Otros procesos reciben su bloque de columnas
-        MPI_Recv(bloque_columnas.data(), n * columnas_por_proceso, MPI_DOUBLE,
-                 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-    }
-
-    // Distribuir el vector completo a todos los procesos
-    vector_completo.resize(n);
-    MPI_Bcast(vector_completo.data(), n, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-
-    // Cada proceso calcula su contribución al resultado
-    mi_resultado_parcial.resize(n, 0.0);
-
-    for (int fila = 0; fila < n; fila++) {
-        for (int col = 0; col < columnas_por_proceso; col++) {
-            int columna_global = mi_rango * columnas_por_proceso + col;
-            mi_resultado_parcial[fila] += bloque_columnas[col * n + fila] * vector_completo[columna_global];
-        }
-    }
-
-    std::cout << "Proceso " << mi_rango << " completó su cálculo parcial" << std::endl;
-
-    // Reducir resultados parciales al resultado final
-    if (mi_rango == 0) {
-        resultado_completo.resize(n);
-    }
-
-    MPI_Reduce(mi_resultado_parcial.data(), resultado_completo.data(), n, MPI_DOUBLE,
-               MPI_SUM, 0, MPI_COMM_WORLD);
+    // Distribución por columnas, cálculo local y reducción en el proceso 0
+    multiplicar_por_columnas(n, matriz_completa, vector_completo, resultado_completo, bloque_columnas,
+                             mi_resultado_parcial, copia_nodo, mi_rango, numero_procesos, true);
+    copia_nodo.liberar();
+    informar_memoria_nodo();
 
     // El proceso 0 muestra el resultado
     if (mi_rango == 0) {
+        TemporizadorFase temporizador(FASE_SALIDA);
         std::cout << "\n=== RESULTADO ===" << std::endl;
         std::cout << "Resultado de A * x:" << std::endl;
 
@@ -144,6 +194,11 @@ int main(int argc, char* argv[]) {
                   << " procesos con distribución por columnas." << std::endl;
     }
 
+    reportar_fases(MPI_COMM_WORLD);
+    reportar_contadores(MPI_COMM_WORLD);
+    reportar_pool(MPI_COMM_WORLD);
+    pool_buffers().vaciar();
     MPI_Finalize();
     return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -3,7 +3,219 @@
 #include <vector>
 #include <cmath>
 #include <iomanip>
+#include <cstdlib>
+#include "temporizador_fases.h"
+#include "contadores_hardware.h"
+#include "memoria_nodo.h"
+#include "pool_buffers.h"
+
+// Llena la matriz de prueba A[i][j] = (i + 1) * 10 + (j + 1) y el vector x[i] = i + 1
+void generar_matriz_vector_submatrices(int n, std::vector<double>& matriz_completa, std::vector<double>& vector_completo) {
+    matriz_completa.resize(n * n);
+    vector_completo.resize(n);
+
+    // Llenar matriz
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            matriz_completa[i * n + j] = (i + 1) * 10 + (j + 1);
+        }
+    }
+
+    // Llenar vector
+    for (int i = 0; i < n; i++) {
+        vector_completo[i] = i + 1;
+    }
+}
+
+// Instantes del cálculo por paneles en este proceso (MPI_Wtime)
+struct LineaTiempoPaneles {
+    std::vector<double> inicio_panel, envio_panel, fin_reduccion;
+    double inicio_calculo, fin_calculo, fin_reducciones;
+    int paneles_ocultos;  // reducciones terminadas antes de acabar el cálculo
+};
+
+// y = A * x con la matriz repartida en submatrices sobre una grilla de
+// sqrt_procesos x sqrt_procesos: el proceso 0 envía las submatrices y difunde
+// x, cada proceso multiplica por paneles de filas reduciendo cada panel en su
+// fila de procesos con MPI_Ireduce, y la columna 0 junta el resultado en el
+// proceso 0. n debe ser múltiplo de sqrt_procesos. Con MEMORIA_NODO=1, x se
+// guarda una vez por nodo en copia_nodo en lugar de en cada proceso. Los
+// buffers los pasa quien llama para poder reutilizarlos entre ejecuciones
+void multiplicar_por_submatrices(int n, int numero_paneles, const std::vector<double>& matriz_completa,
+                                 std::vector<double>& vector_completo, std::vector<double>& resultado_completo,
+                                 std::vector<double>& submatriz, std::vector<double>& subvector,
+                                 std::vector<double>& subresultado, std::vector<double>& resultado_fila,
+                                 VentanaNodo& copia_nodo, MPI_Comm comunicador_fila, int mi_rango, int sqrt_procesos,
+                                 LineaTiempoPaneles& linea, bool mostrar) {
+    int numero_procesos = sqrt_procesos * sqrt_procesos;
+    int fila_proceso = mi_rango / sqrt_procesos;
+    int col_proceso = mi_rango % sqrt_procesos;
 
+    // Calcular dimensiones de cada submatriz
+    int filas_por_proceso = n / sqrt_procesos;
+    int cols_por_proceso = n / sqrt_procesos;
+
+    // Preparar buffers para submatriz y subvector
+    submatriz.resize(filas_por_proceso * cols_por_proceso);
+    subvector.resize(cols_por_proceso);
+    subresultado.assign(filas_por_proceso, 0.0);
+
+    // El proceso 0 distribuye las submatrices y difunde el vector
+    const double* x;
+    {
+        TemporizadorFase temporizador(FASE_DISTRIBUCION);
+        if (mi_rango == 0) {
+            // Distribuir mi propia submatriz (proceso 0)
+            int mi_fila_inicio = 0;
+            int mi_col_inicio = 0;
+            for (int i = 0; i < filas_por_proceso; i++) {
+                for (int j = 0; j < cols_por_proceso; j++) {
+                    submatriz[i * cols_por_proceso + j] =
+                        matriz_completa[(mi_fila_inicio + i) * n + (mi_col_inicio + j)];
+                }
+            }
+
+            // Enviar submatrices a otros procesos (el buffer temporal sale del
+            // pool: todos los envíos usan el mismo bloque)
+            for (int proceso = 1; proceso < numero_procesos; proceso++) {
+                int proc_fila = proceso / sqrt_procesos;
+                int proc_col = proceso % sqrt_procesos;
+                int fila_inicio = proc_fila * filas_por_proceso;
+                int col_inicio = proc_col * cols_por_proceso;
+
+                BufferPool<double> submatriz_temp(filas_por_proceso * cols_por_proceso);
+                for (int i = 0; i < filas_por_proceso; i++) {
+                    for (int j = 0; j < cols_por_proceso; j++) {
+                        submatriz_temp[i * cols_por_proceso + j] =
+                            matriz_completa[(fila_inicio + i) * n + (col_inicio + j)];
+                    }
+                }
+
+                MPI_Send(submatriz_temp.data(), filas_por_proceso * cols_por_proceso,
+                         MPI_DOUBLE, proceso, 0, MPI_COMM_WORLD);
+            }
+        } else {
+            // Otros procesos reciben su submatriz
+            MPI_Recv(submatriz.data(), filas_por_proceso * cols_por_proceso,
+                     MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        }
+
+        // Distribuir el vector completo a todos los procesos (o a una copia por nodo)
+        if (memoria_nodo_activa()) {
+            x = difundir_en_nodo(copia_nodo, vector_completo.data(), n, MPI_DOUBLE);
+        } else {
+            vector_completo.resize(n);
+            MPI_Bcast(vector_completo.data(), n, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+            x = vector_completo.data();
+        }
+    }
+
+    // Cada proceso extrae su parte del vector
+    int col_inicio = col_proceso * cols_por_proceso;
+    for (int i = 0; i < cols_por_proceso; i++) {
+        subvector[i] = x[col_inicio + i];
+    }
+
+    // Reducir resultados por filas (cada fila de procesos suma sus contribuciones)
+    resultado_fila.assign(filas_por_proceso, 0.0);
+
+    // Dividir la submatriz en paneles de filas: cada panel se reduce con
+    // MPI_Ireduce apenas termina, mientras se calcula el siguiente
+    if (numero_paneles > filas_por_proceso) numero_paneles = filas_por_proceso;
+    if (numero_paneles < 1) numero_paneles = 1;
+
+    std::vector<MPI_Request> solicitudes(numero_paneles, MPI_REQUEST_NULL);
+    linea.inicio_panel.assign(numero_paneles, 0.0);
+    linea.envio_panel.assign(numero_paneles, 0.0);
+    linea.fin_reduccion.assign(numero_paneles, 0.0);
+    int primer_panel_pendiente = 0;
+
+    TemporizadorFase temporizador_calculo(FASE_CALCULO);
+    linea.inicio_calculo = MPI_Wtime();
+
+    for (int panel = 0; panel < numero_paneles; panel++) {
+        int fila_inicio_panel = panel * filas_por_proceso / numero_paneles;
+        int fila_fin_panel = (panel + 1) * filas_por_proceso / numero_paneles;
+
+        linea.inicio_panel[panel] = MPI_Wtime();
+
+        // Realizar multiplicación local del panel: submatriz * subvector
+        {
+            double productos = (double)(fila_fin_panel - fila_inicio_panel) * cols_por_proceso;
+            MedicionHardware medicion("gemv_submatrices", productos,
+                                      (productos + cols_por_proceso + fila_fin_panel - fila_inicio_panel) *
+                                          sizeof(double));
+            for (int i = fila_inicio_panel; i < fila_fin_panel; i++) {
+                for (int j = 0; j < cols_por_proceso; j++) {
+                    subresultado[i] += submatriz[i * cols_por_proceso + j] * subvector[j];
+                }
+            }
+        }
+
+        // Sumar contribuciones del panel dentro de cada fila sin bloquear
+        linea.envio_panel[panel] = MPI_Wtime();
+        MPI_Ireduce(subresultado.data() + fila_inicio_panel, resultado_fila.data() + fila_inicio_panel,
+                    fila_fin_panel - fila_inicio_panel, MPI_DOUBLE, MPI_SUM, 0,
+                    comunicador_fila, &solicitudes[panel]);
+
+        // Dar progreso a las reducciones pendientes y registrar cuáles terminaron
+        while (primer_panel_pendiente < panel) {
+            int terminada = 0;
+            MPI_Test(&solicitudes[primer_panel_pendiente], &terminada, MPI_STATUS_IGNORE);
+            if (!terminada) break;
+            linea.fin_reduccion[primer_panel_pendiente] = MPI_Wtime();
+            primer_panel_pendiente++;
+        }
+    }
+
+    linea.fin_calculo = MPI_Wtime();
+    temporizador_calculo.detener();
+
+    // Esperar las reducciones que no alcanzaron a ocultarse tras el cálculo,
+    // y recolectar el resultado en el proceso 0
+    TemporizadorFase temporizador(FASE_REDUCCION);
+    for (int panel = primer_panel_pendiente; panel < numero_paneles; panel++) {
+        MPI_Wait(&solicitudes[panel], MPI_STATUS_IGNORE);
+        linea.fin_reduccion[panel] = MPI_Wtime();
+    }
+
+    linea.fin_reducciones = MPI_Wtime();
+    linea.paneles_ocultos = primer_panel_pendiente;
+
+    if (mostrar) {
+        std::cout << "Proceso " << mi_rango << " (posición [" << fila_proceso
+                  << "," << col_proceso << "]) completó cálculo local" << std::endl;
+    }
+
+    // Los procesos en la columna 0 recolectan el resultado final
+    if (col_proceso == 0) {
+        if (mi_rango == 0) {
+            resultado_completo.resize(n);
+            // Copiar mi parte
+            for (int i = 0; i < filas_por_proceso; i++) {
+                resultado_completo[i] = resultado_fila[i];
+            }
+
+            // Recibir de otros procesos en la columna 0
+            for (int fila = 1; fila < sqrt_procesos; fila++) {
+                int proceso_fuente = fila * sqrt_procesos;  // Procesos (1,0), (2,0), etc.
+                BufferPool<double> parte_resultado(filas_por_proceso);
+                MPI_Recv(parte_resultado.data(), filas_por_proceso, MPI_DOUBLE,
+                         proceso_fuente, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+                for (int i = 0; i < filas_por_proceso; i++) {
+                    resultado_completo[fila * filas_por_proceso + i] = parte_resultado[i];
+                }
+            }
+        } else {
+            // Otros procesos en columna 0 envían sus resultados al proceso 0
+            MPI_Send(resultado_fila.data(), filas_por_proceso, MPI_DOUBLE,
+                     0, 1, MPI_COMM_WORLD);
+        }
+    }
+}
+
+#ifndef NUCLEOS_SIN_MAIN
 int main(int argc, char* argv[]) {
     int numero_procesos, mi_rango;
     MPI_Init(&argc, &argv);
@@ -22,8 +234,10 @@ int main(int argc, char* argv[]) {
     }
 
     int n;  // Orden de la matriz
+    int numero_paneles = 4;  // Paneles de filas para solapar cálculo y reducción
     std::vector<double> matriz_completa, vector_completo, resultado_completo;
     std::vector<double> submatriz, subvector, subresultado;
+    VentanaNodo copia_nodo;
 
     // Calcular coordenadas del proceso en la grilla 2D
     int fila_proceso = mi_rango / sqrt_procesos;
@@ -36,6 +250,12 @@ int main(int argc, char* argv[]) {
         std::cout << "Ingrese el orden de la matriz (n): ";
         std::cin >> n;
 
+        // Número de paneles opcional como primer argumento del programa
+        if (argc > 1) {
+            numero_paneles = atoi(argv[1]);
+        }
+        std::cout << "Paneles de filas por submatriz: " << numero_paneles << std::endl;
+
         // Verificar que n es divisible por sqrt_procesos
         if (n % sqrt_procesos != 0) {
             std::cout << "Error: n (" << n << ") debe ser divisible por sqrt(procesos) ("
@@ -44,22 +264,10 @@ int main(int argc, char* argv[]) {
         }
 
         // Generar matriz y vector
-        matriz_completa.resize(n * n);
-        vector_completo.resize(n);
-        resultado_completo.resize(n);
-
         std::cout << "Generando matriz y vector de prueba..." << std::endl;
-
-        // Llenar matriz
-        for (int i = 0; i < n; i++) {
-            for (int j = 0; j < n; j++) {
-                matriz_completa[i * n + j] = (i + 1) * 10 + (j + 1);
-            }
-        }
-
-        // Llenar vector
-        for (int i = 0; i < n; i++) {
-            vector_completo[i] = i + 1;
+        {
+            TemporizadorFase temporizador(FASE_ENTRADA);
+            generar_matriz_vector_submatrices(n, matriz_completa, vector_completo);
         }
 
         // Mostrar datos si n es pequeño
@@ -82,112 +290,56 @@ int main(int argc, char* argv[]) {
 
     // Distribuir n a todos los procesos
     MPI_Bcast(&n, 1, MPI_INT, 0, MPI_COMM_WORLD);
-
-    // Calcular dimensiones de cada submatriz
-    int filas_por_proceso = n / sqrt_procesos;
-    int cols_por_proceso = n / sqrt_procesos;
-
-    // Preparar buffers para submatriz y subvector
-    submatriz.resize(filas_por_proceso * cols_por_proceso);
-    subvector.resize(cols_por_proceso);
-    subresultado.resize(filas_por_proceso, 0.0);
-
-    // El proceso 0 distribuye las submatrices
-    if (mi_rango == 0) {
-        // Distribuir mi propia submatriz (proceso 0)
-        int mi_fila_inicio = 0;
-        int mi_col_inicio = 0;
-        for (int i = 0; i < filas_por_proceso; i++) {
-            for (int j = 0; j < cols_por_proceso; j++) {
-                submatriz[i * cols_por_proceso + j] =
-                    matriz_completa[(mi_fila_inicio + i) * n + (mi_col_inicio + j)];
-            }
-        }
-
-        // Enviar submatrices a otros procesos
-        for (int proceso = 1; proceso < numero_procesos; proceso++) {
-            int proc_fila = proceso / sqrt_procesos;
-            int proc_col = proceso % sqrt_procesos;
-            int fila_inicio = proc_fila * filas_por_proceso;
-            int col_inicio = proc_col * cols_por_proceso;
-
-            std::vector<double> submatriz_temp(filas_por_proceso * cols_por_proceso);
-            for (int i = 0; i < filas_por_proceso; i++) {
-                for (int j = 0; j < cols_por_proceso; j++) {
-                    submatriz_temp[i * cols_por_proceso + j] =
-                        matriz_completa[(fila_inicio + i) * n + (col_inicio + j)];
-                }
-            }
-
-            MPI_Send(submatriz_temp.data(), filas_por_proceso * cols_por_proceso,
-                     MPI_DOUBLE, proceso, 0, MPI_COMM_WORLD);
-        }
-    } else {
-        // Otros procesos reciben su submatriz
-        MPI_Recv(submatriz.data(), filas_por_proceso * cols_por_proceso,
-                 MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-    }
-
-    // Distribuir partes del vector a procesos en la diagonal
-    vector_completo.resize(n);
-    MPI_Bcast(vector_completo.data(), n, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-
-    // Cada proceso extrae su parte del vector
-    int col_inicio = col_proceso * cols_por_proceso;
-    for (int i = 0; i < cols_por_proceso; i++) {
-        subvector[i] = vector_completo[col_inicio + i];
-    }
-
-    // Realizar multiplicación local: submatriz * subvector
-    for (int i = 0; i < filas_por_proceso; i++) {
-        for (int j = 0; j < cols_por_proceso; j++) {
-            subresultado[i] += submatriz[i * cols_por_proceso + j] * subvector[j];
-        }
-    }
-
-    std::cout << "Proceso " << mi_rango << " (posición [" << fila_proceso
-              << "," << col_proceso << "]) completó cálculo local" << std::endl;
-
-    // Reducir resultados por filas (cada fila de procesos suma sus contribuciones)
-    std::vector<double> resultado_fila(filas_por_proceso, 0.0);
+    MPI_Bcast(&numero_paneles, 1, MPI_INT, 0, MPI_COMM_WORLD);
 
     // Crear comunicador para cada fila de procesos
     MPI_Comm comunicador_fila;
     MPI_Comm_split(MPI_COMM_WORLD, fila_proceso, col_proceso, &comunicador_fila);
 
-    // Sumar contribuciones dentro de cada fila
-    MPI_Reduce(subresultado.data(), resultado_fila.data(), filas_por_proceso,
-               MPI_DOUBLE, MPI_SUM, 0, comunicador_fila);
-
-    // Los procesos en la columna 0 recolectan el resultado final
-    if (col_proceso == 0) {
-        if (mi_rango == 0) {
-            resultado_completo.resize(n);
-            // Copiar mi parte
-            for (int i = 0; i < filas_por_proceso; i++) {
-                resultado_completo[i] = resultado_fila[i];
-            }
-
-            // Recibir de otros procesos en la columna 0
-            for (int fila = 1; fila < sqrt_procesos; fila++) {
-                int proceso_fuente = fila * sqrt_procesos;  // Procesos (1,0), (2,0), etc.
-                std::vector<double> parte_resultado(filas_por_proceso);
-                MPI_Recv(parte_resultado.data(), filas_por_proceso, MPI_DOUBLE,
-                         proceso_fuente, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    // Distribución de submatrices, cálculo por paneles y recolección en el proceso 0
+    std::vector<double> resultado_fila;
+    LineaTiempoPaneles linea;
+    multiplicar_por_submatrices(n, numero_paneles, matriz_completa, vector_completo, resultado_completo, submatriz,
+                                subvector, subresultado, resultado_fila, copia_nodo, comunicador_fila, mi_rango,
+                                sqrt_procesos, linea, true);
+    copia_nodo.liberar();
+    informar_memoria_nodo();
+    numero_paneles = linea.inicio_panel.size();
+    int primer_panel_pendiente = linea.paneles_ocultos;
+
+    // Línea de tiempo del solapamiento: tiempos relativos al inicio del cálculo
+    double tiempo_espera = linea.fin_reducciones - linea.fin_calculo;
+    double tiempo_calculo = linea.fin_calculo - linea.inicio_calculo;
+    double tiempo_espera_max, tiempo_calculo_max;
+    MPI_Reduce(&tiempo_espera, &tiempo_espera_max, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&tiempo_calculo, &tiempo_calculo_max, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
 
-                for (int i = 0; i < filas_por_proceso; i++) {
-                    resultado_completo[fila * filas_por_proceso + i] = parte_resultado[i];
-                }
+    if (mi_rango == 0) {
+        TemporizadorFase temporizador(FASE_SALIDA);
+        std::cout << "\n=== LÍNEA DE TIEMPO (proceso 0, " << numero_paneles << " paneles) ===" << std::endl;
+        std::cout << std::fixed << std::setprecision(1);
+
+        if (numero_paneles <= 16) {
+            std::cout << "Panel\tCálculo [us]\t\tReducción [us]\t\tOculta" << std::endl;
+            for (int panel = 0; panel < numero_paneles; panel++) {
+                std::cout << panel << "\t"
+                          << (linea.inicio_panel[panel] - linea.inicio_calculo) * 1e6 << " - "
+                          << (linea.envio_panel[panel] - linea.inicio_calculo) * 1e6 << "\t\t"
+                          << (linea.envio_panel[panel] - linea.inicio_calculo) * 1e6 << " - "
+                          << (linea.fin_reduccion[panel] - linea.inicio_calculo) * 1e6 << "\t\t"
+                          << (panel < primer_panel_pendiente ? "sí" : "no") << std::endl;
             }
-        } else {
-            // Otros procesos en columna 0 envían sus resultados al proceso 0
-            MPI_Send(resultado_fila.data(), filas_por_proceso, MPI_DOUBLE,
-                     0, 1, MPI_COMM_WORLD);
         }
+
+        std::cout << "Reducciones ocultas tras el cálculo: " << primer_panel_pendiente
+                  << " de " << numero_paneles << std::endl;
+        std::cout << "Cálculo local (máx. entre procesos):  " << tiempo_calculo_max * 1e6 << " us" << std::endl;
+        std::cout << "Espera expuesta (máx. entre procesos): " << tiempo_espera_max * 1e6 << " us" << std::endl;
     }
 
     // El proceso 0 muestra el resultado
     if (mi_rango == 0) {
+        TemporizadorFase temporizador(FASE_SALIDA);
         std::cout << "\n=== RESULTADO ===" << std::endl;
         std::cout << "Resultado de A * x:" << std::endl;
 
@@ -206,6 +358,11 @@ int main(int argc, char* argv[]) {
     }
 
     MPI_Comm_free(&comunicador_fila);
+    reportar_fases(MPI_COMM_WORLD);
+    reportar_contadores(MPI_COMM_WORLD);
+    reportar_pool(MPI_COMM_WORLD);
+    pool_buffers().vaciar();
     MPI_Finalize();
     return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -3,21 +3,244 @@
 #include <ctime>
 #include <vector>
 #include <iomanip>
+#include <algorithm>
+#include <fstream>
+#include <cmath>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <atomic>
+#include "temporizador_fases.h"
 
-int main(int argc, char* argv[]) {
-    int numero_procesos, mi_rango;
-    MPI_Init(&argc, &argv);
-    MPI_Comm_size(MPI_COMM_WORLD, &numero_procesos);
-    MPI_Comm_rank(MPI_COMM_WORLD, &mi_rango);
+// Modos de ejecución del programa (primer argumento)
+const int MODO_CLOCK_VS_WTIME = 0;
+const int MODO_BARRIDO = 1;
+const int MODO_PRIMITIVAS = 2;
+const int MODO_PARES = 3;
+const int MODO_PARES_ALEATORIO = 4;
+const int MODO_MATRIZ = 5;
+const int MODO_SOLAPAMIENTO = 6;
 
-    if (numero_procesos < 2) {
-        if (mi_rango == 0) {
-            std::cout << "Este programa requiere al menos 2 procesos" << std::endl;
+// Estadísticas de una serie de tiempos de ida y vuelta
+struct EstadisticasTiempo {
+    double minimo;
+    double mediana;
+    double p99;
+    double maximo;
+};
+
+EstadisticasTiempo calcular_estadisticas(std::vector<double>& tiempos) {
+    std::sort(tiempos.begin(), tiempos.end());
+    int n = tiempos.size();
+
+    EstadisticasTiempo estadisticas;
+    estadisticas.minimo = tiempos[0];
+    estadisticas.mediana = (n % 2 == 1) ? tiempos[n / 2] : (tiempos[n / 2 - 1] + tiempos[n / 2]) / 2.0;
+    estadisticas.p99 = tiempos[std::max(0, (int)std::ceil(0.99 * n) - 1)];
+    estadisticas.maximo = tiempos[n - 1];
+    return estadisticas;
+}
+
+// Iteraciones para un tamaño: muchas para mensajes cortos, pocas para los largos,
+// de modo que cada tamaño mueva un volumen parecido de datos
+int iteraciones_para_tamano(int bytes) {
+    const int ITERACIONES_MAXIMAS = 10000;
+    const int ITERACIONES_MINIMAS = 20;
+    const double VOLUMEN_OBJETIVO = 256.0 * 1024 * 1024;
+
+    double iteraciones = VOLUMEN_OBJETIVO / std::max(bytes, 1);
+    if (iteraciones > ITERACIONES_MAXIMAS) return ITERACIONES_MAXIMAS;
+    if (iteraciones < ITERACIONES_MINIMAS) return ITERACIONES_MINIMAS;
+    return (int)iteraciones;
+}
+
+// Primitivas de transporte punto a punto comparadas en el modo "primitivas"
+enum Primitiva {
+    PRIMITIVA_SEND,        // MPI_Send / MPI_Recv
+    PRIMITIVA_SSEND,       // MPI_Ssend / MPI_Recv
+    PRIMITIVA_ISEND,       // MPI_Isend / MPI_Irecv + MPI_Wait
+    PRIMITIVA_PERSISTENTE, // MPI_Send_init / MPI_Recv_init + MPI_Start
+    PRIMITIVA_SENDRECV,    // MPI_Sendrecv (intercambio simultáneo)
+    PRIMITIVA_PUT_FENCE,   // MPI_Put + MPI_Win_fence
+    PRIMITIVA_GET_FENCE,   // MPI_Get + MPI_Win_fence
+    PRIMITIVA_PUT_LOCK,    // MPI_Put + MPI_Win_flush (objetivo pasivo)
+    PRIMITIVA_GET_LOCK,    // MPI_Get + MPI_Win_flush (objetivo pasivo)
+    NUMERO_PRIMITIVAS
+};
+
+const char* NOMBRES_PRIMITIVAS[NUMERO_PRIMITIVAS] = {
+    "send", "ssend", "isend", "persist", "sendrecv",
+    "put_fence", "get_fence", "put_lock", "get_lock"
+};
+
+// Mide una primitiva entre los procesos 0 y 1 y devuelve, en el proceso 0, el
+// tiempo por mensaje de un sentido de cada iteración (sin el calentamiento):
+//  - ping-pong de dos lados: ida y vuelta / 2
+//  - MPI_Sendrecv: duración de un intercambio simultáneo
+//  - un solo lado: Put/Get más la sincronización que garantiza que terminó
+// Las variantes de un solo lado usan la ventana creada sobre "buffer" en los
+// procesos 0 y 1; los demás procesos no participan
+std::vector<double> medir_primitiva(int primitiva, int mi_rango, std::vector<char>& buffer,
+                                    std::vector<char>& buffer_auxiliar, MPI_Win ventana,
+                                    int bytes, int iteraciones, int calentamiento) {
+    std::vector<double> tiempos;
+    if (mi_rango > 1) return tiempos;
+    if (mi_rango == 0) tiempos.reserve(iteraciones);
+
+    int socio = 1 - mi_rango;
+    MPI_Request solicitudes[2];
+
+    // Preparación propia de cada primitiva
+    if (primitiva == PRIMITIVA_PERSISTENTE) {
+        MPI_Recv_init(buffer_auxiliar.data(), bytes, MPI_BYTE, socio, 0, MPI_COMM_WORLD, &solicitudes[0]);
+        MPI_Send_init(buffer.data(), bytes, MPI_BYTE, socio, 0, MPI_COMM_WORLD, &solicitudes[1]);
+    } else if (primitiva == PRIMITIVA_PUT_FENCE || primitiva == PRIMITIVA_GET_FENCE) {
+        MPI_Win_fence(MPI_MODE_NOPRECEDE, ventana);
+    } else if (primitiva == PRIMITIVA_PUT_LOCK || primitiva == PRIMITIVA_GET_LOCK) {
+        if (mi_rango == 0) MPI_Win_lock(MPI_LOCK_SHARED, 1, 0, ventana);
+    }
+
+    // Todo el programa es movimiento de datos: las mediciones cuentan como distribución
+    TemporizadorFase temporizador(FASE_DISTRIBUCION);
+    for (int i = 0; i < calentamiento + iteraciones; i++) {
+        double inicio = MPI_Wtime();
+
+        switch (primitiva) {
+        case PRIMITIVA_SEND:
+            if (mi_rango == 0) {
+                MPI_Send(buffer.data(), bytes, MPI_BYTE, 1, 0, MPI_COMM_WORLD);
+                MPI_Recv(buffer.data(), bytes, MPI_BYTE, 1, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            } else {
+                MPI_Recv(buffer.data(), bytes, MPI_BYTE, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                MPI_Send(buffer.data(), bytes, MPI_BYTE, 0, 0, MPI_COMM_WORLD);
+            }
+            break;
+        case PRIMITIVA_SSEND:
+            if (mi_rango == 0) {
+                MPI_Ssend(buffer.data(), bytes, MPI_BYTE, 1, 0, MPI_COMM_WORLD);
+                MPI_Recv(buffer.data(), bytes, MPI_BYTE, 1, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            } else {
+                MPI_Recv(buffer.data(), bytes, MPI_BYTE, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                MPI_Ssend(buffer.data(), bytes, MPI_BYTE, 0, 0, MPI_COMM_WORLD);
+            }
+            break;
+        case PRIMITIVA_ISEND:
+            if (mi_rango == 0) {
+                MPI_Irecv(buffer_auxiliar.data(), bytes, MPI_BYTE, 1, 0, MPI_COMM_WORLD, &solicitudes[0]);
+                MPI_Isend(buffer.data(), bytes, MPI_BYTE, 1, 0, MPI_COMM_WORLD, &solicitudes[1]);
+                MPI_Waitall(2, solicitudes, MPI_STATUSES_IGNORE);
+            } else {
+                MPI_Irecv(buffer_auxiliar.data(), bytes, MPI_BYTE, 0, 0, MPI_COMM_WORLD, &solicitudes[0]);
+                MPI_Wait(&solicitudes[0], MPI_STATUS_IGNORE);
+                MPI_Isend(buffer.data(), bytes, MPI_BYTE, 0, 0, MPI_COMM_WORLD, &solicitudes[1]);
+                MPI_Wait(&solicitudes[1], MPI_STATUS_IGNORE);
+            }
+            break;
+        case PRIMITIVA_PERSISTENTE:
+            if (mi_rango == 0) {
+                MPI_Startall(2, solicitudes);
+                MPI_Waitall(2, solicitudes, MPI_STATUSES_IGNORE);
+            } else {
+                MPI_Start(&solicitudes[0]);
+                MPI_Wait(&solicitudes[0], MPI_STATUS_IGNORE);
+                MPI_Start(&solicitudes[1]);
+                MPI_Wait(&solicitudes[1], MPI_STATUS_IGNORE);
+            }
+            break;
+        case PRIMITIVA_SENDRECV:
+            MPI_Sendrecv(buffer.data(), bytes, MPI_BYTE, socio, 0,
+                         buffer_auxiliar.data(), bytes, MPI_BYTE, socio, 0,
+                         MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            break;
+        case PRIMITIVA_PUT_FENCE:
+            if (mi_rango == 0) MPI_Put(buffer_auxiliar.data(), bytes, MPI_BYTE, 1, 0, bytes, MPI_BYTE, ventana);
+            MPI_Win_fence(0, ventana);
+            break;
+        case PRIMITIVA_GET_FENCE:
+            if (mi_rango == 0) MPI_Get(buffer_auxiliar.data(), bytes, MPI_BYTE, 1, 0, bytes, MPI_BYTE, ventana);
+            MPI_Win_fence(0, ventana);
+            break;
+        case PRIMITIVA_PUT_LOCK:
+            if (mi_rango == 0) {
+                MPI_Put(buffer_auxiliar.data(), bytes, MPI_BYTE, 1, 0, bytes, MPI_BYTE, ventana);
+                MPI_Win_flush(1, ventana);
+            }
+            break;
+        case PRIMITIVA_GET_LOCK:
+            if (mi_rango == 0) {
+                MPI_Get(buffer_auxiliar.data(), bytes, MPI_BYTE, 1, 0, bytes, MPI_BYTE, ventana);
+                MPI_Win_flush(1, ventana);
+            }
+            break;
         }
-        MPI_Finalize();
-        return 1;
+
+        double fin = MPI_Wtime();
+        if (mi_rango == 0 && i >= calentamiento) tiempos.push_back(fin - inicio);
+    }
+
+    // Liberar lo que se preparó para la primitiva
+    if (primitiva == PRIMITIVA_PERSISTENTE) {
+        MPI_Request_free(&solicitudes[0]);
+        MPI_Request_free(&solicitudes[1]);
+    } else if (primitiva == PRIMITIVA_PUT_FENCE || primitiva == PRIMITIVA_GET_FENCE) {
+        MPI_Win_fence(MPI_MODE_NOSUCCEED, ventana);
+    } else if (primitiva == PRIMITIVA_PUT_LOCK || primitiva == PRIMITIVA_GET_LOCK) {
+        if (mi_rango == 0) MPI_Win_unlock(1, ventana);
+    }
+
+    // Los ping-pong de dos lados miden ida y vuelta
+    if (primitiva == PRIMITIVA_SEND || primitiva == PRIMITIVA_SSEND ||
+        primitiva == PRIMITIVA_ISEND || primitiva == PRIMITIVA_PERSISTENTE) {
+        for (double& t : tiempos) t /= 2.0;
     }
 
+    return tiempos;
+}
+
+// Ajuste por mínimos cuadrados del modelo de Hockney t(m) = alfa + beta * m sobre
+// los puntos [desde, hasta). Se pondera por 1/t^2 (error relativo) para que los
+// mensajes largos no anulen la latencia de los cortos
+double ajustar_hockney(const std::vector<double>& tamanos, const std::vector<double>& tiempos,
+                       int desde, int hasta, double& alfa, double& beta) {
+    double sw = 0, swx = 0, swy = 0, swxx = 0, swxy = 0;
+    for (int i = desde; i < hasta; i++) {
+        double w = 1.0 / (tiempos[i] * tiempos[i]);
+        sw += w;
+        swx += w * tamanos[i];
+        swy += w * tiempos[i];
+        swxx += w * tamanos[i] * tamanos[i];
+        swxy += w * tamanos[i] * tiempos[i];
+    }
+
+    double determinante = sw * swxx - swx * swx;
+    if (hasta - desde < 2 || determinante == 0.0) {
+        alfa = swy / sw;
+        beta = 0.0;
+    } else {
+        beta = (sw * swxy - swx * swy) / determinante;
+        alfa = (swy - beta * swx) / sw;
+    }
+
+    // Una latencia negativa no tiene sentido físico: reajustar con alfa = 0
+    if (alfa < 0.0 && swxx > 0.0) {
+        alfa = 0.0;
+        beta = swxy / swxx;
+    }
+
+    // Residuo relativo cuadrático para elegir el punto de quiebre
+    double residuo = 0.0;
+    for (int i = desde; i < hasta; i++) {
+        double error_relativo = (alfa + beta * tamanos[i] - tiempos[i]) / tiempos[i];
+        residuo += error_relativo * error_relativo;
+    }
+    return residuo;
+}
+
+void comparar_clock_wtime(int mi_rango) {
     const int NUMERO_ITERACIONES = 1000000;
     const int TAMANO_MENSAJE = 1;
     std::vector<double> mensaje(TAMANO_MENSAJE, 42.0);
@@ -25,7 +248,7 @@ int main(int argc, char* argv[]) {
     // Variables para medición de tiempo
     clock_t inicio_clock, fin_clock;
     double inicio_mpi, fin_mpi;
-    double tiempo_clock, tiempo_mpi;
+    double tiempo_clock = 0.0, tiempo_mpi = 0.0;
 
     if (mi_rango == 0) {
         std::cout << "=== MEDICIÓN DE TIEMPO PING-PONG ===" << std::endl;
@@ -63,6 +286,7 @@ int main(int argc, char* argv[]) {
         std::cout << "Iteraciones necesarias: " << iteraciones_minimas << std::endl;
 
         // Ping-pong con medición clock()
+        TemporizadorFase temporizador(FASE_DISTRIBUCION);
         inicio_clock = clock();
 
         for (int i = 0; i < NUMERO_ITERACIONES; i++) {
@@ -75,6 +299,7 @@ int main(int argc, char* argv[]) {
 
     } else if (mi_rango == 1) {
         // Proceso 1 responde al ping-pong
+        TemporizadorFase temporizador(FASE_DISTRIBUCION);
         for (int i = 0; i < NUMERO_ITERACIONES; i++) {
             MPI_Recv(mensaje.data(), TAMANO_MENSAJE, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
             MPI_Send(mensaje.data(), TAMANO_MENSAJE, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD);
@@ -94,6 +319,7 @@ int main(int argc, char* argv[]) {
         std::cout << "Resolución de MPI_Wtime(): " << std::scientific << tick << " segundos" << std::endl;
 
         // Ping-pong con medición MPI_Wtime()
+        TemporizadorFase temporizador(FASE_DISTRIBUCION);
         inicio_mpi = MPI_Wtime();
 
         for (int i = 0; i < NUMERO_ITERACIONES; i++) {
@@ -106,6 +332,7 @@ int main(int argc, char* argv[]) {
 
     } else if (mi_rango == 1) {
         // Proceso 1 responde al ping-pong
+        TemporizadorFase temporizador(FASE_DISTRIBUCION);
         for (int i = 0; i < NUMERO_ITERACIONES; i++) {
             MPI_Recv(mensaje.data(), TAMANO_MENSAJE, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
             MPI_Send(mensaje.data(), TAMANO_MENSAJE, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD);
@@ -155,7 +382,856 @@ int main(int argc, char* argv[]) {
 
         std::cout << "\nRecomendación: Use MPI_Wtime() para mediciones precisas en programas MPI" << std::endl;
     }
+}
+
+void barrido_latencia_ancho_banda(int mi_rango, int tamano_maximo) {
+    if (mi_rango == 0) {
+        std::cout << "=== BARRIDO DE LATENCIA Y ANCHO DE BANDA ===" << std::endl;
+        std::cout << "Tamaños de 0 B a " << tamano_maximo << " B en potencias de 2" << std::endl;
+        std::cout << "\nBytes\t\tIter\tMín [us]\tMediana [us]\tp99 [us]\tMáx [us]\tMB/s" << std::endl;
+    }
+
+    std::vector<char> buffer(std::max(tamano_maximo, 1), 'x');
+    std::vector<double> tamanos, latencias;
+
+    std::ofstream archivo_barrido;
+    if (mi_rango == 0) {
+        archivo_barrido.open("ping_pong_barrido.csv");
+        archivo_barrido << "bytes,iteraciones,min_s,mediana_s,p99_s,max_s,ancho_banda_MBps" << std::endl;
+    }
+
+    for (int bytes = 0; bytes <= tamano_maximo; bytes = (bytes == 0 ? 1 : bytes * 2)) {
+        int iteraciones = iteraciones_para_tamano(bytes);
+        int calentamiento = std::max(2, iteraciones / 10);
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        std::vector<double> tiempos = medir_primitiva(PRIMITIVA_SEND, mi_rango, buffer, buffer, MPI_WIN_NULL,
+                                                      bytes, iteraciones, calentamiento);
+
+        if (mi_rango == 0) {
+            EstadisticasTiempo est = calcular_estadisticas(tiempos);
+            double ancho_banda = bytes / est.mediana / (1024.0 * 1024.0);
+
+            tamanos.push_back(bytes);
+            latencias.push_back(est.mediana);
+
+            std::cout << std::fixed << std::setprecision(2) << bytes << "\t\t" << iteraciones << "\t"
+                      << est.minimo * 1e6 << "\t\t" << est.mediana * 1e6 << "\t\t"
+                      << est.p99 * 1e6 << "\t\t" << est.maximo * 1e6 << "\t\t"
+                      << ancho_banda << std::endl;
+            archivo_barrido << std::scientific << std::setprecision(6) << bytes << "," << iteraciones << ","
+                            << est.minimo << "," << est.mediana << "," << est.p99 << ","
+                            << est.maximo << "," << ancho_banda << std::endl;
+        }
+    }
+
+    if (mi_rango != 0) return;
+
+    // Modelo de Hockney global y en dos tramos (protocolo eager / rendezvous):
+    // el quiebre se elige minimizando el residuo relativo total
+    int puntos = tamanos.size();
+    double alfa_global, beta_global;
+    ajustar_hockney(tamanos, latencias, 0, puntos, alfa_global, beta_global);
+
+    int mejor_quiebre = -1;
+    double mejor_residuo = 0.0;
+    double alfa_corto = 0, beta_corto = 0, alfa_largo = 0, beta_largo = 0;
+    for (int quiebre = 3; quiebre <= puntos - 3; quiebre++) {
+        double a1, b1, a2, b2;
+        double residuo = ajustar_hockney(tamanos, latencias, 0, quiebre, a1, b1) +
+                         ajustar_hockney(tamanos, latencias, quiebre, puntos, a2, b2);
+        if (mejor_quiebre < 0 || residuo < mejor_residuo) {
+            mejor_quiebre = quiebre;
+            mejor_residuo = residuo;
+            alfa_corto = a1; beta_corto = b1;
+            alfa_largo = a2; beta_largo = b2;
+        }
+    }
+
+    std::ofstream archivo_modelo("ping_pong_modelo_hockney.csv");
+    archivo_modelo << "tramo,desde_bytes,hasta_bytes,alfa_s,beta_s_por_byte,ancho_banda_asintotico_MBps" << std::endl;
+    archivo_modelo << std::scientific << std::setprecision(6);
+
+    std::cout << "\n=== MODELO DE HOCKNEY t(m) = alfa + beta*m ===" << std::endl;
+    std::cout << std::scientific << std::setprecision(4);
+    std::cout << "Global:        alfa = " << alfa_global << " s, beta = " << beta_global << " s/B" << std::endl;
+    archivo_modelo << "global,0," << (long long)tamanos[puntos - 1] << "," << alfa_global << ","
+                   << beta_global << "," << (beta_global > 0 ? 1.0 / beta_global / (1024.0 * 1024.0) : 0.0) << std::endl;
+
+    if (mejor_quiebre > 0) {
+        std::cout << "Tramo corto:   alfa = " << alfa_corto << " s, beta = " << beta_corto
+                  << " s/B (hasta " << (long long)tamanos[mejor_quiebre - 1] << " B)" << std::endl;
+        std::cout << "Tramo largo:   alfa = " << alfa_largo << " s, beta = " << beta_largo
+                  << " s/B (desde " << (long long)tamanos[mejor_quiebre] << " B)" << std::endl;
+        archivo_modelo << "corto,0," << (long long)tamanos[mejor_quiebre - 1] << "," << alfa_corto << ","
+                       << beta_corto << "," << (beta_corto > 0 ? 1.0 / beta_corto / (1024.0 * 1024.0) : 0.0) << std::endl;
+        archivo_modelo << "largo," << (long long)tamanos[mejor_quiebre] << "," << (long long)tamanos[puntos - 1]
+                       << "," << alfa_largo << "," << beta_largo << ","
+                       << (beta_largo > 0 ? 1.0 / beta_largo / (1024.0 * 1024.0) : 0.0) << std::endl;
+    }
+
+    std::cout << "\nResultados en ping_pong_barrido.csv y ping_pong_modelo_hockney.csv" << std::endl;
+}
+
+void comparar_primitivas(int mi_rango, int tamano_maximo) {
+    if (mi_rango == 0) {
+        std::cout << "=== COMPARACIÓN DE PRIMITIVAS PUNTO A PUNTO ===" << std::endl;
+        std::cout << "Mediana del tiempo por mensaje de un sentido [us], de 0 B a "
+                  << tamano_maximo << " B" << std::endl;
+        std::cout << "\n" << std::setw(10) << "Bytes";
+        for (int primitiva = 0; primitiva < NUMERO_PRIMITIVAS; primitiva++) {
+            std::cout << std::setw(11) << NOMBRES_PRIMITIVAS[primitiva];
+        }
+        std::cout << std::setw(11) << "mejor" << std::endl;
+    }
+
+    std::vector<char> buffer(std::max(tamano_maximo, 1), 'x');
+    std::vector<char> buffer_auxiliar(std::max(tamano_maximo, 1), 'y');
+
+    // Ventana de un solo lado sobre "buffer", solo entre los procesos 0 y 1
+    MPI_Comm comunicador_par;
+    MPI_Comm_split(MPI_COMM_WORLD, mi_rango < 2 ? 0 : MPI_UNDEFINED, mi_rango, &comunicador_par);
+    MPI_Win ventana = MPI_WIN_NULL;
+    if (comunicador_par != MPI_COMM_NULL) {
+        MPI_Win_create(buffer.data(), buffer.size(), 1, MPI_INFO_NULL, comunicador_par, &ventana);
+    }
+
+    std::ofstream archivo_primitivas;
+    if (mi_rango == 0) {
+        archivo_primitivas.open("ping_pong_primitivas.csv");
+        archivo_primitivas << "bytes,primitiva,iteraciones,min_s,mediana_s,p99_s,max_s,ancho_banda_MBps" << std::endl;
+    }
+
+    for (int bytes = 0; bytes <= tamano_maximo; bytes = (bytes == 0 ? 1 : bytes * 2)) {
+        int iteraciones = iteraciones_para_tamano(bytes);
+        int calentamiento = std::max(2, iteraciones / 10);
+        int mejor_primitiva = 0;
+        double mejor_mediana = 0.0;
+
+        if (mi_rango == 0) std::cout << std::setw(10) << bytes << std::flush;
+
+        for (int primitiva = 0; primitiva < NUMERO_PRIMITIVAS; primitiva++) {
+            MPI_Barrier(MPI_COMM_WORLD);
+            std::vector<double> tiempos = medir_primitiva(primitiva, mi_rango, buffer, buffer_auxiliar, ventana,
+                                                          bytes, iteraciones, calentamiento);
+            if (mi_rango != 0) continue;
+
+            EstadisticasTiempo est = calcular_estadisticas(tiempos);
+            double ancho_banda = bytes / est.mediana / (1024.0 * 1024.0);
+            if (primitiva == 0 || est.mediana < mejor_mediana) {
+                mejor_primitiva = primitiva;
+                mejor_mediana = est.mediana;
+            }
+
+            std::cout << std::setw(11) << std::fixed << std::setprecision(2) << est.mediana * 1e6 << std::flush;
+            archivo_primitivas << std::scientific << std::setprecision(6) << bytes << ","
+                               << NOMBRES_PRIMITIVAS[primitiva] << "," << iteraciones << ","
+                               << est.minimo << "," << est.mediana << "," << est.p99 << ","
+                               << est.maximo << "," << ancho_banda << std::endl;
+        }
+
+        if (mi_rango == 0) std::cout << std::setw(11) << NOMBRES_PRIMITIVAS[mejor_primitiva] << std::endl;
+    }
+
+    if (ventana != MPI_WIN_NULL) MPI_Win_free(&ventana);
+    if (comunicador_par != MPI_COMM_NULL) MPI_Comm_free(&comunicador_par);
+
+    if (mi_rango == 0) {
+        std::cout << "\nNota: sendrecv mide un intercambio simultáneo; put/get miden la operación"
+                  << " más su sincronización (fence o flush)." << std::endl;
+        std::cout << "Resultados en ping_pong_primitivas.csv" << std::endl;
+    }
+}
+
+// Empareja a todos los procesos: el orden se divide en dos mitades y la
+// posición i se empareja con i + p/2. Sin "aleatorio" el orden agrupa por nodo,
+// de modo que las parejas cruzan la frontera entre nodos (bisección); con
+// "aleatorio" el orden es una permutación elegida por el proceso 0.
+// Devuelve el socio de cada proceso (-1 si p es impar y queda sin pareja)
+std::vector<int> calcular_socios(int numero_procesos, int mi_rango, bool aleatorio,
+                                 int& numero_nodos, int& pares_entre_nodos) {
+    // Identificar el nodo de cada proceso por el rango de su líder local
+    MPI_Comm comunicador_nodo;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, mi_rango, MPI_INFO_NULL, &comunicador_nodo);
+    int lider_nodo = mi_rango;
+    MPI_Bcast(&lider_nodo, 1, MPI_INT, 0, comunicador_nodo);
+    MPI_Comm_free(&comunicador_nodo);
+
+    std::vector<int> nodo_de(numero_procesos);
+    MPI_Allgather(&lider_nodo, 1, MPI_INT, nodo_de.data(), 1, MPI_INT, MPI_COMM_WORLD);
+
+    std::vector<int> lideres(nodo_de);
+    std::sort(lideres.begin(), lideres.end());
+    numero_nodos = std::unique(lideres.begin(), lideres.end()) - lideres.begin();
+
+    std::vector<int> orden(numero_procesos);
+    for (int i = 0; i < numero_procesos; i++) orden[i] = i;
+
+    if (aleatorio) {
+        if (mi_rango == 0) {
+            std::random_device rd;
+            std::mt19937 gen(rd());
+            std::shuffle(orden.begin(), orden.end(), gen);
+        }
+        MPI_Bcast(orden.data(), numero_procesos, MPI_INT, 0, MPI_COMM_WORLD);
+    } else {
+        std::stable_sort(orden.begin(), orden.end(),
+                         [&nodo_de](int a, int b) { return nodo_de[a] < nodo_de[b]; });
+    }
+
+    std::vector<int> socios(numero_procesos, -1);
+    int mitad = numero_procesos / 2;
+    pares_entre_nodos = 0;
+    for (int i = 0; i < mitad; i++) {
+        socios[orden[i]] = orden[i + mitad];
+        socios[orden[i + mitad]] = orden[i];
+        if (nodo_de[orden[i]] != nodo_de[orden[i + mitad]]) pares_entre_nodos++;
+    }
+
+    return socios;
+}
+
+// Todos los procesos trabajan en parejas a la vez: cada uno mantiene "ventana"
+// mensajes no bloqueantes pendientes en cada sentido y se mide la tasa agregada
+// de mensajes y el ancho de banda de bisección con la red bajo carga completa
+void medir_pares(int numero_procesos, int mi_rango, int tamano_maximo, int ventana, bool aleatorio) {
+    int numero_nodos, pares_entre_nodos;
+    std::vector<int> socios = calcular_socios(numero_procesos, mi_rango, aleatorio,
+                                              numero_nodos, pares_entre_nodos);
+    int socio = socios[mi_rango];
+    int numero_pares = numero_procesos / 2;
+
+    if (mi_rango == 0) {
+        std::cout << "=== TASA DE MENSAJES Y ANCHO DE BANDA DE BISECCIÓN ===" << std::endl;
+        std::cout << "Emparejamiento: " << (aleatorio ? "permutación aleatoria" : "entre nodos (bisección)")
+                  << ", " << numero_pares << " pares en " << numero_nodos << " nodo(s), "
+                  << pares_entre_nodos << " pares cruzan nodos" << std::endl;
+        std::cout << "Ventana de mensajes pendientes por sentido: " << ventana << std::endl;
+        if (numero_procesos <= 16) {
+            std::cout << "Parejas:";
+            for (int i = 0; i < numero_procesos; i++) {
+                if (socios[i] > i) std::cout << " (" << i << "," << socios[i] << ")";
+            }
+            std::cout << std::endl;
+        }
+        std::cout << "\nBytes\t\tRondas\tMensajes/s\t\tMB/s agregado\tMB/s por par" << std::endl;
+    }
+
+    std::vector<char> buffer_envio((size_t)ventana * std::max(tamano_maximo, 1), 'x');
+    std::vector<char> buffer_recepcion((size_t)ventana * std::max(tamano_maximo, 1));
+    std::vector<MPI_Request> solicitudes(2 * ventana);
+
+    std::ofstream archivo_pares;
+    if (mi_rango == 0) {
+        archivo_pares.open("ping_pong_pares.csv");
+        archivo_pares << "bytes,pares,pares_entre_nodos,ventana,rondas,tiempo_s,mensajes_por_s,ancho_banda_MBps" << std::endl;
+    }
+
+    for (long long bytes = 1; bytes <= tamano_maximo; bytes *= 2) {
+        int rondas = std::max(10, iteraciones_para_tamano(bytes) / ventana);
+        int calentamiento = 2;
+        double inicio = 0.0;
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        {
+            TemporizadorFase temporizador(FASE_DISTRIBUCION);
+            for (int ronda = 0; ronda < calentamiento + rondas; ronda++) {
+                if (ronda == calentamiento) {
+                    MPI_Barrier(MPI_COMM_WORLD);
+                    inicio = MPI_Wtime();
+                }
+                if (socio < 0) continue;
+
+                for (int m = 0; m < ventana; m++) {
+                    MPI_Irecv(buffer_recepcion.data() + (size_t)m * bytes, bytes, MPI_BYTE, socio, 0,
+                              MPI_COMM_WORLD, &solicitudes[m]);
+                }
+                for (int m = 0; m < ventana; m++) {
+                    MPI_Isend(buffer_envio.data() + (size_t)m * bytes, bytes, MPI_BYTE, socio, 0,
+                              MPI_COMM_WORLD, &solicitudes[ventana + m]);
+                }
+                MPI_Waitall(2 * ventana, solicitudes.data(), MPI_STATUSES_IGNORE);
+            }
+        }
+        double tiempo = MPI_Wtime() - inicio;
+
+        // El tiempo de la prueba es el del proceso más lento
+        double tiempo_max;
+        MPI_Reduce(&tiempo, &tiempo_max, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+        if (mi_rango == 0) {
+            double mensajes = 2.0 * numero_pares * ventana * (double)rondas;
+            double tasa_mensajes = mensajes / tiempo_max;
+            double ancho_banda = mensajes * bytes / tiempo_max / (1024.0 * 1024.0);
+
+            std::cout << bytes << "\t\t" << rondas << "\t" << std::scientific << std::setprecision(3)
+                      << tasa_mensajes << "\t\t" << std::fixed << std::setprecision(2) << ancho_banda
+                      << "\t\t" << ancho_banda / numero_pares << std::endl;
+            archivo_pares << bytes << "," << numero_pares << "," << pares_entre_nodos << "," << ventana << ","
+                          << rondas << "," << std::scientific << std::setprecision(6) << tiempo_max << ","
+                          << tasa_mensajes << "," << ancho_banda << std::endl;
+        }
+    }
+
+    if (mi_rango == 0) {
+        std::cout << "\nResultados en ping_pong_pares.csv" << std::endl;
+    }
+}
+
+// Socio de un proceso en la ronda "ronda" del torneo round-robin (método del
+// círculo): en cada ronda las parejas son disjuntas y en n - 1 rondas se cubren
+// todos los pares. Con p impar se agrega un proceso ficticio (devuelve -1)
+int socio_en_ronda(int mi_rango, int numero_procesos, int ronda) {
+    int n = numero_procesos + (numero_procesos % 2);
+    int socio;
+    if (mi_rango == n - 1) {
+        socio = ronda;
+    } else if (mi_rango == ronda) {
+        socio = n - 1;
+    } else {
+        socio = ((2 * ronda - mi_rango) % (n - 1) + (n - 1)) % (n - 1);
+    }
+    return socio < numero_procesos ? socio : -1;
+}
+
+// Mediana del tiempo de un sentido de un ping-pong bloqueante con "socio"
+// (solo es válida en el proceso iniciador)
+double ida_y_vuelta_con_socio(int socio, bool iniciador, std::vector<char>& buffer, int bytes,
+                              int iteraciones, int calentamiento) {
+    std::vector<double> tiempos;
+    TemporizadorFase temporizador(FASE_DISTRIBUCION);
+    for (int i = 0; i < calentamiento + iteraciones; i++) {
+        double inicio = MPI_Wtime();
+        if (iniciador) {
+            MPI_Send(buffer.data(), bytes, MPI_BYTE, socio, 0, MPI_COMM_WORLD);
+            MPI_Recv(buffer.data(), bytes, MPI_BYTE, socio, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        } else {
+            MPI_Recv(buffer.data(), bytes, MPI_BYTE, socio, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            MPI_Send(buffer.data(), bytes, MPI_BYTE, socio, 0, MPI_COMM_WORLD);
+        }
+        if (i >= calentamiento) tiempos.push_back((MPI_Wtime() - inicio) / 2.0);
+    }
+    return calcular_estadisticas(tiempos).mediana;
+}
+
+// Aristas (tarea_a, tarea_b, peso) del grafo de comunicación de otros programas:
+//  - "arbol": suma en árbol de 3_3_suma_arbol.cpp (paso = 1, 2, 4, ...)
+//  - "grilla": grilla de 3_6_matriz_vector_submatrices.cpp (reducción por filas
+//    hacia la columna 0 y recolección de la columna 0 en el proceso 0)
+bool construir_grafo(const std::string& grafo, int numero_procesos,
+                     std::vector<int>& origen, std::vector<int>& destino, std::vector<double>& peso) {
+    if (grafo == "arbol") {
+        for (int paso = 1; paso < numero_procesos; paso *= 2) {
+            for (int tarea = 0; tarea + paso < numero_procesos; tarea += 2 * paso) {
+                origen.push_back(tarea + paso);
+                destino.push_back(tarea);
+                peso.push_back(1.0);
+            }
+        }
+        return true;
+    }
+
+    if (grafo == "grilla") {
+        int lado = (int)sqrt(numero_procesos);
+        if (lado * lado != numero_procesos) return false;
+        for (int fila = 0; fila < lado; fila++) {
+            for (int col = 1; col < lado; col++) {
+                origen.push_back(fila * lado + col);
+                destino.push_back(fila * lado);
+                peso.push_back(1.0);
+            }
+            if (fila > 0) {
+                origen.push_back(fila * lado);
+                destino.push_back(0);
+                peso.push_back(1.0);
+            }
+        }
+        return true;
+    }
+
+    return false;
+}
+
+// Costo de una asignación tarea -> rango: suma de latencias de las aristas
+double costo_asignacion(const std::vector<int>& asignacion, const std::vector<double>& latencia,
+                        int numero_procesos, const std::vector<int>& origen,
+                        const std::vector<int>& destino, const std::vector<double>& peso) {
+    double costo = 0.0;
+    for (size_t e = 0; e < origen.size(); e++) {
+        costo += peso[e] * latencia[asignacion[origen[e]] * numero_procesos + asignacion[destino[e]]];
+    }
+    return costo;
+}
+
+// Mide latencia y ancho de banda entre todos los pares de procesos, detecta los
+// niveles de la jerarquía y sugiere un reordenamiento de rangos para "grafo"
+void medir_matriz_pares(int numero_procesos, int mi_rango, const std::string& grafo) {
+    const int BYTES_LATENCIA = 8;
+    const int BYTES_ANCHO_BANDA = 1024 * 1024;
+    int p = numero_procesos;
+
+    if (mi_rango == 0) {
+        std::cout << "=== MATRIZ DE LATENCIA Y ANCHO DE BANDA ENTRE TODOS LOS PARES ===" << std::endl;
+        std::cout << "Rondas round-robin: " << (p + p % 2 - 1) << " (parejas disjuntas en cada ronda)" << std::endl;
+    }
+
+    std::vector<char> buffer(BYTES_ANCHO_BANDA, 'x');
+    std::vector<double> latencia_local(p * p, 0.0), ancho_banda_local(p * p, 0.0);
+
+    for (int ronda = 0; ronda < p + p % 2 - 1; ronda++) {
+        int socio = socio_en_ronda(mi_rango, p, ronda);
+        MPI_Barrier(MPI_COMM_WORLD);
+        if (socio < 0) continue;
+
+        // El rango menor de la pareja inicia y anota la medición
+        bool iniciador = mi_rango < socio;
+        double latencia = ida_y_vuelta_con_socio(socio, iniciador, buffer, BYTES_LATENCIA, 1000, 100);
+        double tiempo_grande = ida_y_vuelta_con_socio(socio, iniciador, buffer, BYTES_ANCHO_BANDA, 20, 2);
+
+        if (iniciador) {
+            latencia_local[mi_rango * p + socio] = latencia_local[socio * p + mi_rango] = latencia;
+            ancho_banda_local[mi_rango * p + socio] = ancho_banda_local[socio * p + mi_rango] =
+                BYTES_ANCHO_BANDA / tiempo_grande / (1024.0 * 1024.0);
+        }
+    }
+
+    // Cada entrada la escribió un solo proceso: la suma arma la matriz completa
+    std::vector<double> latencia(p * p), ancho_banda(p * p);
+    MPI_Allreduce(latencia_local.data(), latencia.data(), p * p, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(ancho_banda_local.data(), ancho_banda.data(), p * p, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+    // Nodo de cada proceso para etiquetar los niveles
+    MPI_Comm comunicador_nodo;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, mi_rango, MPI_INFO_NULL, &comunicador_nodo);
+    int lider_nodo = mi_rango;
+    MPI_Bcast(&lider_nodo, 1, MPI_INT, 0, comunicador_nodo);
+    MPI_Comm_free(&comunicador_nodo);
+    std::vector<int> nodo_de(p);
+    MPI_Allgather(&lider_nodo, 1, MPI_INT, nodo_de.data(), 1, MPI_INT, MPI_COMM_WORLD);
+
+    if (mi_rango != 0) return;
+
+    // Matrices p x p en CSV y volcado "i j valor" con líneas en blanco entre
+    // filas, el formato que usan gnuplot (plot ... with image) y similares
+    std::ofstream archivo_latencia("ping_pong_matriz_latencia.csv");
+    std::ofstream archivo_ancho_banda("ping_pong_matriz_ancho_banda.csv");
+    std::ofstream archivo_mapa("ping_pong_matriz.dat");
+    archivo_mapa << "# i j latencia_us ancho_banda_MBps" << std::endl;
+    for (int i = 0; i < p; i++) {
+        for (int j = 0; j < p; j++) {
+            archivo_latencia << (j ? "," : "") << latencia[i * p + j];
+            archivo_ancho_banda << (j ? "," : "") << ancho_banda[i * p + j];
+            archivo_mapa << i << " " << j << " " << latencia[i * p + j] * 1e6 << " "
+                         << ancho_banda[i * p + j] << std::endl;
+        }
+        archivo_latencia << std::endl;
+        archivo_ancho_banda << std::endl;
+        archivo_mapa << std::endl;
+    }
+
+    if (p <= 16) {
+        std::cout << "\nLatencia [us]:" << std::endl;
+        std::cout << std::fixed << std::setprecision(2);
+        for (int i = 0; i < p; i++) {
+            for (int j = 0; j < p; j++) std::cout << std::setw(8) << latencia[i * p + j] * 1e6;
+            std::cout << std::endl;
+        }
+    }
+
+    // Niveles de la jerarquía: se ordenan las latencias y se corta donde una
+    // latencia supera en más de 1.5 veces a la anterior
+    std::vector<double> valores;
+    for (int i = 0; i < p; i++) {
+        for (int j = i + 1; j < p; j++) valores.push_back(latencia[i * p + j]);
+    }
+    std::sort(valores.begin(), valores.end());
+
+    std::cout << "\nNiveles de latencia detectados:" << std::endl;
+    size_t inicio_nivel = 0;
+    int nivel = 1;
+    for (size_t k = 1; k <= valores.size(); k++) {
+        if (k == valores.size() || valores[k] > 1.5 * valores[k - 1]) {
+            double limite_inferior = valores[inicio_nivel], limite_superior = valores[k - 1];
+
+            // Contar cuántos pares del nivel cruzan nodos
+            int pares = 0, entre_nodos = 0;
+            for (int i = 0; i < p; i++) {
+                for (int j = i + 1; j < p; j++) {
+                    double l = latencia[i * p + j];
+                    if (l >= limite_inferior && l <= limite_superior) {
+                        pares++;
+                        if (nodo_de[i] != nodo_de[j]) entre_nodos++;
+                    }
+                }
+            }
+            std::cout << "  Nivel " << nivel++ << ": " << limite_inferior * 1e6 << " - "
+                      << limite_superior * 1e6 << " us, " << pares << " pares ("
+                      << entre_nodos << " entre nodos)" << std::endl;
+            inicio_nivel = k;
+        }
+    }
+
+    // Reordenamiento sugerido: asignación tarea -> rango que minimiza la suma de
+    // latencias del grafo, por búsqueda local con intercambios de pares
+    std::vector<int> origen, destino;
+    std::vector<double> peso;
+    if (!construir_grafo(grafo, p, origen, destino, peso)) {
+        std::cout << "\nGrafo \"" << grafo << "\" no disponible para " << p
+                  << " procesos (use arbol, o grilla con p cuadrado perfecto)" << std::endl;
+        return;
+    }
+
+    std::vector<int> asignacion(p);
+    for (int tarea = 0; tarea < p; tarea++) asignacion[tarea] = tarea;
+    double costo_identidad = costo_asignacion(asignacion, latencia, p, origen, destino, peso);
+    double costo_actual = costo_identidad;
+
+    bool mejoro = true;
+    while (mejoro) {
+        mejoro = false;
+        for (int a = 0; a < p; a++) {
+            for (int b = a + 1; b < p; b++) {
+                std::swap(asignacion[a], asignacion[b]);
+                double costo = costo_asignacion(asignacion, latencia, p, origen, destino, peso);
+                if (costo < costo_actual - 1e-12) {
+                    costo_actual = costo;
+                    mejoro = true;
+                } else {
+                    std::swap(asignacion[a], asignacion[b]);
+                }
+            }
+        }
+    }
+
+    std::cout << "\nReordenamiento sugerido para el grafo \"" << grafo << "\":" << std::endl;
+    std::cout << "  Costo con rangos originales: " << costo_identidad * 1e6 << " us" << std::endl;
+    std::cout << "  Costo reordenado:            " << costo_actual * 1e6 << " us" << std::endl;
+
+    // Clave para MPI_Comm_split: el rango r toma la tarea lógica que se le asignó
+    std::vector<int> clave(p);
+    for (int tarea = 0; tarea < p; tarea++) clave[asignacion[tarea]] = tarea;
+    std::cout << "  Clave de MPI_Comm_split por rango:";
+    for (int r = 0; r < p; r++) std::cout << " " << clave[r];
+    std::cout << std::endl;
+
+    std::ofstream archivo_reorden("ping_pong_reordenamiento.csv");
+    archivo_reorden << "tarea,rango" << std::endl;
+    for (int tarea = 0; tarea < p; tarea++) archivo_reorden << tarea << "," << asignacion[tarea] << std::endl;
+
+    std::cout << "\nResultados en ping_pong_matriz_latencia.csv, ping_pong_matriz_ancho_banda.csv,"
+              << " ping_pong_matriz.dat y ping_pong_reordenamiento.csv" << std::endl;
+}
+
+// Formas de dar progreso a la comunicación pendiente en el modo "solapamiento"
+enum VarianteProgreso {
+    PROGRESO_NINGUNO,  // calcular todo y recién después MPI_Waitall
+    PROGRESO_TEST,     // MPI_Testall entre fragmentos del cálculo
+    PROGRESO_HILO,     // un hilo dedicado llama a MPI_Iprobe sin parar (MPI_THREAD_MULTIPLE)
+    NUMERO_VARIANTES_PROGRESO
+};
+
+const char* NOMBRES_VARIANTES_PROGRESO[NUMERO_VARIANTES_PROGRESO] = {"sin_progreso", "test", "hilo"};
+
+// Fracción oculta media (mensajes largos) a partir de la cual una variante
+// se considera útil en el resumen
+const double FRACCION_OCULTA_UTIL = 0.5;
+
+// Fragmentos en que se divide el cálculo para llamar a MPI_Testall entre ellos
+const int FRAGMENTOS_TEST = 64;
+
+// Evita que el compilador elimine el cálculo sintético
+volatile double sumidero_calculo = 1.0;
+
+// Cálculo sintético: una cadena de operaciones dependientes que no toca
+// memoria, para no competir por ancho de banda con la copia de los mensajes
+double calculo_sintetico(long long iteraciones) {
+    double x = sumidero_calculo;
+    for (long long i = 0; i < iteraciones; i++) x = x * 0.999999 + 1e-6;
+    return x;
+}
+
+// Un intercambio simultáneo entre los procesos 0 y 1: publica MPI_Irecv y
+// MPI_Isend, calcula "iteraciones" y espera. Devuelve la duración total
+double intercambio_con_calculo(int variante, int socio, std::vector<char>& envio, std::vector<char>& recepcion,
+                               int bytes, long long iteraciones) {
+    MPI_Request solicitudes[2];
+    double inicio = MPI_Wtime();
+    MPI_Irecv(recepcion.data(), bytes, MPI_BYTE, socio, 0, MPI_COMM_WORLD, &solicitudes[0]);
+    MPI_Isend(envio.data(), bytes, MPI_BYTE, socio, 0, MPI_COMM_WORLD, &solicitudes[1]);
+
+    if (variante == PROGRESO_TEST) {
+        long long fragmento = std::max(1LL, iteraciones / FRAGMENTOS_TEST);
+        int terminado = 0;
+        for (long long hechas = 0; hechas < iteraciones; hechas += fragmento) {
+            sumidero_calculo = calculo_sintetico(std::min(fragmento, iteraciones - hechas));
+            if (!terminado) MPI_Testall(2, solicitudes, &terminado, MPI_STATUSES_IGNORE);
+        }
+    } else {
+        sumidero_calculo = calculo_sintetico(iteraciones);
+    }
+
+    MPI_Waitall(2, solicitudes, MPI_STATUSES_IGNORE);
+    return MPI_Wtime() - inicio;
+}
+
+// ¿La biblioteca MPI mueve los datos mientras el programa calcula? Para cada
+// tamaño se mide el intercambio solo (comunicación), el cálculo solo,
+// calibrado para durar lo mismo, y los dos juntos con cada variante de
+// progreso. Fracción oculta = (comunicación + cálculo - total) / comunicación:
+// 1 si el intercambio quedó completamente detrás del cálculo, 0 si se
+// sumaron. Participan los procesos 0 y 1
+void medir_solapamiento(int mi_rango, int tamano_maximo, bool hilo_disponible) {
+    const int REPETICIONES = 20;
+    const int CALENTAMIENTO = 3;
+
+    MPI_Comm comunicador_par;
+    MPI_Comm_split(MPI_COMM_WORLD, mi_rango < 2 ? 0 : MPI_UNDEFINED, mi_rango, &comunicador_par);
+    if (comunicador_par == MPI_COMM_NULL) return;
+    int socio = 1 - mi_rango;
+
+    // Costo de una iteración del cálculo sintético (el menor de varios intentos)
+    const long long ITERACIONES_CALIBRACION = 1000000;
+    double costo_iteracion = 0.0;
+    for (int intento = 0; intento < 5; intento++) {
+        double inicio = MPI_Wtime();
+        sumidero_calculo = calculo_sintetico(ITERACIONES_CALIBRACION);
+        double costo = (MPI_Wtime() - inicio) / ITERACIONES_CALIBRACION;
+        if (intento == 0 || costo < costo_iteracion) costo_iteracion = costo;
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &costo_iteracion, 1, MPI_DOUBLE, MPI_MAX, comunicador_par);
+
+    if (mi_rango == 0) {
+        std::cout << "=== SOLAPAMIENTO DE CÁLCULO Y COMUNICACIÓN ===" << std::endl;
+        std::cout << "Intercambio MPI_Isend/MPI_Irecv entre los procesos 0 y 1 con un cálculo de la misma"
+                  << " duración en medio" << std::endl;
+        std::cout << "Cálculo sintético: " << std::fixed << std::setprecision(3) << costo_iteracion * 1e9
+                  << " ns por iteración; mediana de " << REPETICIONES << " repeticiones" << std::endl;
+        if (!hilo_disponible) {
+            std::cout << "⚠️ MPI no provee MPI_THREAD_MULTIPLE: se omite la variante con hilo de progreso"
+                      << std::endl;
+        }
+        std::cout << "\n" << std::setw(10) << "Bytes" << std::setw(12) << "Com. [us]" << std::setw(13)
+                  << "Cálc. [us]";
+        for (int variante = 0; variante < NUMERO_VARIANTES_PROGRESO; variante++) {
+            std::cout << std::setw(16) << NOMBRES_VARIANTES_PROGRESO[variante];
+        }
+        std::cout << "   (total [us] / % oculto)" << std::endl;
+    }
+
+    std::vector<char> envio(std::max(tamano_maximo, 1), 'x');
+    std::vector<char> recepcion(std::max(tamano_maximo, 1), 'y');
+
+    std::ofstream archivo_solapamiento;
+    if (mi_rango == 0) {
+        archivo_solapamiento.open("ping_pong_solapamiento.csv");
+        archivo_solapamiento << "bytes,variante,comunicacion_s,calculo_s,total_s,fraccion_oculta" << std::endl;
+    }
+
+    // Fracción oculta acumulada por variante en los mensajes de 64 KiB o más
+    // (donde las bibliotecas suelen pasar al protocolo rendezvous)
+    const int BYTES_MENSAJE_LARGO = 64 * 1024;
+    double suma_oculta[NUMERO_VARIANTES_PROGRESO] = {0.0};
+    int tamanos_largos = 0;
+
+    for (long long bytes = 1024; bytes <= tamano_maximo; bytes *= 4) {
+        std::vector<double> tiempos;
+
+        // Comunicación sola
+        {
+            TemporizadorFase temporizador(FASE_DISTRIBUCION);
+            for (int repeticion = 0; repeticion < CALENTAMIENTO + REPETICIONES; repeticion++) {
+                MPI_Barrier(comunicador_par);
+                double tiempo = intercambio_con_calculo(PROGRESO_NINGUNO, socio, envio, recepcion, bytes, 0);
+                if (repeticion >= CALENTAMIENTO) tiempos.push_back(tiempo);
+            }
+        }
+        double comunicacion = calcular_estadisticas(tiempos).mediana;
+        MPI_Allreduce(MPI_IN_PLACE, &comunicacion, 1, MPI_DOUBLE, MPI_MAX, comunicador_par);
+        long long iteraciones = std::max(1LL, (long long)std::llround(comunicacion / costo_iteracion));
+
+        // Cálculo solo
+        tiempos.clear();
+        {
+            TemporizadorFase temporizador(FASE_CALCULO);
+            for (int repeticion = 0; repeticion < CALENTAMIENTO + REPETICIONES; repeticion++) {
+                double inicio = MPI_Wtime();
+                sumidero_calculo = calculo_sintetico(iteraciones);
+                if (repeticion >= CALENTAMIENTO) tiempos.push_back(MPI_Wtime() - inicio);
+            }
+        }
+        double calculo = calcular_estadisticas(tiempos).mediana;
+        MPI_Allreduce(MPI_IN_PLACE, &calculo, 1, MPI_DOUBLE, MPI_MAX, comunicador_par);
+
+        if (mi_rango == 0) {
+            std::cout << std::setw(10) << bytes << std::fixed << std::setprecision(1) << std::setw(12)
+                      << comunicacion * 1e6 << std::setw(12) << calculo * 1e6 << std::flush;
+        }
+        if (bytes >= BYTES_MENSAJE_LARGO) tamanos_largos++;
+
+        // Los dos juntos, con cada variante de progreso
+        for (int variante = 0; variante < NUMERO_VARIANTES_PROGRESO; variante++) {
+            if (variante == PROGRESO_HILO && !hilo_disponible) {
+                if (mi_rango == 0) std::cout << std::setw(16) << "-";
+                continue;
+            }
+
+            // El hilo de progreso sondea un comunicador propio, sin mensajes:
+            // cada llamada hace avanzar el motor de progreso de la biblioteca
+            std::atomic<bool> detener_hilo(false);
+            std::thread hilo_progreso;
+            MPI_Comm comunicador_progreso = MPI_COMM_NULL;
+            if (variante == PROGRESO_HILO) {
+                MPI_Comm_dup(comunicador_par, &comunicador_progreso);
+                hilo_progreso = std::thread([&detener_hilo, comunicador_progreso] {
+                    int hay_mensaje;
+                    while (!detener_hilo.load(std::memory_order_relaxed)) {
+                        MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, comunicador_progreso, &hay_mensaje,
+                                   MPI_STATUS_IGNORE);
+                    }
+                });
+            }
+
+            tiempos.clear();
+            for (int repeticion = 0; repeticion < CALENTAMIENTO + REPETICIONES; repeticion++) {
+                MPI_Barrier(comunicador_par);
+                double tiempo = intercambio_con_calculo(variante, socio, envio, recepcion, bytes, iteraciones);
+                if (repeticion >= CALENTAMIENTO) tiempos.push_back(tiempo);
+            }
+
+            if (variante == PROGRESO_HILO) {
+                detener_hilo = true;
+                hilo_progreso.join();
+                MPI_Comm_free(&comunicador_progreso);
+            }
+
+            double total = calcular_estadisticas(tiempos).mediana;
+            MPI_Allreduce(MPI_IN_PLACE, &total, 1, MPI_DOUBLE, MPI_MAX, comunicador_par);
+            double oculta = std::min(1.0, std::max(0.0, (comunicacion + calculo - total) / comunicacion));
+            if (bytes >= BYTES_MENSAJE_LARGO) suma_oculta[variante] += oculta;
+
+            if (mi_rango == 0) {
+                std::ostringstream celda;
+                celda << std::fixed << std::setprecision(1) << total * 1e6 << " / " << std::setprecision(0)
+                      << oculta * 100 << "%";
+                std::cout << std::setw(16) << celda.str() << std::flush;
+                archivo_solapamiento << std::scientific << std::setprecision(6) << bytes << ","
+                                     << NOMBRES_VARIANTES_PROGRESO[variante] << "," << comunicacion << ","
+                                     << calculo << "," << total << "," << oculta << std::endl;
+            }
+        }
+        if (mi_rango == 0) std::cout << std::endl;
+    }
+
+    MPI_Comm_free(&comunicador_par);
+    if (mi_rango != 0) return;
+
+    if (tamanos_largos > 0) {
+        std::cout << "\nFracción oculta media en mensajes de " << BYTES_MENSAJE_LARGO / 1024 << " KiB o más:"
+                  << std::endl;
+        // Variantes que ocultan al menos FRACCION_OCULTA_UTIL, en el orden de la
+        // tabla (de menos a más intrusiva en el código)
+        std::vector<int> utiles;
+        for (int variante = 0; variante < NUMERO_VARIANTES_PROGRESO; variante++) {
+            if (variante == PROGRESO_HILO && !hilo_disponible) continue;
+            double media = suma_oculta[variante] / tamanos_largos;
+            if (media >= FRACCION_OCULTA_UTIL) utiles.push_back(variante);
+            std::cout << "  " << std::left << std::setw(14) << NOMBRES_VARIANTES_PROGRESO[variante] << std::right
+                      << std::fixed << std::setprecision(0) << media * 100 << "%"
+                      << (media >= FRACCION_OCULTA_UTIL ? "  ✅" : "") << std::endl;
+        }
+
+        if (utiles.empty()) {
+            std::cout << "Ninguna variante oculta el " << FRACCION_OCULTA_UTIL * 100 << "% de la comunicación: en "
+                      << "esta pila (biblioteca, red y procesos por núcleo) el solapamiento no rinde y no conviene "
+                      << "reestructurar el código para buscarlo" << std::endl;
+        } else if (utiles.front() == PROGRESO_NINGUNO) {
+            std::cout << "La biblioteca avanza sola: publicar temprano y esperar tarde alcanza para solapar"
+                      << std::endl;
+        } else {
+            std::cout << "La biblioteca no avanza sola; el solapamiento rinde con";
+            for (size_t i = 0; i < utiles.size(); i++) {
+                std::cout << (i == 0 ? " " : " y ") << NOMBRES_VARIANTES_PROGRESO[utiles[i]];
+            }
+            std::cout << (utiles.front() == PROGRESO_TEST ? " (MPI_Test durante el cálculo)"
+                                                          : " (solo con un hilo de progreso)")
+                      << std::endl;
+        }
+    }
+    std::cout << "\nResultados en ping_pong_solapamiento.csv" << std::endl;
+}
+
+#ifndef NUCLEOS_SIN_MAIN
+int main(int argc, char* argv[]) {
+    int numero_procesos, mi_rango;
+
+    // El modo solapamiento usa un hilo de progreso que llama a MPI a la vez
+    // que el hilo principal. Solo ahí se pide MPI_THREAD_MULTIPLE, para no
+    // sumar el costo de sus candados a las demás mediciones
+    bool pedir_hilos = argc > 1 && strcmp(argv[1], "solapamiento") == 0;
+    int nivel_provisto = MPI_THREAD_SINGLE;
+    if (pedir_hilos) {
+        MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &nivel_provisto);
+    } else {
+        MPI_Init(&argc, &argv);
+    }
+    MPI_Comm_size(MPI_COMM_WORLD, &numero_procesos);
+    MPI_Comm_rank(MPI_COMM_WORLD, &mi_rango);
+
+    if (numero_procesos < 2) {
+        if (mi_rango == 0) {
+            std::cout << "Este programa requiere al menos 2 procesos" << std::endl;
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    // El proceso 0 interpreta los argumentos: [modo] [tamaño máximo en bytes] [ventana]
+    // (en el modo matriz el segundo argumento es el grafo: arbol o grilla)
+    int modo = MODO_CLOCK_VS_WTIME;
+    int tamano_maximo = 64 * 1024 * 1024;
+    int ventana = 64;
+    std::string grafo = "arbol";
+    if (mi_rango == 0) {
+        if (argc > 1 && strcmp(argv[1], "barrido") == 0) modo = MODO_BARRIDO;
+        if (argc > 1 && strcmp(argv[1], "primitivas") == 0) modo = MODO_PRIMITIVAS;
+        if (argc > 1 && strcmp(argv[1], "pares") == 0) modo = MODO_PARES;
+        if (argc > 1 && strcmp(argv[1], "pares_aleatorio") == 0) modo = MODO_PARES_ALEATORIO;
+        if (argc > 1 && strcmp(argv[1], "matriz") == 0) modo = MODO_MATRIZ;
+        if (argc > 1 && strcmp(argv[1], "solapamiento") == 0) modo = MODO_SOLAPAMIENTO;
+
+        // Con muchos mensajes pendientes por par el máximo por defecto es menor
+        if (modo == MODO_PARES || modo == MODO_PARES_ALEATORIO) tamano_maximo = 1024 * 1024;
+        if (modo == MODO_SOLAPAMIENTO) tamano_maximo = 16 * 1024 * 1024;
+        if (modo == MODO_MATRIZ) {
+            if (argc > 2) grafo = argv[2];
+        } else if (argc > 2) {
+            // Los barridos duplican o cuadruplican el tamaño: por encima de
+            // INT_MAX / 4 el paso siguiente ya no cabe en un int
+            tamano_maximo = std::min(atoi(argv[2]), INT_MAX / 4);
+        }
+        if (argc > 3) ventana = std::max(1, atoi(argv[3]));
+    }
+    MPI_Bcast(&modo, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Bcast(&tamano_maximo, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Bcast(&ventana, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+    if (modo == MODO_BARRIDO) {
+        barrido_latencia_ancho_banda(mi_rango, tamano_maximo);
+    } else if (modo == MODO_PRIMITIVAS) {
+        comparar_primitivas(mi_rango, tamano_maximo);
+    } else if (modo == MODO_PARES || modo == MODO_PARES_ALEATORIO) {
+        medir_pares(numero_procesos, mi_rango, tamano_maximo, ventana, modo == MODO_PARES_ALEATORIO);
+    } else if (modo == MODO_MATRIZ) {
+        // Solo el proceso 0 usa el nombre del grafo
+        medir_matriz_pares(numero_procesos, mi_rango, grafo);
+    } else if (modo == MODO_SOLAPAMIENTO) {
+        medir_solapamiento(mi_rango, tamano_maximo, nivel_provisto >= MPI_THREAD_MULTIPLE);
+    } else {
+        comparar_clock_wtime(mi_rango);
+    }
 
+    reportar_fases(MPI_COMM_WORLD);
     MPI_Finalize();
     return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -4,6 +4,24 @@
 #include <algorithm>
 #include <random>
 #include <iomanip>
+#include <cstring>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <type_traits>
+#include <cstddef>
+#include "temporizador_fases.h"
+#include "contadores_hardware.h"
+#include "memoria_nodo.h"
+#include "pool_buffers.h"
 
 void merge(std::vector<int>& arr, int izq, int medio, int der) {
     int n1 = medio - izq + 1;
@@ -51,57 +69,1654 @@ void merge_sort_secuencial(std::vector<int>& arr, int izq, int der) {
     }
 }
 
-std::vector<int> merge_dos_vectores(const std::vector<int>& vec1, const std::vector<int>& vec2) {
+// Tamaño de los tramos que se ordenan por inserción antes de empezar a combinar
+const int TAMANO_TRAMO_INSERCION = 32;
+
+// Extracción de clave por defecto: el elemento es su propia clave. Los
+// ordenamientos genéricos reciben un functor así para ordenar registros por
+// uno de sus campos
+struct ClaveIdentidad {
+    template <typename T>
+    const T& operator()(const T& x) const { return x; }
+};
+
+template <typename T, typename Clave = ClaveIdentidad>
+void ordenar_por_insercion(T* datos, int n, Clave clave = Clave()) {
+    for (int i = 1; i < n; i++) {
+        T valor = datos[i];
+        int j = i - 1;
+        while (j >= 0 && clave(valor) < clave(datos[j])) {
+            datos[j + 1] = datos[j];
+            j--;
+        }
+        datos[j + 1] = valor;
+    }
+}
+
+// Combina los tramos ordenados origen[izq, medio) y origen[medio, der) en destino[izq, der)
+template <typename T, typename Clave = ClaveIdentidad>
+void combinar_tramos(const T* origen, T* destino, int izq, int medio, int der, Clave clave = Clave()) {
+    int i = izq, j = medio, k = izq;
+    while (i < medio && j < der) {
+        if (clave(origen[i]) <= clave(origen[j])) {
+            destino[k++] = origen[i++];
+        } else {
+            destino[k++] = origen[j++];
+        }
+    }
+    while (i < medio) destino[k++] = origen[i++];
+    while (j < der) destino[k++] = origen[j++];
+}
+
+// Merge sort ascendente (no recursivo) que no reserva memoria: ordena por
+// inserción tramos de TAMANO_TRAMO_INSERCION elementos y luego los combina de
+// a pares, duplicando el ancho en cada pasada y alternando entre "datos" y
+// "auxiliar" (buffer ping-pong preasignado que se reutiliza entre llamadas).
+// Devuelve true si el resultado quedó en "auxiliar"
+template <typename T, typename Clave = ClaveIdentidad>
+bool merge_sort_ascendente(T* datos, T* auxiliar, int n, Clave clave = Clave()) {
+    for (int inicio = 0; inicio < n; inicio += TAMANO_TRAMO_INSERCION) {
+        ordenar_por_insercion(datos + inicio, std::min(TAMANO_TRAMO_INSERCION, n - inicio), clave);
+    }
+
+    T* origen = datos;
+    T* destino = auxiliar;
+    for (int ancho = TAMANO_TRAMO_INSERCION; ancho < n; ancho *= 2) {
+        for (int izq = 0; izq < n; izq += 2 * ancho) {
+            int medio = std::min(izq + ancho, n);
+            int der = std::min(izq + 2 * ancho, n);
+            combinar_tramos(origen, destino, izq, medio, der, clave);
+        }
+        std::swap(origen, destino);
+    }
+
+    return origen != datos;
+}
+
+// Radix sort LSD de 4 pasadas de 8 bits para claves int. El bit de signo se
+// invierte para que los negativos queden primero. Se omiten las pasadas en las
+// que todas las claves comparten el byte (con claves pequeñas solo se hacen 1 o 2).
+// Devuelve true si el resultado quedó en "auxiliar"
+bool radix_sort(int* datos, int* auxiliar, int n) {
+    // Histogramas de los 4 bytes en una sola lectura de los datos
+    int conteos[4][256] = {{0}};
+    for (int i = 0; i < n; i++) {
+        unsigned int clave = (unsigned int)datos[i] ^ 0x80000000u;
+        for (int byte = 0; byte < 4; byte++) {
+            conteos[byte][(clave >> (8 * byte)) & 0xFF]++;
+        }
+    }
+
+    int* origen = datos;
+    int* destino = auxiliar;
+    for (int byte = 0; byte < 4; byte++) {
+        int* conteo = conteos[byte];
+        if (n == 0 || conteo[(((unsigned int)origen[0] ^ 0x80000000u) >> (8 * byte)) & 0xFF] == n) continue;
+
+        // Posiciones de inicio de cada cubeta
+        int acumulado = 0;
+        for (int cubeta = 0; cubeta < 256; cubeta++) {
+            int c = conteo[cubeta];
+            conteo[cubeta] = acumulado;
+            acumulado += c;
+        }
+
+        for (int i = 0; i < n; i++) {
+            unsigned int clave = (unsigned int)origen[i] ^ 0x80000000u;
+            destino[conteo[(clave >> (8 * byte)) & 0xFF]++] = origen[i];
+        }
+        std::swap(origen, destino);
+    }
+
+    return origen != datos;
+}
+
+// Ordenamiento de un rango: merge sort ascendente para cualquier tipo de clave
+// y radix sort para int (elegido en compilación). Devuelve true si el
+// resultado quedó en "auxiliar"
+template <typename T>
+bool ordenar_rango(T* datos, T* auxiliar, int n) {
+    return merge_sort_ascendente(datos, auxiliar, n);
+}
+
+template <>
+bool ordenar_rango<int>(int* datos, int* auxiliar, int n) {
+    return radix_sort(datos, auxiliar, n);
+}
+
+// ===== Ordenamiento local multihilo =====
+
+// Índice del hilo actual dentro del pool (0 = hilo principal, el que llama a MPI)
+thread_local int indice_hilo_actual = 0;
+
+// Pool de hilos con robo de trabajo (work stealing) para paralelismo fork-join.
+// Cada participante tiene su propia cola: el dueño agrega y toma tareas por
+// atrás (LIFO, las más recientes y pequeñas) y los hilos ociosos roban por
+// delante (FIFO, las más antiguas y grandes). El hilo principal participa
+// ejecutando tareas mientras espera a sus hijas, así que nunca se bloquea
+// esperando trabajo que él mismo encoló
+class PoolHilos {
+public:
+    explicit PoolHilos(int numero_hilos) : disponibles(0), terminar(false) {
+        for (int i = 0; i < numero_hilos; i++) colas.emplace_back(new Cola());
+        for (int i = 1; i < numero_hilos; i++) {
+            hilos.emplace_back(&PoolHilos::trabajar, this, i);
+        }
+    }
+
+    ~PoolHilos() {
+        {
+            std::lock_guard<std::mutex> lock(cerrojo_espera);
+            terminar = true;
+        }
+        hay_trabajo.notify_all();
+        for (std::thread& hilo : hilos) hilo.join();
+    }
+
+    int tamano() const { return (int)colas.size(); }
+
+    // Encola una tarea en la cola del hilo actual; "pendientes" cuenta las
+    // tareas del grupo que todavía no terminaron
+    void lanzar(std::function<void()> tarea, std::atomic<int>& pendientes) {
+        pendientes++;
+        Cola& cola = *colas[indice_hilo_actual];
+        {
+            std::lock_guard<std::mutex> lock(cola.cerrojo);
+            cola.tareas.push_back([tarea, &pendientes]() {
+                tarea();
+                pendientes--;
+            });
+        }
+        {
+            std::lock_guard<std::mutex> lock(cerrojo_espera);
+            disponibles++;
+        }
+        hay_trabajo.notify_one();
+    }
+
+    // Espera a que terminen las tareas del grupo ejecutando trabajo mientras tanto
+    void esperar(std::atomic<int>& pendientes) {
+        while (pendientes > 0) {
+            if (!ejecutar_una(indice_hilo_actual)) std::this_thread::yield();
+        }
+    }
+
+private:
+    struct Cola {
+        std::mutex cerrojo;
+        std::deque<std::function<void()>> tareas;
+    };
+
+    // Toma una tarea de la cola propia (por atrás) o roba de otra (por delante)
+    bool ejecutar_una(int indice) {
+        std::function<void()> tarea;
+        int numero_colas = (int)colas.size();
+        for (int intento = 0; intento < numero_colas && !tarea; intento++) {
+            Cola& cola = *colas[(indice + intento) % numero_colas];
+            std::lock_guard<std::mutex> lock(cola.cerrojo);
+            if (cola.tareas.empty()) continue;
+            if (intento == 0) {
+                tarea = std::move(cola.tareas.back());
+                cola.tareas.pop_back();
+            } else {
+                tarea = std::move(cola.tareas.front());
+                cola.tareas.pop_front();
+            }
+        }
+        if (!tarea) return false;
+        disponibles--;
+        tarea();
+        return true;
+    }
+
+    void trabajar(int indice) {
+        indice_hilo_actual = indice;
+        while (true) {
+            if (ejecutar_una(indice)) continue;
+            std::unique_lock<std::mutex> lock(cerrojo_espera);
+            hay_trabajo.wait(lock, [this]() { return terminar || disponibles > 0; });
+            if (terminar && disponibles == 0) return;
+        }
+    }
+
+    std::vector<std::unique_ptr<Cola>> colas;
+    std::vector<std::thread> hilos;
+    std::atomic<int> disponibles;
+    bool terminar;
+    std::mutex cerrojo_espera;
+    std::condition_variable hay_trabajo;
+};
+
+// Por debajo de estos tamaños no conviene crear más tareas
+const int UMBRAL_TAREA_ORDENAMIENTO = 1 << 15;
+const int UMBRAL_TAREA_MERGE = 1 << 15;
+
+// Pool usado por ordenar_local; nulo cuando se ordena con un solo hilo
+PoolHilos* pool_ordenamiento = nullptr;
+
+// Merge secuencial estable de a[0, na) y b[0, nb) en salida (ante empate va a)
+template <typename T>
+void combinar_secuencias(const T* a, int na, const T* b, int nb, T* salida) {
+    int i = 0, j = 0, k = 0;
+    while (i < na && j < nb) {
+        if (a[i] <= b[j]) {
+            salida[k++] = a[i++];
+        } else {
+            salida[k++] = b[j++];
+        }
+    }
+    while (i < na) salida[k++] = a[i++];
+    while (j < nb) salida[k++] = b[j++];
+}
+
+// Co-rango: cuántos de los primeros "posicion" elementos de la salida del
+// merge vienen de "a". Se obtiene por búsqueda binaria sin recorrer los datos,
+// lo que permite que cada hilo calcule su tramo de salida de forma independiente
+template <typename T>
+int co_rango(int posicion, const T* a, int na, const T* b, int nb) {
+    int bajo = std::max(0, posicion - nb);
+    int alto = std::min(posicion, na);
+    while (bajo < alto) {
+        int medio = bajo + (alto - bajo) / 2;
+        int k = posicion - medio;
+        if (b[k - 1] < a[medio]) {
+            alto = medio;
+        } else {
+            bajo = medio + 1;
+        }
+    }
+    return bajo;
+}
+
+// Merge paralelo: la salida se divide en tramos iguales y los co-rangos de sus
+// bordes dicen qué parte de cada entrada le corresponde a cada tramo
+template <typename T>
+void merge_paralelo(const T* a, int na, const T* b, int nb, T* salida, PoolHilos& pool) {
+    int total = na + nb;
+    int tramos = std::min(4 * pool.tamano(), total / UMBRAL_TAREA_MERGE);
+    if (tramos <= 1) {
+        combinar_secuencias(a, na, b, nb, salida);
+        return;
+    }
+
+    std::atomic<int> pendientes(0);
+    for (int t = 0; t < tramos; t++) {
+        int inicio = (int)((long long)total * t / tramos);
+        int fin = (int)((long long)total * (t + 1) / tramos);
+        int ia = co_rango(inicio, a, na, b, nb);
+        int ja = co_rango(fin, a, na, b, nb);
+        int ib = inicio - ia, jb = fin - ja;
+        pool.lanzar([=]() { combinar_secuencias(a + ia, ja - ia, b + ib, jb - ib, salida + inicio); }, pendientes);
+    }
+    pool.esperar(pendientes);
+}
+
+// Merge sort paralelo recursivo: las dos mitades se ordenan como tareas y
+// dejan su resultado en el buffer opuesto al destino, de donde el merge
+// paralelo las combina. Las hojas usan el ordenamiento secuencial del tipo
+// (radix sort para int). Si en_auxiliar, el resultado queda en "auxiliar"
+template <typename T>
+void ordenar_paralelo_rango(T* datos, T* auxiliar, int n, bool en_auxiliar, PoolHilos& pool) {
+    if (n <= UMBRAL_TAREA_ORDENAMIENTO) {
+        bool quedo_en_auxiliar = ordenar_rango(datos, auxiliar, n);
+        if (quedo_en_auxiliar && !en_auxiliar) std::copy(auxiliar, auxiliar + n, datos);
+        if (!quedo_en_auxiliar && en_auxiliar) std::copy(datos, datos + n, auxiliar);
+        return;
+    }
+
+    int mitad = n / 2;
+    std::atomic<int> pendientes(0);
+    pool.lanzar([=, &pool]() { ordenar_paralelo_rango(datos, auxiliar, mitad, !en_auxiliar, pool); }, pendientes);
+    ordenar_paralelo_rango(datos + mitad, auxiliar + mitad, n - mitad, !en_auxiliar, pool);
+    pool.esperar(pendientes);
+
+    T* origen = en_auxiliar ? datos : auxiliar;
+    T* destino = en_auxiliar ? auxiliar : datos;
+    merge_paralelo(origen, mitad, origen + mitad, n - mitad, destino, pool);
+}
+
+template <typename T>
+void ordenar_paralelo(std::vector<T>& datos, std::vector<T>& auxiliar, PoolHilos& pool) {
+    if (auxiliar.size() < datos.size()) auxiliar.resize(datos.size());
+    ordenar_paralelo_rango(datos.data(), auxiliar.data(), (int)datos.size(), false, pool);
+}
+
+// Ordenamiento local usado por todos los modos: multihilo si hay pool, si no
+// secuencial. Ordena n elementos en el lugar (por ejemplo el bloque del
+// proceso dentro de la ventana del nodo) y devuelve dónde quedó el
+// resultado: en "datos" o en el buffer auxiliar
+template <typename T>
+T* ordenar_local(T* datos, int n, std::vector<T>& auxiliar) {
+    // Bytes: leer la entrada y escribir la salida una vez (cada pasada del
+    // radix o del merge recorre esto de nuevo)
+    MedicionHardware medicion("ordenamiento_local", n, 2.0 * n * sizeof(T), pool_ordenamiento != nullptr);
+    if (auxiliar.size() < (size_t)n) auxiliar.resize(n);
+    if (pool_ordenamiento != nullptr) {
+        ordenar_paralelo_rango(datos, auxiliar.data(), n, false, *pool_ordenamiento);
+        return datos;
+    }
+    return ordenar_rango(datos, auxiliar.data(), n) ? auxiliar.data() : datos;
+}
+
+// Sobre un vector: si el resultado quedó en el buffer auxiliar basta con
+// intercambiar los vectores
+template <typename T>
+void ordenar_local(std::vector<T>& datos, std::vector<T>& auxiliar) {
+    if (ordenar_local(datos.data(), (int)datos.size(), auxiliar) != datos.data()) datos.swap(auxiliar);
+}
+
+// Reparte en bloques iguales los datos del proceso 0 y devuelve el bloque de
+// este proceso. Con MEMORIA_NODO=1 cada nodo recibe los bloques de sus
+// procesos una sola vez en copia_nodo y cada proceso ordena el suyo ahí mismo,
+// sin copia propia (copia_nodo debe vivir hasta terminar el merge); si no, el
+// bloque llega a mi_porcion con MPI_Scatter
+int* repartir_porcion(const std::vector<int>& datos_completos, int elementos_por_proceso,
+                      std::vector<int>& mi_porcion, VentanaNodo& copia_nodo) {
+    if (memoria_nodo_activa()) {
+        return repartir_en_nodo(copia_nodo, datos_completos.data(), elementos_por_proceso, MPI_INT);
+    }
+    mi_porcion.resize(elementos_por_proceso);
+    MPI_Scatter(datos_completos.data(), elementos_por_proceso, MPI_INT,
+                mi_porcion.data(), elementos_por_proceso, MPI_INT, 0, MPI_COMM_WORLD);
+    return mi_porcion.data();
+}
+
+// Fase de merge en árbol binomial: en el nivel "paso" cada proceso con
+// rango % (2*paso) == 0 recibe la porción de rango + paso y las combina,
+// de modo que todos los pares de un nivel trabajan a la vez (log p niveles).
+// Como los tamaños de cada nivel se conocen de antemano, el receptor publica
+// todas sus recepciones al inicio: los datos de un nivel llegan mientras se
+// hace el merge del nivel anterior. Devuelve el arreglo completo en el proceso 0
+std::vector<int> merge_en_arbol(const int* mi_porcion, int elementos_por_proceso, int mi_rango,
+                                int numero_procesos) {
+    // Niveles en los que este proceso recibe y tamaño de cada porción recibida
+    std::vector<int> pasos_recepcion, tamanos_recepcion;
+    int tamano_final = elementos_por_proceso;
+    int paso_envio = 0;
+    for (int paso = 1; paso < numero_procesos; paso *= 2) {
+        if (mi_rango % (2 * paso) != 0) {
+            paso_envio = paso;
+            break;
+        }
+        int proceso_fuente = mi_rango + paso;
+        if (proceso_fuente < numero_procesos) {
+            int tamano = std::min(paso, numero_procesos - proceso_fuente) * elementos_por_proceso;
+            pasos_recepcion.push_back(paso);
+            tamanos_recepcion.push_back(tamano);
+            tamano_final += tamano;
+        }
+    }
+
+    // Publicar todas las recepciones antes de empezar a combinar (los buffers
+    // de recepción salen del pool y se reciclan en la próxima ejecución)
+    int niveles = pasos_recepcion.size();
+    std::vector<std::unique_ptr<BufferPool<int>>> porciones_recibidas(niveles);
+    std::vector<MPI_Request> solicitudes(niveles);
+    for (int nivel = 0; nivel < niveles; nivel++) {
+        porciones_recibidas[nivel].reset(new BufferPool<int>(tamanos_recepcion[nivel]));
+        MPI_Irecv(porciones_recibidas[nivel]->data(), tamanos_recepcion[nivel], MPI_INT,
+                  mi_rango + pasos_recepcion[nivel], 0, MPI_COMM_WORLD, &solicitudes[nivel]);
+    }
+
+    // Cada nivel combina lo acumulado con la porción recibida en uno de dos
+    // buffers del pool que se alternan. El primer nivel lee la porción propia
+    // sin copiarla y el último del proceso 0 escribe directo en el resultado,
+    // así que ahí los buffers alternos solo guardan hasta el penúltimo nivel
     std::vector<int> resultado;
-    resultado.reserve(vec1.size() + vec2.size());
+    int tamano_alternos = tamano_final;
+    if (mi_rango == 0) {
+        resultado.resize(tamano_final);
+        if (niveles > 0) tamano_alternos -= tamanos_recepcion[niveles - 1];
+    }
+    BufferPool<int> actual(niveles > 0 ? tamano_alternos : 0), siguiente(niveles > 0 ? tamano_alternos : 0);
+    const int* acumulado = mi_porcion;
+    int tamano_actual = elementos_por_proceso;
 
-    size_t i = 0, j = 0;
-    while (i < vec1.size() && j < vec2.size()) {
-        if (vec1[i] <= vec2[j]) {
-            resultado.push_back(vec1[i]);
-            i++;
+    for (int nivel = 0; nivel < niveles; nivel++) {
+        MPI_Wait(&solicitudes[nivel], MPI_STATUS_IGNORE);
+        int* salida = (mi_rango == 0 && nivel == niveles - 1) ? resultado.data() : siguiente.data();
+        combinar_secuencias<int>(acumulado, tamano_actual, porciones_recibidas[nivel]->data(),
+                                 tamanos_recepcion[nivel], salida);
+        tamano_actual += tamanos_recepcion[nivel];
+        actual.swap(siguiente);
+        acumulado = salida;
+        porciones_recibidas[nivel].reset();
+    }
+
+    if (mi_rango != 0) {
+        MPI_Send(acumulado, tamano_actual, MPI_INT, mi_rango - paso_envio, 0, MPI_COMM_WORLD);
+        return std::vector<int>();
+    }
+    if (niveles == 0) resultado.assign(mi_porcion, mi_porcion + elementos_por_proceso);
+    return resultado;
+}
+
+// Modos de ejecución (primer argumento del programa)
+const int MODO_ARBOL = 0;       // merge en árbol binomial (por defecto)
+const int MODO_SECUENCIAL = 1;  // merge progresivo en el proceso 0
+const int MODO_MUESTREO = 2;    // sample sort (PSRS), resultado distribuido
+const int MODO_LOCAL = 3;       // comparación de ordenamientos locales en el proceso 0
+const int MODO_K_VIAS = 4;      // recolección en el proceso 0 con merge k-vías
+const int MODO_EXTERNO = 5;     // ordenamiento externo de un archivo binario con MPI-IO
+const int MODO_CONTEO = 6;      // counting sort distribuido para dominios de claves pequeños
+const int MODO_REGISTROS = 7;   // sample sort de registros clave/carga con tipos derivados
+
+// Árbol de perdedores (torneo) sobre k secuencias: cada nodo interno guarda la
+// secuencia que perdió la comparación en ese nodo y el ganador queda aparte.
+// Después de consumir la cabeza del ganador basta con recorrer el camino de su
+// hoja a la raíz, una comparación por nivel (log2 k), sin mover datos.
+// "menor(a, b)" indica si la cabeza actual de la secuencia a va antes que la de b
+template <typename Menor>
+struct ArbolPerdedores {
+    int k;
+    Menor menor;
+    std::vector<int> perdedores;  // nodos internos 1..k-1 (hojas implícitas k..2k-1)
+    int ganador;
+
+    ArbolPerdedores(int k_secuencias, Menor comparador)
+        : k(k_secuencias), menor(comparador), perdedores(std::max(k_secuencias, 1)), ganador(0) {
+        std::vector<int> ganadores(2 * k);
+        for (int r = 0; r < k; r++) ganadores[k + r] = r;
+        for (int nodo = k - 1; nodo >= 1; nodo--) {
+            int a = ganadores[2 * nodo], b = ganadores[2 * nodo + 1];
+            if (menor(b, a)) std::swap(a, b);
+            ganadores[nodo] = a;
+            perdedores[nodo] = b;
+        }
+        if (k > 1) ganador = ganadores[1];
+    }
+
+    // Volver a jugar el camino del ganador tras cambiar su cabeza
+    void actualizar() {
+        int actual = ganador;
+        for (int nodo = (k + actual) / 2; nodo >= 1; nodo /= 2) {
+            if (menor(perdedores[nodo], actual)) std::swap(perdedores[nodo], actual);
+        }
+        ganador = actual;
+    }
+};
+
+// Comparación de cabezas para el árbol de perdedores: una secuencia agotada va
+// siempre al final y los empates se resuelven por índice (merge estable)
+template <typename TipoClave>
+struct CabezasSecuencias {
+    const std::vector<TipoClave>* cabeza;
+    const std::vector<char>* agotada;
+
+    bool operator()(int a, int b) const {
+        bool agotada_a = (*agotada)[a], agotada_b = (*agotada)[b];
+        if (agotada_a != agotada_b) return agotada_b;
+        if (agotada_a) return a < b;
+        return (*cabeza)[a] < (*cabeza)[b] || ((*cabeza)[a] == (*cabeza)[b] && a < b);
+    }
+};
+
+// Merge de k secuencias ordenadas contiguas en "entrada" (la secuencia r ocupa
+// [inicios[r], inicios[r] + tamanos[r])) hacia "salida" con un árbol de
+// perdedores. El árbol compara solo las claves de las cabezas
+template <typename T, typename Clave = ClaveIdentidad>
+void merge_k_vias(const std::vector<T>& entrada, const std::vector<int>& inicios,
+                  const std::vector<int>& tamanos, std::vector<T>& salida, Clave clave = Clave()) {
+    typedef typename std::decay<decltype(clave(entrada[0]))>::type TipoClave;
+    int k = tamanos.size();
+    std::vector<int> posicion(inicios);
+    std::vector<TipoClave> cabeza(k);
+    std::vector<char> agotada(k);
+    for (int r = 0; r < k; r++) {
+        agotada[r] = (tamanos[r] == 0);
+        if (!agotada[r]) cabeza[r] = clave(entrada[posicion[r]]);
+    }
+
+    CabezasSecuencias<TipoClave> menor = {&cabeza, &agotada};
+    ArbolPerdedores<CabezasSecuencias<TipoClave> > arbol(k, menor);
+
+    int total = salida.size();
+    for (int i = 0; i < total; i++) {
+        int r = arbol.ganador;
+        salida[i] = entrada[posicion[r]];
+        if (++posicion[r] < inicios[r] + tamanos[r]) {
+            cabeza[r] = clave(entrada[posicion[r]]);
         } else {
-            resultado.push_back(vec2[j]);
-            j++;
+            agotada[r] = 1;
         }
+        arbol.actualizar();
     }
+}
 
-    while (i < vec1.size()) {
-        resultado.push_back(vec1[i]);
-        i++;
+// Recolección en el proceso 0 con un único merge k-vías (árbol de perdedores)
+// en lugar de p - 1 merges de dos vectores. Cada proceso envía su porción en
+// bloques con MPI_Isend; el proceso 0 publica un MPI_Irecv por bloque y empieza
+// a combinar con los primeros bloques de cada secuencia, esperando un bloque
+// solo cuando el merge llega a él. Cada elemento se escribe una sola vez
+std::vector<int> recolectar_k_vias(const int* mi_porcion, int elementos_por_proceso, int mi_rango,
+                                   int numero_procesos) {
+    const int ELEMENTOS_POR_BLOQUE = 65536;
+    int bloques = (elementos_por_proceso + ELEMENTOS_POR_BLOQUE - 1) / ELEMENTOS_POR_BLOQUE;
+
+    if (mi_rango != 0) {
+        std::vector<MPI_Request> solicitudes(bloques);
+        for (int bloque = 0; bloque < bloques; bloque++) {
+            int inicio = bloque * ELEMENTOS_POR_BLOQUE;
+            MPI_Isend(mi_porcion + inicio, std::min(ELEMENTOS_POR_BLOQUE, elementos_por_proceso - inicio),
+                      MPI_INT, 0, 0, MPI_COMM_WORLD, &solicitudes[bloque]);
+        }
+        MPI_Waitall(bloques, solicitudes.data(), MPI_STATUSES_IGNORE);
+        return std::vector<int>();
     }
 
-    while (j < vec2.size()) {
-        resultado.push_back(vec2[j]);
-        j++;
+    // La secuencia 0 es la porción propia; las demás llegan por bloques
+    int k = numero_procesos;
+    std::vector<int> recibidos((size_t)(k - 1) * elementos_por_proceso);
+    std::vector<const int*> secuencia(k);
+    std::vector<MPI_Request> solicitudes((size_t)k * bloques, MPI_REQUEST_NULL);
+    secuencia[0] = mi_porcion;
+    for (int r = 1; r < k; r++) {
+        int* destino = recibidos.data() + (size_t)(r - 1) * elementos_por_proceso;
+        secuencia[r] = destino;
+        for (int bloque = 0; bloque < bloques; bloque++) {
+            int inicio = bloque * ELEMENTOS_POR_BLOQUE;
+            MPI_Irecv(destino + inicio, std::min(ELEMENTOS_POR_BLOQUE, elementos_por_proceso - inicio),
+                      MPI_INT, r, 0, MPI_COMM_WORLD, &solicitudes[(size_t)r * bloques + bloque]);
+        }
+    }
+
+    std::vector<int> posicion(k, 0), cabeza(k);
+    std::vector<char> agotada(k);
+    for (int r = 0; r < k; r++) {
+        agotada[r] = (elementos_por_proceso == 0);
+        if (!agotada[r]) {
+            MPI_Wait(&solicitudes[(size_t)r * bloques], MPI_STATUS_IGNORE);
+            cabeza[r] = secuencia[r][0];
+        }
+    }
+
+    CabezasSecuencias<int> menor = {&cabeza, &agotada};
+    ArbolPerdedores<CabezasSecuencias<int> > arbol(k, menor);
+
+    std::vector<int> resultado((size_t)k * elementos_por_proceso);
+    for (size_t i = 0; i < resultado.size(); i++) {
+        int r = arbol.ganador;
+        resultado[i] = cabeza[r];
+
+        int siguiente = ++posicion[r];
+        if (siguiente == elementos_por_proceso) {
+            agotada[r] = 1;
+        } else {
+            // Al cruzar a un bloque nuevo hay que esperar a que haya llegado
+            if (siguiente % ELEMENTOS_POR_BLOQUE == 0) {
+                MPI_Wait(&solicitudes[(size_t)r * bloques + siguiente / ELEMENTOS_POR_BLOQUE], MPI_STATUS_IGNORE);
+            }
+            cabeza[r] = secuencia[r][siguiente];
+        }
+        arbol.actualizar();
     }
 
     return resultado;
 }
 
-int main(int argc, char* argv[]) {
-    int numero_procesos, mi_rango;
-    MPI_Init(&argc, &argv);
-    MPI_Comm_size(MPI_COMM_WORLD, &numero_procesos);
-    MPI_Comm_rank(MPI_COMM_WORLD, &mi_rango);
+// Ordenamiento por muestreo regular (PSRS). Cada proceso genera y ordena su
+// porción, elige p muestras regulares, las muestras de todos definen p - 1
+// pivotes, los datos se intercambian una sola vez con MPI_Alltoallv y cada
+// proceso combina las p secuencias que recibe. El resultado queda ordenado
+// globalmente pero distribuido: nunca pasa por un único proceso
+void ordenar_por_muestreo(int n_total, int mi_rango, int numero_procesos) {
+    int p = numero_procesos;
+    int elementos_por_proceso = n_total / p;
 
-    int n_total;
-    std::vector<int> datos_completos, mi_porcion, resultado_final;
+    // Cada proceso genera su propia porción (no hay Scatter desde el proceso 0)
+    TemporizadorFase temporizador_entrada(FASE_ENTRADA);
+    std::vector<int> mi_porcion(elementos_por_proceso);
+    std::random_device rd;
+    std::mt19937 gen(rd() + mi_rango);
+    std::uniform_int_distribution<> dis(1, 1000);
+    long long suma_local = 0;
+    for (int i = 0; i < elementos_por_proceso; i++) {
+        mi_porcion[i] = dis(gen);
+        suma_local += mi_porcion[i];
+    }
+    temporizador_entrada.detener();
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double inicio = MPI_Wtime();
+
+    // 1. Ordenamiento local
+    TemporizadorFase temporizador_calculo(FASE_CALCULO);
+    std::vector<int> auxiliar(elementos_por_proceso);
+    ordenar_local(mi_porcion, auxiliar);
+    double fin_ordenamiento = MPI_Wtime();
+
+    // 2. Muestras regulares y pivotes (todos los procesos los calculan igual)
+    std::vector<int> muestras_locales(p, 0), muestras(p * p);
+    for (int i = 0; i < p && elementos_por_proceso > 0; i++) {
+        muestras_locales[i] = mi_porcion[(long long)i * elementos_por_proceso / p];
+    }
+    temporizador_calculo.detener();
+    {
+        TemporizadorFase temporizador(FASE_DISTRIBUCION);
+        MPI_Allgather(muestras_locales.data(), p, MPI_INT, muestras.data(), p, MPI_INT, MPI_COMM_WORLD);
+    }
+    TemporizadorFase temporizador_particion(FASE_CALCULO);
+    std::sort(muestras.begin(), muestras.end());
+
+    std::vector<int> pivotes(p - 1);
+    for (int i = 1; i < p; i++) {
+        pivotes[i - 1] = muestras[i * p + p / 2 - 1];
+    }
+
+    // 3. Partir la porción ordenada según los pivotes
+    std::vector<int> cuentas_envio(p), desplazamientos_envio(p);
+    int inicio_particion = 0;
+    for (int destino = 0; destino < p; destino++) {
+        int fin_particion = (destino < p - 1)
+            ? std::upper_bound(mi_porcion.begin(), mi_porcion.end(), pivotes[destino]) - mi_porcion.begin()
+            : elementos_por_proceso;
+        fin_particion = std::max(fin_particion, inicio_particion);
+        desplazamientos_envio[destino] = inicio_particion;
+        cuentas_envio[destino] = fin_particion - inicio_particion;
+        inicio_particion = fin_particion;
+    }
+    double fin_muestreo = MPI_Wtime();
+    temporizador_particion.detener();
+
+    // 4. Intercambio único de datos
+    TemporizadorFase temporizador_intercambio(FASE_DISTRIBUCION);
+    std::vector<int> cuentas_recepcion(p), desplazamientos_recepcion(p);
+    MPI_Alltoall(cuentas_envio.data(), 1, MPI_INT, cuentas_recepcion.data(), 1, MPI_INT, MPI_COMM_WORLD);
+    int total_recibido = 0;
+    for (int fuente = 0; fuente < p; fuente++) {
+        desplazamientos_recepcion[fuente] = total_recibido;
+        total_recibido += cuentas_recepcion[fuente];
+    }
+
+    std::vector<int> recibidos(total_recibido);
+    MPI_Alltoallv(mi_porcion.data(), cuentas_envio.data(), desplazamientos_envio.data(), MPI_INT,
+                  recibidos.data(), cuentas_recepcion.data(), desplazamientos_recepcion.data(), MPI_INT,
+                  MPI_COMM_WORLD);
+    double fin_intercambio = MPI_Wtime();
+    temporizador_intercambio.detener();
+
+    // 5. Merge de las p secuencias recibidas
+    std::vector<int> mi_particion(total_recibido);
+    {
+        TemporizadorFase temporizador(FASE_CALCULO);
+        merge_k_vias(recibidos, desplazamientos_recepcion, cuentas_recepcion, mi_particion);
+    }
+    double fin_merge = MPI_Wtime();
+
+    // Verificación distribuida: orden local, frontera con los procesos
+    // anteriores (MPI_Exscan con el máximo) y conservación de cantidad y suma
+    int ordenado_local = std::is_sorted(mi_particion.begin(), mi_particion.end());
+    int mi_maximo = mi_particion.empty() ? INT_MIN : mi_particion.back();
+    int maximo_anterior = INT_MIN;
+    MPI_Exscan(&mi_maximo, &maximo_anterior, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    if (mi_rango == 0) maximo_anterior = INT_MIN;
+    if (!mi_particion.empty() && mi_particion.front() < maximo_anterior) ordenado_local = 0;
+
+    int ordenado_global;
+    MPI_Allreduce(&ordenado_local, &ordenado_global, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+
+    long long suma_particion = 0;
+    for (int x : mi_particion) suma_particion += x;
+    long long sumas_locales[2] = {suma_local, suma_particion}, sumas_globales[2];
+    MPI_Allreduce(sumas_locales, sumas_globales, 2, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+
+    // Balance de carga: tamaños de partición
+    std::vector<int> tamanos_particion(p);
+    MPI_Gather(&total_recibido, 1, MPI_INT, tamanos_particion.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+    double tiempos[4] = {fin_ordenamiento - inicio, fin_muestreo - fin_ordenamiento,
+                         fin_intercambio - fin_muestreo, fin_merge - fin_intercambio};
+    double tiempos_max[4];
+    MPI_Reduce(tiempos, tiempos_max, 4, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    // Mostrar particiones si n es pequeño
+    if (n_total <= 50) {
+        for (int proc = 0; proc < p; proc++) {
+            if (mi_rango == proc) {
+                std::cout << "Proceso " << mi_rango << " partición: ";
+                for (int x : mi_particion) {
+                    std::cout << x << " ";
+                }
+                std::cout << std::endl;
+            }
+            MPI_Barrier(MPI_COMM_WORLD);
+        }
+    }
 
-    // El proceso 0 lee n y genera/distribuye los datos
     if (mi_rango == 0) {
-        std::cout << "=== MERGE SORT PARALELO CON MPI ===" << std::endl;
-        std::cout << "Ingrese el número total de elementos (n): ";
-        std::cin >> n_total;
+        TemporizadorFase temporizador(FASE_SALIDA);
+        int minimo = *std::min_element(tamanos_particion.begin(), tamanos_particion.end());
+        int maximo = *std::max_element(tamanos_particion.begin(), tamanos_particion.end());
+        double promedio = (double)n_total / p;
 
-        // Verificar que n es divisible por el número de procesos
-        if (n_total % numero_procesos != 0) {
-            std::cout << "Ajustando n para que sea divisible por " << numero_procesos << " procesos" << std::endl;
-            n_total = (n_total / numero_procesos) * numero_procesos;
-            std::cout << "Nuevo n: " << n_total << std::endl;
+        std::cout << "\n=== RESULTADO FINAL (SAMPLE SORT) ===" << std::endl;
+        std::cout << "¿Está ordenado globalmente? " << (ordenado_global ? "✅ SÍ" : "❌ NO") << std::endl;
+        std::cout << "¿Se conservaron los datos? "
+                  << (sumas_globales[0] == sumas_globales[1] ? "✅ SÍ" : "❌ NO") << std::endl;
+
+        std::cout << "\nBalance de carga de las particiones:" << std::endl;
+        std::cout << "  Mínimo: " << minimo << ", promedio: " << std::fixed << std::setprecision(1)
+                  << promedio << ", máximo: " << maximo << std::endl;
+        std::cout << "  Desbalance (máx./promedio): " << std::setprecision(3)
+                  << (promedio > 0 ? maximo / promedio : 0.0) << std::endl;
+        if (p <= 16) {
+            std::cout << "  Tamaños:";
+            for (int t : tamanos_particion) std::cout << " " << t;
+            std::cout << std::endl;
+        }
+
+        std::cout << std::setprecision(6);
+        std::cout << "\nTiempos (máx. entre procesos):" << std::endl;
+        std::cout << "  Ordenamiento local: " << tiempos_max[0] << " segundos" << std::endl;
+        std::cout << "  Muestreo y pivotes: " << tiempos_max[1] << " segundos" << std::endl;
+        std::cout << "  Intercambio:        " << tiempos_max[2] << " segundos" << std::endl;
+        std::cout << "  Merge k-vías:       " << tiempos_max[3] << " segundos" << std::endl;
+    }
+}
+
+// ==============================================
+// COUNTING SORT DISTRIBUIDO (dominio de claves pequeño)
+// ==============================================
+
+// Dominio máximo (cantidad de claves distintas posibles) que se acepta para
+// el conteo: los contadores de todo el dominio se combinan con MPI_Allreduce
+const long long DOMINIO_MAXIMO_CONTEO = 1LL << 26;
+
+// Counting sort distribuido: cada proceso cuenta sus claves, los conteos se
+// suman con MPI_Allreduce y cada proceso escribe directamente su tramo
+// [r*n/p, (r+1)*n/p) del orden global a partir de los conteos acumulados.
+// Costo O(n/p + K) y un solo mensaje colectivo de K contadores. Si clave_minima
+// > clave_maxima el rango de claves se detecta con un MPI_Allreduce
+void ordenar_por_conteo(int n_total, int mi_rango, int numero_procesos, int clave_minima, int clave_maxima) {
+    int p = numero_procesos;
+    int elementos_por_proceso = n_total / p;
+
+    // Cada proceso genera su propia porción, como en el modo muestreo
+    TemporizadorFase temporizador_entrada(FASE_ENTRADA);
+    std::vector<int> mi_porcion(elementos_por_proceso);
+    std::random_device rd;
+    std::mt19937 gen(rd() + mi_rango);
+    std::uniform_int_distribution<> dis(1, 1000);
+    long long suma_local = 0;
+    for (int i = 0; i < elementos_por_proceso; i++) {
+        mi_porcion[i] = dis(gen);
+        suma_local += mi_porcion[i];
+    }
+    temporizador_entrada.detener();
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double inicio = MPI_Wtime();
+
+    // 1. Rango de claves: dado por argumento o detectado (mínimo y máximo en
+    // una sola reducción usando el máximo de -mínimo)
+    bool rango_detectado = clave_minima > clave_maxima;
+    if (rango_detectado) {
+        TemporizadorFase temporizador(FASE_REDUCCION);
+        long long extremos_locales[2] = {-(long long)INT_MAX, (long long)INT_MIN}, extremos[2];
+        for (int x : mi_porcion) {
+            extremos_locales[0] = std::max(extremos_locales[0], -(long long)x);
+            extremos_locales[1] = std::max(extremos_locales[1], (long long)x);
+        }
+        MPI_Allreduce(extremos_locales, extremos, 2, MPI_LONG_LONG, MPI_MAX, MPI_COMM_WORLD);
+        clave_minima = (int)-extremos[0];
+        clave_maxima = (int)extremos[1];
+        if (clave_minima > clave_maxima) clave_maxima = clave_minima;  // n = 0
+    }
+    long long dominio = (long long)clave_maxima - clave_minima + 1;
+    if (dominio > DOMINIO_MAXIMO_CONTEO) {
+        if (mi_rango == 0) {
+            std::cout << "❌ El dominio de claves (" << dominio << " valores) es demasiado grande para "
+                      << "el conteo; use el modo muestreo" << std::endl;
+        }
+        return;
+    }
+    double fin_rango = MPI_Wtime();
+
+    // 2. Conteo local; las claves fuera del rango indicado se cuentan aparte
+    int K = (int)dominio;
+    TemporizadorFase temporizador_conteo(FASE_CALCULO);
+    std::vector<long long> conteos_locales(K, 0), conteos(K);
+    long long fuera_de_rango_local = 0;
+    for (int x : mi_porcion) {
+        if (x < clave_minima || x > clave_maxima) {
+            fuera_de_rango_local++;
+        } else {
+            conteos_locales[x - clave_minima]++;
+        }
+    }
+    double fin_conteo = MPI_Wtime();
+    temporizador_conteo.detener();
+
+    // 3. Conteos globales (el único intercambio de datos del algoritmo)
+    TemporizadorFase temporizador_reduccion(FASE_REDUCCION);
+    MPI_Allreduce(conteos_locales.data(), conteos.data(), K, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+    long long fuera_de_rango;
+    MPI_Allreduce(&fuera_de_rango_local, &fuera_de_rango, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+    double fin_reduccion = MPI_Wtime();
+    temporizador_reduccion.detener();
+
+    if (fuera_de_rango > 0) {
+        if (mi_rango == 0) {
+            std::cout << "❌ " << fuera_de_rango << " claves fuera del rango [" << clave_minima << ", "
+                      << clave_maxima << "]" << std::endl;
+        }
+        return;
+    }
+
+    // 4. Escritura del tramo propio: se recorren los conteos acumulados y se
+    // copia la parte de cada corrida de claves iguales que cae en el tramo
+    TemporizadorFase temporizador_escritura(FASE_CALCULO);
+    long long inicio_tramo = (long long)n_total * mi_rango / p;
+    long long fin_tramo = (long long)n_total * (mi_rango + 1) / p;
+    std::vector<int> mi_particion(fin_tramo - inicio_tramo);
+    long long acumulado = 0;
+    for (int clave = 0; clave < K && acumulado < fin_tramo; clave++) {
+        long long desde = std::max(acumulado, inicio_tramo);
+        long long hasta = std::min(acumulado + conteos[clave], fin_tramo);
+        if (desde < hasta) {
+            std::fill(mi_particion.begin() + (desde - inicio_tramo), mi_particion.begin() + (hasta - inicio_tramo),
+                      clave_minima + clave);
+        }
+        acumulado += conteos[clave];
+    }
+    double fin_escritura = MPI_Wtime();
+    temporizador_escritura.detener();
+
+    // Verificación distribuida (igual que en el modo muestreo): orden local,
+    // frontera con los procesos anteriores y conservación de la suma
+    int ordenado_local = std::is_sorted(mi_particion.begin(), mi_particion.end());
+    int mi_maximo = mi_particion.empty() ? INT_MIN : mi_particion.back();
+    int maximo_anterior = INT_MIN;
+    MPI_Exscan(&mi_maximo, &maximo_anterior, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    if (mi_rango == 0) maximo_anterior = INT_MIN;
+    if (!mi_particion.empty() && mi_particion.front() < maximo_anterior) ordenado_local = 0;
+
+    int ordenado_global;
+    MPI_Allreduce(&ordenado_local, &ordenado_global, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+
+    long long suma_particion = 0;
+    for (int x : mi_particion) suma_particion += x;
+    long long sumas_locales[2] = {suma_local, suma_particion}, sumas_globales[2];
+    MPI_Allreduce(sumas_locales, sumas_globales, 2, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+
+    double tiempos[4] = {fin_rango - inicio, fin_conteo - fin_rango,
+                         fin_reduccion - fin_conteo, fin_escritura - fin_reduccion};
+    double tiempos_max[4];
+    MPI_Reduce(tiempos, tiempos_max, 4, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    // Mostrar particiones si n es pequeño
+    if (n_total <= 50) {
+        for (int proc = 0; proc < p; proc++) {
+            if (mi_rango == proc) {
+                std::cout << "Proceso " << mi_rango << " partición: ";
+                for (int x : mi_particion) {
+                    std::cout << x << " ";
+                }
+                std::cout << std::endl;
+            }
+            MPI_Barrier(MPI_COMM_WORLD);
+        }
+    }
+
+    if (mi_rango == 0) {
+        TemporizadorFase temporizador(FASE_SALIDA);
+        std::cout << "\n=== RESULTADO FINAL (COUNTING SORT) ===" << std::endl;
+        std::cout << "Rango de claves " << (rango_detectado ? "detectado" : "indicado") << ": ["
+                  << clave_minima << ", " << clave_maxima << "] (K = " << K << ")" << std::endl;
+        std::cout << "¿Está ordenado globalmente? " << (ordenado_global ? "✅ SÍ" : "❌ NO") << std::endl;
+        std::cout << "¿Se conservaron los datos? "
+                  << (sumas_globales[0] == sumas_globales[1] ? "✅ SÍ" : "❌ NO") << std::endl;
+        std::cout << "Bytes reducidos por proceso: " << (long long)K * sizeof(long long) << std::endl;
+
+        std::cout << std::fixed << std::setprecision(6);
+        std::cout << "\nTiempos (máx. entre procesos):" << std::endl;
+        std::cout << "  Rango de claves:     " << tiempos_max[0] << " segundos" << std::endl;
+        std::cout << "  Conteo local:        " << tiempos_max[1] << " segundos" << std::endl;
+        std::cout << "  MPI_Allreduce:       " << tiempos_max[2] << " segundos" << std::endl;
+        std::cout << "  Escritura del tramo: " << tiempos_max[3] << " segundos" << std::endl;
+    }
+}
+
+// ==============================================
+// REGISTROS CLAVE/CARGA (tipos derivados de MPI)
+// ==============================================
+
+// Registro de ejemplo: clave entera más 52 bytes de carga útil
+struct Registro {
+    int clave;
+    int origen;           // proceso que generó el registro
+    long long secuencia;  // posición del registro en su proceso de origen
+    double carga[5];
+};
+
+// Extracción de la clave de un Registro
+struct ClaveRegistro {
+    int operator()(const Registro& r) const { return r.clave; }
+};
+
+// Tipo derivado de MPI que describe un Registro campo por campo; se ajusta su
+// extensión a sizeof(Registro) para que los arreglos viajen sin serializar
+MPI_Datatype crear_tipo_registro() {
+    int longitudes[4] = {1, 1, 1, 5};
+    MPI_Aint desplazamientos[4] = {offsetof(Registro, clave), offsetof(Registro, origen),
+                                   offsetof(Registro, secuencia), offsetof(Registro, carga)};
+    MPI_Datatype tipos[4] = {MPI_INT, MPI_INT, MPI_LONG_LONG, MPI_DOUBLE};
+
+    MPI_Datatype tipo_struct, tipo_registro;
+    MPI_Type_create_struct(4, longitudes, desplazamientos, tipos, &tipo_struct);
+    MPI_Type_create_resized(tipo_struct, 0, sizeof(Registro), &tipo_registro);
+    MPI_Type_commit(&tipo_registro);
+    MPI_Type_free(&tipo_struct);
+    return tipo_registro;
+}
+
+// Par (clave, índice) del modo clave-índice: se ordenan los pares, que son
+// mucho más chicos que los registros, y la carga se permuta una sola vez
+template <typename TipoClave>
+struct ClaveIndice {
+    TipoClave clave;
+    int indice;
+};
+
+struct ClaveDePar {
+    template <typename TipoClave>
+    const TipoClave& operator()(const ClaveIndice<TipoClave>& par) const { return par.clave; }
+};
+
+// Ordena registros por clave construyendo pares (clave, índice), ordenando los
+// pares y moviendo cada registro una sola vez a su posición final
+template <typename T, typename Clave>
+void ordenar_por_clave_indice(std::vector<T>& datos, std::vector<T>& auxiliar, Clave clave) {
+    typedef typename std::decay<decltype(clave(datos[0]))>::type TipoClave;
+    int n = datos.size();
+    std::vector<ClaveIndice<TipoClave> > pares(n), pares_auxiliar(n);
+    for (int i = 0; i < n; i++) {
+        pares[i].clave = clave(datos[i]);
+        pares[i].indice = i;
+    }
+    if (merge_sort_ascendente(pares.data(), pares_auxiliar.data(), n, ClaveDePar())) pares.swap(pares_auxiliar);
+
+    auxiliar.resize(n);
+    for (int i = 0; i < n; i++) auxiliar[i] = datos[pares[i].indice];
+    datos.swap(auxiliar);
+}
+
+// Bytes escritos por merge_sort_ascendente sobre n elementos de "tamano" bytes:
+// la pasada de inserción más una por cada duplicación del ancho de los tramos
+long long bytes_merge_sort(long long n, long long tamano) {
+    long long pasadas = 1;
+    for (long long ancho = TAMANO_TRAMO_INSERCION; ancho < n; ancho *= 2) pasadas++;
+    return n * tamano * pasadas;
+}
+
+// Sample sort (PSRS) genérico sobre registros de tipo T ordenados por
+// clave(registro). Los registros viajan con el tipo derivado "tipo" (muestras
+// con MPI_Allgather, particiones con MPI_Alltoallv). Si clave_indice, tanto el
+// ordenamiento local como el merge k-vías trabajan sobre pares (clave, índice)
+// y cada registro se copia una sola vez al final de cada etapa.
+// tiempos: ordenamiento local, muestreo, intercambio y merge; bytes_locales:
+// bytes escritos en memoria por el ordenamiento local y el merge
+template <typename T, typename Clave>
+std::vector<T> ordenar_registros_por_muestreo(std::vector<T>& mi_porcion, MPI_Datatype tipo, Clave clave,
+                                              bool clave_indice, int numero_procesos,
+                                              double tiempos[4], long long& bytes_locales) {
+    typedef typename std::decay<decltype(clave(mi_porcion[0]))>::type TipoClave;
+    int p = numero_procesos;
+    int n_local = mi_porcion.size();
+    long long tamano_par = sizeof(ClaveIndice<TipoClave>);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double inicio = MPI_Wtime();
+
+    // 1. Ordenamiento local
+    TemporizadorFase temporizador_calculo(FASE_CALCULO);
+    std::vector<T> auxiliar(n_local);
+    if (clave_indice) {
+        ordenar_por_clave_indice(mi_porcion, auxiliar, clave);
+        bytes_locales = bytes_merge_sort(n_local, tamano_par) + (long long)n_local * sizeof(T);
+    } else {
+        if (merge_sort_ascendente(mi_porcion.data(), auxiliar.data(), n_local, clave)) mi_porcion.swap(auxiliar);
+        bytes_locales = bytes_merge_sort(n_local, sizeof(T));
+    }
+    double fin_ordenamiento = MPI_Wtime();
+
+    // 2. Muestras regulares (registros completos) y pivotes
+    std::vector<T> muestras_locales(p), muestras(p * p);
+    for (int i = 0; i < p; i++) {
+        if (n_local > 0) muestras_locales[i] = mi_porcion[(long long)i * n_local / p];
+    }
+    temporizador_calculo.detener();
+
+    // Las muestras de procesos sin datos no se consideran
+    std::vector<int> cantidades(p);
+    {
+        TemporizadorFase temporizador(FASE_DISTRIBUCION);
+        MPI_Allgather(muestras_locales.data(), p, tipo, muestras.data(), p, tipo, MPI_COMM_WORLD);
+        MPI_Allgather(&n_local, 1, MPI_INT, cantidades.data(), 1, MPI_INT, MPI_COMM_WORLD);
+    }
+    TemporizadorFase temporizador_particion(FASE_CALCULO);
+    std::vector<TipoClave> claves_muestra;
+    for (int r = 0; r < p; r++) {
+        for (int i = 0; i < p && cantidades[r] > 0; i++) claves_muestra.push_back(clave(muestras[r * p + i]));
+    }
+    std::sort(claves_muestra.begin(), claves_muestra.end());
+
+    std::vector<TipoClave> pivotes(p - 1);
+    for (int i = 1; i < p && !claves_muestra.empty(); i++) {
+        pivotes[i - 1] = claves_muestra[(long long)i * claves_muestra.size() / p];
+    }
+
+    // 3. Partir la porción ordenada según los pivotes
+    std::vector<int> cuentas_envio(p), desplazamientos_envio(p);
+    int inicio_particion = 0;
+    for (int destino = 0; destino < p; destino++) {
+        int fin_particion = n_local;
+        if (destino < p - 1) {
+            fin_particion = std::upper_bound(mi_porcion.begin(), mi_porcion.end(), pivotes[destino],
+                                             [&clave](const TipoClave& pivote, const T& registro) {
+                                                 return pivote < clave(registro);
+                                             }) - mi_porcion.begin();
+        }
+        fin_particion = std::max(fin_particion, inicio_particion);
+        desplazamientos_envio[destino] = inicio_particion;
+        cuentas_envio[destino] = fin_particion - inicio_particion;
+        inicio_particion = fin_particion;
+    }
+    double fin_muestreo = MPI_Wtime();
+    temporizador_particion.detener();
+
+    // 4. Intercambio único de registros con el tipo derivado
+    TemporizadorFase temporizador_intercambio(FASE_DISTRIBUCION);
+    std::vector<int> cuentas_recepcion(p), desplazamientos_recepcion(p);
+    MPI_Alltoall(cuentas_envio.data(), 1, MPI_INT, cuentas_recepcion.data(), 1, MPI_INT, MPI_COMM_WORLD);
+    int total_recibido = 0;
+    for (int fuente = 0; fuente < p; fuente++) {
+        desplazamientos_recepcion[fuente] = total_recibido;
+        total_recibido += cuentas_recepcion[fuente];
+    }
+
+    std::vector<T> recibidos(total_recibido);
+    MPI_Alltoallv(mi_porcion.data(), cuentas_envio.data(), desplazamientos_envio.data(), tipo,
+                  recibidos.data(), cuentas_recepcion.data(), desplazamientos_recepcion.data(), tipo,
+                  MPI_COMM_WORLD);
+    double fin_intercambio = MPI_Wtime();
+    temporizador_intercambio.detener();
+
+    // 5. Merge de las p secuencias recibidas
+    TemporizadorFase temporizador_merge(FASE_CALCULO);
+    std::vector<T> mi_particion(total_recibido);
+    if (clave_indice) {
+        std::vector<ClaveIndice<TipoClave> > pares(total_recibido), pares_ordenados(total_recibido);
+        for (int i = 0; i < total_recibido; i++) {
+            pares[i].clave = clave(recibidos[i]);
+            pares[i].indice = i;
         }
+        merge_k_vias(pares, desplazamientos_recepcion, cuentas_recepcion, pares_ordenados, ClaveDePar());
+        for (int i = 0; i < total_recibido; i++) mi_particion[i] = recibidos[pares_ordenados[i].indice];
+        bytes_locales += (long long)total_recibido * (tamano_par + sizeof(T));
+    } else {
+        merge_k_vias(recibidos, desplazamientos_recepcion, cuentas_recepcion, mi_particion, clave);
+        bytes_locales += (long long)total_recibido * sizeof(T);
+    }
+    double fin_merge = MPI_Wtime();
+    temporizador_merge.detener();
+
+    tiempos[0] = fin_ordenamiento - inicio;
+    tiempos[1] = fin_muestreo - fin_ordenamiento;
+    tiempos[2] = fin_intercambio - fin_muestreo;
+    tiempos[3] = fin_merge - fin_intercambio;
+    return mi_particion;
+}
+
+// Carga útil determinada por la clave y el origen, para verificar que cada
+// registro viajó entero
+void rellenar_carga(Registro& r) {
+    for (int j = 0; j < 5; j++) r.carga[j] = r.clave * (j + 1.0) + 0.25 * r.origen;
+}
+
+// Modo registros: ordena n registros (clave entre 1 y 10^6 más carga) con el
+// sample sort genérico, en modo directo, clave-índice o ambos sobre la misma
+// entrada, y compara tiempos y bytes movidos en memoria
+void ordenar_registros(int n_total, int mi_rango, int numero_procesos, bool directo, bool indice) {
+    int elementos_por_proceso = n_total / numero_procesos;
+    MPI_Datatype tipo_registro = crear_tipo_registro();
+
+    TemporizadorFase temporizador_entrada(FASE_ENTRADA);
+    std::vector<Registro> originales(elementos_por_proceso);
+    std::random_device rd;
+    std::mt19937 gen(rd() + mi_rango);
+    std::uniform_int_distribution<> dis(1, 1000000);
+    long long suma_local = 0;
+    for (int i = 0; i < elementos_por_proceso; i++) {
+        originales[i].clave = dis(gen);
+        originales[i].origen = mi_rango;
+        originales[i].secuencia = i;
+        rellenar_carga(originales[i]);
+        suma_local += originales[i].clave + originales[i].secuencia;
+    }
+    temporizador_entrada.detener();
+
+    if (mi_rango == 0) {
+        std::cout << "\n=== ORDENAMIENTO DE REGISTROS (sample sort genérico) ===" << std::endl;
+        std::cout << "Registro: " << sizeof(Registro) << " bytes (clave int + carga), par clave-índice: "
+                  << sizeof(ClaveIndice<int>) << " bytes" << std::endl;
+    }
 
+    for (int variante = 0; variante < 2; variante++) {
+        bool clave_indice = (variante == 1);
+        if ((clave_indice && !indice) || (!clave_indice && !directo)) continue;
+
+        std::vector<Registro> mi_porcion(originales);
+        double tiempos[4];
+        long long bytes_locales;
+        std::vector<Registro> mi_particion = ordenar_registros_por_muestreo(
+            mi_porcion, tipo_registro, ClaveRegistro(), clave_indice, numero_procesos, tiempos, bytes_locales);
+
+        // Verificación: orden global por clave, carga intacta y conservación
+        // de claves y secuencias
+        int correcto_local = 1;
+        long long suma_particion = 0;
+        for (int i = 0; i < (int)mi_particion.size(); i++) {
+            const Registro& r = mi_particion[i];
+            if (i > 0 && r.clave < mi_particion[i - 1].clave) correcto_local = 0;
+            Registro esperado = r;
+            rellenar_carga(esperado);
+            if (std::memcmp(esperado.carga, r.carga, sizeof(r.carga)) != 0) correcto_local = 0;
+            suma_particion += r.clave + r.secuencia;
+        }
+        int mi_maximo = mi_particion.empty() ? INT_MIN : mi_particion.back().clave;
+        int maximo_anterior = INT_MIN;
+        MPI_Exscan(&mi_maximo, &maximo_anterior, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+        if (mi_rango == 0) maximo_anterior = INT_MIN;
+        if (!mi_particion.empty() && mi_particion.front().clave < maximo_anterior) correcto_local = 0;
+
+        int correcto_global;
+        MPI_Allreduce(&correcto_local, &correcto_global, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+        long long sumas_locales[2] = {suma_local, suma_particion}, sumas_globales[2];
+        MPI_Allreduce(sumas_locales, sumas_globales, 2, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+
+        double tiempos_max[4];
+        MPI_Reduce(tiempos, tiempos_max, 4, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        long long bytes_max;
+        MPI_Reduce(&bytes_locales, &bytes_max, 1, MPI_LONG_LONG, MPI_MAX, 0, MPI_COMM_WORLD);
+
+        if (mi_rango == 0) {
+            TemporizadorFase temporizador(FASE_SALIDA);
+            std::cout << "\nModo " << (clave_indice ? "clave-índice" : "directo") << ":" << std::endl;
+            std::cout << "  ¿Ordenado por clave con la carga intacta? " << (correcto_global ? "✅ SÍ" : "❌ NO")
+                      << std::endl;
+            std::cout << "  ¿Se conservaron los registros? "
+                      << (sumas_globales[0] == sumas_globales[1] ? "✅ SÍ" : "❌ NO") << std::endl;
+            std::cout << std::fixed << std::setprecision(6);
+            std::cout << "  Ordenamiento local: " << tiempos_max[0] << " segundos" << std::endl;
+            std::cout << "  Muestreo y pivotes: " << tiempos_max[1] << " segundos" << std::endl;
+            std::cout << "  Intercambio:        " << tiempos_max[2] << " segundos" << std::endl;
+            std::cout << "  Merge k-vías:       " << tiempos_max[3] << " segundos" << std::endl;
+            std::cout << std::setprecision(1);
+            std::cout << "  Bytes escritos en memoria (máx., ordenamiento + merge): "
+                      << bytes_max / 1048576.0 << " MB" << std::endl;
+        }
+    }
+
+    MPI_Type_free(&tipo_registro);
+}
+
+// ==============================================
+// ORDENAMIENTO EXTERNO (datos más grandes que la memoria)
+// ==============================================
+
+// Difunde una cadena del proceso 0 a todos los procesos
+void difundir_cadena(std::string& cadena, int mi_rango) {
+    int longitud = cadena.size();
+    MPI_Bcast(&longitud, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    std::vector<char> caracteres(cadena.begin(), cadena.end());
+    caracteres.resize(longitud + 1, '\0');
+    MPI_Bcast(caracteres.data(), longitud + 1, MPI_CHAR, 0, MPI_COMM_WORLD);
+    if (mi_rango != 0) cadena = caracteres.data();
+}
+
+// Corrida ordenada en un archivo temporal local, leída con un buffer grande
+struct LectorCorrida {
+    std::FILE* archivo;
+    std::vector<int> buffer;
+    size_t posicion;
+    size_t cantidad;
+};
+
+// Recarga el buffer de una corrida; devuelve false si la corrida se agotó
+bool recargar_corrida(LectorCorrida& lector) {
+    lector.cantidad = std::fread(lector.buffer.data(), sizeof(int), lector.buffer.size(), lector.archivo);
+    lector.posicion = 0;
+    return lector.cantidad > 0;
+}
+
+// Ordenamiento externo: cada proceso lee con MPI-IO un tramo disjunto del
+// archivo de entrada en bloques que caben en "memoria_mb", y con pivotes
+// elegidos por muestreo cada bloque ordenado se reparte con MPI_Alltoallv al
+// proceso dueño de su rango de claves, que lo guarda como corrida en un archivo
+// temporal local. Al final cada proceso combina sus corridas leyéndolas con
+// buffers grandes y escribe su tramo del archivo de salida con MPI-IO colectivo.
+// Los tiempos de E/S, cómputo y comunicación se reportan por separado
+void ordenar_externo(std::string ruta_entrada, std::string ruta_salida, int memoria_mb,
+                     std::string directorio_temporal, int n_generar, int mi_rango, int numero_procesos) {
+    int p = numero_procesos;
+    const int MUESTRAS_POR_PROCESO = 256;
+
+    // El presupuesto de memoria se reparte en 4 buffers de bloque
+    long long elementos_memoria = (long long)memoria_mb * 1024 * 1024 / sizeof(int);
+    int elementos_por_bloque = (int)std::max(1024LL, std::min(elementos_memoria / 4, (long long)INT_MAX / 2));
+
+    double tiempo_es = 0.0, tiempo_computo = 0.0, tiempo_comunicacion = 0.0, t;
+
+    // Si el archivo de entrada no existe se genera con n enteros aleatorios
+    int existe = 0;
+    if (mi_rango == 0) {
+        std::FILE* prueba = std::fopen(ruta_entrada.c_str(), "rb");
+        existe = (prueba != NULL);
+        if (prueba) std::fclose(prueba);
+    }
+    MPI_Bcast(&existe, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+    MPI_File archivo_entrada;
+    if (!existe) {
+        TemporizadorFase temporizador(FASE_ENTRADA);
+        if (mi_rango == 0) {
+            std::cout << "Generando " << ruta_entrada << " con " << n_generar << " enteros aleatorios..." << std::endl;
+        }
+        MPI_File_open(MPI_COMM_WORLD, ruta_entrada.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                      MPI_INFO_NULL, &archivo_entrada);
+        long long inicio = (long long)n_generar * mi_rango / p, fin = (long long)n_generar * (mi_rango + 1) / p;
+        long long bloques_max, mis_bloques = (fin - inicio + elementos_por_bloque - 1) / elementos_por_bloque;
+        MPI_Allreduce(&mis_bloques, &bloques_max, 1, MPI_LONG_LONG, MPI_MAX, MPI_COMM_WORLD);
+
+        std::random_device rd;
+        std::mt19937 gen(rd() + mi_rango);
+        std::uniform_int_distribution<> dis(1, 1000);
+        std::vector<int> bloque(elementos_por_bloque);
+        for (long long b = 0; b < bloques_max; b++) {
+            long long desde = inicio + b * elementos_por_bloque;
+            int cantidad = (int)std::max(0LL, std::min((long long)elementos_por_bloque, fin - desde));
+            for (int i = 0; i < cantidad; i++) bloque[i] = dis(gen);
+            MPI_File_write_at_all(archivo_entrada, (MPI_Offset)std::min(desde, fin) * sizeof(int),
+                                  bloque.data(), cantidad, MPI_INT, MPI_STATUS_IGNORE);
+        }
+        MPI_File_close(&archivo_entrada);
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double inicio_total = MPI_Wtime();
+
+    MPI_File_open(MPI_COMM_WORLD, ruta_entrada.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &archivo_entrada);
+    MPI_Offset bytes_entrada;
+    MPI_File_get_size(archivo_entrada, &bytes_entrada);
+    long long n = bytes_entrada / sizeof(int);
+    long long inicio_tramo = n * mi_rango / p, fin_tramo = n * (mi_rango + 1) / p;
+
+    if (mi_rango == 0) {
+        std::cout << "Elementos en " << ruta_entrada << ": " << n << std::endl;
+        std::cout << "Memoria por proceso: " << memoria_mb << " MB (bloques de "
+                  << elementos_por_bloque << " elementos)" << std::endl;
+    }
+
+    // 1. Pivotes a partir de muestras espaciadas de cada tramo
+    t = MPI_Wtime();
+    std::vector<int> muestras_locales(MUESTRAS_POR_PROCESO, INT_MAX);
+    long long tamano_tramo = fin_tramo - inicio_tramo;
+    {
+        TemporizadorFase temporizador(FASE_ENTRADA);
+        for (int i = 0; i < MUESTRAS_POR_PROCESO && tamano_tramo > 0; i++) {
+            MPI_Offset indice = inicio_tramo + tamano_tramo * i / MUESTRAS_POR_PROCESO;
+            MPI_File_read_at(archivo_entrada, indice * sizeof(int), &muestras_locales[i], 1, MPI_INT,
+                             MPI_STATUS_IGNORE);
+        }
+    }
+    tiempo_es += MPI_Wtime() - t;
+
+    t = MPI_Wtime();
+    std::vector<int> muestras(MUESTRAS_POR_PROCESO * p);
+    {
+        TemporizadorFase temporizador(FASE_DISTRIBUCION);
+        MPI_Allgather(muestras_locales.data(), MUESTRAS_POR_PROCESO, MPI_INT,
+                      muestras.data(), MUESTRAS_POR_PROCESO, MPI_INT, MPI_COMM_WORLD);
+    }
+    tiempo_comunicacion += MPI_Wtime() - t;
+
+    t = MPI_Wtime();
+    TemporizadorFase temporizador_pivotes(FASE_CALCULO);
+    // Las muestras de procesos con tramos vacíos (INT_MAX) no cuentan
+    std::sort(muestras.begin(), muestras.end());
+    long long muestras_validas = std::lower_bound(muestras.begin(), muestras.end(), INT_MAX) - muestras.begin();
+    std::vector<int> pivotes(p - 1, INT_MAX);
+    for (int i = 1; i < p && muestras_validas > 0; i++) {
+        pivotes[i - 1] = muestras[muestras_validas * i / p];
+    }
+    temporizador_pivotes.detener();
+    tiempo_computo += MPI_Wtime() - t;
+
+    // 2. Formación de corridas: leer bloque, ordenar, repartir por pivotes y
+    // guardar lo recibido (ya combinado) como corrida en el disco local. Los
+    // cuatro buffers (bloque, auxiliar, recibidos y corrida) son de un bloque
+    long long mis_rondas = (tamano_tramo + elementos_por_bloque - 1) / elementos_por_bloque, rondas;
+    MPI_Allreduce(&mis_rondas, &rondas, 1, MPI_LONG_LONG, MPI_MAX, MPI_COMM_WORLD);
+
+    std::vector<int> bloque, auxiliar(elementos_por_bloque), recibidos, corrida;
+    bloque.reserve(elementos_por_bloque);
+    std::vector<int> cuentas_envio(p), desplazamientos_envio(p), cuentas_recepcion(p), desplazamientos_recepcion(p);
+    std::vector<int> pendientes_recepcion(p);
+    std::vector<std::string> rutas_corridas;
+    long long elementos_propios = 0;
+
+    for (long long ronda = 0; ronda < rondas; ronda++) {
+        long long desde = inicio_tramo + ronda * elementos_por_bloque;
+        int cantidad = (int)std::max(0LL, std::min((long long)elementos_por_bloque, fin_tramo - desde));
+
+        t = MPI_Wtime();
+        TemporizadorFase temporizador_lectura(FASE_ENTRADA);
+        bloque.resize(cantidad);
+        MPI_File_read_at_all(archivo_entrada, (MPI_Offset)std::min(desde, fin_tramo) * sizeof(int),
+                             bloque.data(), cantidad, MPI_INT, MPI_STATUS_IGNORE);
+        temporizador_lectura.detener();
+        tiempo_es += MPI_Wtime() - t;
+
+        t = MPI_Wtime();
+        TemporizadorFase temporizador_bloque(FASE_CALCULO);
+        ordenar_local(bloque, auxiliar);
+        int inicio_particion = 0;
+        for (int destino = 0; destino < p; destino++) {
+            int fin_particion = (destino < p - 1)
+                ? std::upper_bound(bloque.begin(), bloque.end(), pivotes[destino]) - bloque.begin()
+                : cantidad;
+            fin_particion = std::max(fin_particion, inicio_particion);
+            desplazamientos_envio[destino] = inicio_particion;
+            cuentas_envio[destino] = fin_particion - inicio_particion;
+            inicio_particion = fin_particion;
+        }
+        temporizador_bloque.detener();
+        tiempo_computo += MPI_Wtime() - t;
+
+        // El intercambio se hace en subrondas en las que cada proceso acepta a
+        // lo sumo un bloque, repartido entre las fuentes en orden de rango: con
+        // claves sesgadas un proceso puede ser destino de hasta p bloques por
+        // ronda, y así "recibidos" y "corrida" no pasan del presupuesto
+        t = MPI_Wtime();
+        TemporizadorFase temporizador_cuentas(FASE_DISTRIBUCION);
+        MPI_Alltoall(cuentas_envio.data(), 1, MPI_INT, pendientes_recepcion.data(), 1, MPI_INT, MPI_COMM_WORLD);
+        temporizador_cuentas.detener();
+        tiempo_comunicacion += MPI_Wtime() - t;
+
+        int quedan_global = 1;
+        while (quedan_global) {
+            t = MPI_Wtime();
+            TemporizadorFase temporizador_intercambio(FASE_DISTRIBUCION);
+            int total_recibido = 0, quedan = 0;
+            for (int fuente = 0; fuente < p; fuente++) {
+                cuentas_recepcion[fuente] =
+                    std::min(pendientes_recepcion[fuente], elementos_por_bloque - total_recibido);
+                desplazamientos_recepcion[fuente] = total_recibido;
+                total_recibido += cuentas_recepcion[fuente];
+                pendientes_recepcion[fuente] -= cuentas_recepcion[fuente];
+                if (pendientes_recepcion[fuente] > 0) quedan = 1;
+            }
+            // Cada fuente se entera de cuánto le acepta cada destino
+            MPI_Alltoall(cuentas_recepcion.data(), 1, MPI_INT, cuentas_envio.data(), 1, MPI_INT, MPI_COMM_WORLD);
+            recibidos.resize(total_recibido);
+            MPI_Alltoallv(bloque.data(), cuentas_envio.data(), desplazamientos_envio.data(), MPI_INT,
+                          recibidos.data(), cuentas_recepcion.data(), desplazamientos_recepcion.data(), MPI_INT,
+                          MPI_COMM_WORLD);
+            for (int destino = 0; destino < p; destino++) desplazamientos_envio[destino] += cuentas_envio[destino];
+            MPI_Allreduce(&quedan, &quedan_global, 1, MPI_INT, MPI_LOR, MPI_COMM_WORLD);
+            temporizador_intercambio.detener();
+            tiempo_comunicacion += MPI_Wtime() - t;
+            if (total_recibido == 0) continue;
+
+            t = MPI_Wtime();
+            {
+                TemporizadorFase temporizador(FASE_CALCULO);
+                corrida.resize(total_recibido);
+                merge_k_vias(recibidos, desplazamientos_recepcion, cuentas_recepcion, corrida);
+            }
+            tiempo_computo += MPI_Wtime() - t;
+
+            // Guardar la corrida en el disco local es E/S, igual que en tiempo_es
+            t = MPI_Wtime();
+            TemporizadorFase temporizador_corrida(FASE_SALIDA);
+            std::string ruta = directorio_temporal + "/corrida_" + std::to_string(mi_rango) + "_" +
+                               std::to_string(rutas_corridas.size()) + ".bin";
+            std::FILE* archivo_corrida = std::fopen(ruta.c_str(), "wb");
+            if (archivo_corrida == NULL) {
+                std::cout << "Error: no se pudo crear " << ruta << std::endl;
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+            std::fwrite(corrida.data(), sizeof(int), total_recibido, archivo_corrida);
+            std::fclose(archivo_corrida);
+            rutas_corridas.push_back(ruta);
+            elementos_propios += total_recibido;
+            temporizador_corrida.detener();
+            tiempo_es += MPI_Wtime() - t;
+        }
+    }
+    MPI_File_close(&archivo_entrada);
+
+    // Liberar los buffers de la formación de corridas antes del merge
+    std::vector<int>().swap(bloque);
+    std::vector<int>().swap(auxiliar);
+    std::vector<int>().swap(recibidos);
+    std::vector<int>().swap(corrida);
+    double fin_corridas = MPI_Wtime();
+
+    // 3. Merge de las corridas locales y escritura colectiva de la salida: la
+    // mitad del presupuesto es para la salida y la otra mitad para las corridas
+    long long desplazamiento_salida = 0;
+    MPI_Exscan(&elementos_propios, &desplazamiento_salida, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+    if (mi_rango == 0) desplazamiento_salida = 0;
+
+    int k = rutas_corridas.size();
+    int elementos_salida = (int)std::max(1024LL, std::min(elementos_memoria / 2, (long long)INT_MAX / 2));
+    int elementos_por_corrida = (int)std::max(1024LL, elementos_memoria / 2 / std::max(k, 1));
+
+    t = MPI_Wtime();
+    TemporizadorFase temporizador_apertura(FASE_ENTRADA);
+    std::vector<LectorCorrida> lectores(k);
+    std::vector<int> cabeza(k);
+    std::vector<char> agotada(k);
+    for (int r = 0; r < k; r++) {
+        lectores[r].archivo = std::fopen(rutas_corridas[r].c_str(), "rb");
+        lectores[r].buffer.resize(elementos_por_corrida);
+        agotada[r] = !recargar_corrida(lectores[r]);
+        if (!agotada[r]) cabeza[r] = lectores[r].buffer[0];
+    }
+    temporizador_apertura.detener();
+    tiempo_es += MPI_Wtime() - t;
+
+    CabezasSecuencias<int> menor = {&cabeza, &agotada};
+    ArbolPerdedores<CabezasSecuencias<int> > arbol(k, menor);
+
+    MPI_File archivo_salida;
+    MPI_File_open(MPI_COMM_WORLD, ruta_salida.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                  MPI_INFO_NULL, &archivo_salida);
+    MPI_File_set_size(archivo_salida, (MPI_Offset)n * sizeof(int));
+
+    long long mis_escrituras = (elementos_propios + elementos_salida - 1) / elementos_salida, escrituras;
+    MPI_Allreduce(&mis_escrituras, &escrituras, 1, MPI_LONG_LONG, MPI_MAX, MPI_COMM_WORLD);
+
+    std::vector<int> salida(elementos_salida);
+    long long escritos = 0;
+    for (long long e = 0; e < escrituras; e++) {
+        int cantidad = (int)std::min((long long)elementos_salida, elementos_propios - escritos);
+
+        t = MPI_Wtime();
+        TemporizadorFase temporizador_merge(FASE_CALCULO);
+        double tiempo_recargas = 0.0;
+        for (int i = 0; i < cantidad; i++) {
+            int r = arbol.ganador;
+            salida[i] = cabeza[r];
+
+            LectorCorrida& lector = lectores[r];
+            if (++lector.posicion == lector.cantidad) {
+                // La recarga es lectura de la corrida, no cálculo
+                temporizador_merge.detener();
+                double inicio_recarga = MPI_Wtime();
+                {
+                    TemporizadorFase temporizador_recarga(FASE_ENTRADA);
+                    if (!recargar_corrida(lector)) agotada[r] = 1;
+                }
+                tiempo_recargas += MPI_Wtime() - inicio_recarga;
+                temporizador_merge.reanudar();
+            }
+            if (!agotada[r]) cabeza[r] = lector.buffer[lector.posicion];
+            arbol.actualizar();
+        }
+        temporizador_merge.detener();
+        double tiempo_merge = MPI_Wtime() - t;
+        tiempo_computo += tiempo_merge - tiempo_recargas;
+        tiempo_es += tiempo_recargas;
+
+        t = MPI_Wtime();
+        TemporizadorFase temporizador_escritura(FASE_SALIDA);
+        MPI_File_write_at_all(archivo_salida, (MPI_Offset)(desplazamiento_salida + escritos) * sizeof(int),
+                              salida.data(), cantidad, MPI_INT, MPI_STATUS_IGNORE);
+        escritos += cantidad;
+        temporizador_escritura.detener();
+        tiempo_es += MPI_Wtime() - t;
+    }
+    MPI_File_close(&archivo_salida);
+
+    for (int r = 0; r < k; r++) {
+        std::fclose(lectores[r].archivo);
+        std::remove(rutas_corridas[r].c_str());
+    }
+    double fin_total = MPI_Wtime();
+
+    // 4. Verificación distribuida leyendo de nuevo el tramo propio de la salida
+    MPI_File_open(MPI_COMM_WORLD, ruta_salida.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &archivo_salida);
+    int ordenado_local = 1, primero = INT_MAX, ultimo = INT_MIN;
+    for (long long leidos = 0; leidos < elementos_propios; ) {
+        int cantidad = (int)std::min((long long)elementos_salida, elementos_propios - leidos);
+        MPI_File_read_at(archivo_salida, (MPI_Offset)(desplazamiento_salida + leidos) * sizeof(int),
+                         salida.data(), cantidad, MPI_INT, MPI_STATUS_IGNORE);
+        if (leidos == 0) primero = salida[0];
+        if (leidos > 0 && salida[0] < ultimo) ordenado_local = 0;
+        if (!std::is_sorted(salida.begin(), salida.begin() + cantidad)) ordenado_local = 0;
+        ultimo = salida[cantidad - 1];
+        leidos += cantidad;
+    }
+    MPI_File_close(&archivo_salida);
+
+    int maximo_anterior = INT_MIN;
+    MPI_Exscan(&ultimo, &maximo_anterior, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    if (mi_rango == 0) maximo_anterior = INT_MIN;
+    if (elementos_propios > 0 && primero < maximo_anterior) ordenado_local = 0;
+
+    int ordenado_global;
+    long long total_elementos;
+    MPI_Allreduce(&ordenado_local, &ordenado_global, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+    MPI_Allreduce(&elementos_propios, &total_elementos, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+
+    double tiempos[5] = {tiempo_es, tiempo_computo, tiempo_comunicacion,
+                         fin_corridas - inicio_total, fin_total - fin_corridas};
+    double tiempos_max[5];
+    MPI_Reduce(tiempos, tiempos_max, 5, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    long long minimo_propios, maximo_propios;
+    int maximo_corridas;
+    MPI_Reduce(&elementos_propios, &minimo_propios, 1, MPI_LONG_LONG, MPI_MIN, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&elementos_propios, &maximo_propios, 1, MPI_LONG_LONG, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&k, &maximo_corridas, 1, MPI_INT, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    if (mi_rango == 0) {
+        TemporizadorFase temporizador(FASE_SALIDA);
+        std::cout << "\n=== RESULTADO FINAL (ORDENAMIENTO EXTERNO) ===" << std::endl;
+        std::cout << "Salida: " << ruta_salida << " (" << total_elementos << " elementos)" << std::endl;
+        std::cout << "¿Está ordenado globalmente? " << (ordenado_global && total_elementos == n ? "✅ SÍ" : "❌ NO")
+                  << std::endl;
+        std::cout << "Elementos por proceso: mínimo " << minimo_propios << ", máximo " << maximo_propios
+                  << "; hasta " << maximo_corridas << " corridas por proceso" << std::endl;
+
+        std::cout << std::fixed << std::setprecision(6);
+        std::cout << "\nTiempos (máx. entre procesos):" << std::endl;
+        std::cout << "  Formación de corridas: " << tiempos_max[3] << " segundos" << std::endl;
+        std::cout << "  Merge y escritura:     " << tiempos_max[4] << " segundos" << std::endl;
+        std::cout << "  E/S (archivos):        " << tiempos_max[0] << " segundos" << std::endl;
+        std::cout << "  Cómputo:               " << tiempos_max[1] << " segundos" << std::endl;
+        std::cout << "  Comunicación:          " << tiempos_max[2] << " segundos" << std::endl;
+    }
+}
+
+// Compara el rendimiento (claves/s) de los ordenamientos locales en el
+// proceso 0: merge sort recursivo original, std::sort, merge sort ascendente
+// y radix sort, con claves en [1, 1000] y con claves en todo el rango de int.
+// Si hay pool de hilos se agrega el merge sort multihilo
+void comparar_ordenamientos_locales(int n) {
+    const int REPETICIONES = 3;
+    const char* nombres[5] = {"merge_sort_secuencial", "std::sort", "merge_sort_ascendente", "radix_sort",
+                              "ordenar_paralelo"};
+    int numero_algoritmos = pool_ordenamiento != nullptr ? 5 : 4;
+
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::vector<int> original(n), trabajo(n), auxiliar(n);
+
+    std::cout << "\n=== COMPARACIÓN DE ORDENAMIENTOS LOCALES (n = " << n << ") ===" << std::endl;
+
+    for (int dominio = 0; dominio < 2; dominio++) {
+        TemporizadorFase temporizador_entrada(FASE_ENTRADA);
+        if (dominio == 0) {
+            std::uniform_int_distribution<> dis(1, 1000);
+            for (int i = 0; i < n; i++) original[i] = dis(gen);
+            std::cout << "\nClaves entre 1 y 1000:" << std::endl;
+        } else {
+            std::uniform_int_distribution<> dis(INT_MIN, INT_MAX);
+            for (int i = 0; i < n; i++) original[i] = dis(gen);
+            std::cout << "\nClaves en todo el rango de int:" << std::endl;
+        }
+        temporizador_entrada.detener();
+
+        for (int algoritmo = 0; algoritmo < numero_algoritmos; algoritmo++) {
+            double mejor_tiempo = 0.0;
+            bool correcto = true;
+
+            // Se toma la mejor de varias repeticiones sobre la misma entrada
+            for (int repeticion = 0; repeticion < REPETICIONES; repeticion++) {
+                std::copy(original.begin(), original.end(), trabajo.begin());
+                TemporizadorFase temporizador(FASE_CALCULO);
+                double inicio = MPI_Wtime();
+                switch (algoritmo) {
+                case 0: merge_sort_secuencial(trabajo, 0, n - 1); break;
+                case 1: std::sort(trabajo.begin(), trabajo.end()); break;
+                case 2:
+                    if (merge_sort_ascendente(trabajo.data(), auxiliar.data(), n)) trabajo.swap(auxiliar);
+                    break;
+                case 3:
+                    if (radix_sort(trabajo.data(), auxiliar.data(), n)) trabajo.swap(auxiliar);
+                    break;
+                case 4: ordenar_paralelo(trabajo, auxiliar, *pool_ordenamiento); break;
+                }
+                double tiempo = MPI_Wtime() - inicio;
+                temporizador.detener();
+                if (repeticion == 0 || tiempo < mejor_tiempo) mejor_tiempo = tiempo;
+                correcto = correcto && std::is_sorted(trabajo.begin(), trabajo.end());
+            }
+
+            TemporizadorFase temporizador(FASE_SALIDA);
+            std::cout << "  " << std::left << std::setw(24) << nombres[algoritmo] << std::right
+                      << std::fixed << std::setprecision(6) << mejor_tiempo << " s  "
+                      << std::setprecision(2) << std::setw(10) << (mejor_tiempo > 0 ? n / mejor_tiempo / 1e6 : 0.0)
+                      << " Mclaves/s  "
+                      << (correcto ? "✅" : "❌") << std::endl;
+        }
+    }
+}
+
+#ifndef NUCLEOS_SIN_MAIN
+// Modos árbol (por defecto), secuencial y k-vías: el proceso 0 genera los
+// datos, los reparte, cada proceso ordena su porción y el resultado se
+// recolecta y combina en el proceso 0
+void ordenar_y_recolectar(int n_total, int modo, int numero_hilos, int mi_rango, int numero_procesos) {
+    std::vector<int> datos_completos, mi_porcion, resultado_final;
+
+    if (mi_rango == 0) {
         // Generar datos aleatorios
+        TemporizadorFase temporizador(FASE_ENTRADA);
         datos_completos.resize(n_total);
         std::random_device rd;
         std::mt19937 gen(rd());
@@ -123,23 +1738,29 @@ int main(int argc, char* argv[]) {
         }
     }
 
-    // Distribuir n a todos los procesos
-    MPI_Bcast(&n_total, 1, MPI_INT, 0, MPI_COMM_WORLD);
-
     // Calcular elementos por proceso
     int elementos_por_proceso = n_total / numero_procesos;
 
-    // Preparar buffer local
-    mi_porcion.resize(elementos_por_proceso);
-
-    // Distribuir datos
-    MPI_Scatter(datos_completos.data(), elementos_por_proceso, MPI_INT,
-                mi_porcion.data(), elementos_por_proceso, MPI_INT, 0, MPI_COMM_WORLD);
+    // Distribuir datos (con MEMORIA_NODO el bloque vive en copia_nodo hasta
+    // terminar el merge)
+    VentanaNodo copia_nodo;
+    int* bloque;
+    {
+        TemporizadorFase temporizador(FASE_DISTRIBUCION);
+        bloque = repartir_porcion(datos_completos, elementos_por_proceso, mi_porcion, copia_nodo);
+    }
+    informar_memoria_nodo();
 
     std::cout << "Proceso " << mi_rango << " recibió " << elementos_por_proceso << " elementos" << std::endl;
 
     // Cada proceso ordena su porción localmente
-    merge_sort_secuencial(mi_porcion, 0, elementos_por_proceso - 1);
+    double inicio_ordenamiento = MPI_Wtime();
+    std::vector<int> auxiliar(elementos_por_proceso);
+    const int* ordenado;
+    {
+        TemporizadorFase temporizador(FASE_CALCULO);
+        ordenado = ordenar_local(bloque, elementos_por_proceso, auxiliar);
+    }
 
     std::cout << "Proceso " << mi_rango << " completó ordenamiento local" << std::endl;
 
@@ -148,8 +1769,8 @@ int main(int argc, char* argv[]) {
         for (int proc = 0; proc < numero_procesos; proc++) {
             if (mi_rango == proc) {
                 std::cout << "Proceso " << mi_rango << " ordenó: ";
-                for (int x : mi_porcion) {
-                    std::cout << x << " ";
+                for (int i = 0; i < elementos_por_proceso; i++) {
+                    std::cout << ordenado[i] << " ";
                 }
                 std::cout << std::endl;
             }
@@ -157,33 +1778,63 @@ int main(int argc, char* argv[]) {
         }
     }
 
-    // Fase de merge usando comunicación en árbol
-    // Solo el proceso 0 recolecta todos los datos ordenados al final
+    double fin_ordenamiento = MPI_Wtime();
 
-    // Recolectar todas las porciones ordenadas en el proceso 0
-    if (mi_rango == 0) {
-        resultado_final = mi_porcion;  // Empezar con mi propia porción
+    // Recolección y merge: fase de reducción
+    TemporizadorFase temporizador_merge(FASE_REDUCCION);
+    if (modo == MODO_SECUENCIAL) {
+        // Recolectar todas las porciones ordenadas en el proceso 0
+        if (mi_rango == 0) {
+            // Dos buffers del pool del tamaño final que se alternan entre
+            // pasos, empezando con mi propia porción
+            BufferPool<int> actual(n_total), siguiente(n_total);
+            std::copy(ordenado, ordenado + elementos_por_proceso, actual.data());
+            int tamano_actual = elementos_por_proceso;
 
-        // Recibir porciones ordenadas de otros procesos y hacer merge
-        for (int proceso = 1; proceso < numero_procesos; proceso++) {
-            std::vector<int> porcion_recibida(elementos_por_proceso);
-            MPI_Recv(porcion_recibida.data(), elementos_por_proceso, MPI_INT,
-                     proceso, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            // Recibir porciones ordenadas de otros procesos y hacer merge
+            for (int proceso = 1; proceso < numero_procesos; proceso++) {
+                BufferPool<int> porcion_recibida(elementos_por_proceso);
+                MPI_Recv(porcion_recibida.data(), elementos_por_proceso, MPI_INT,
+                         proceso, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
 
-            // Hacer merge de resultado_final con la porción recibida
-            resultado_final = merge_dos_vectores(resultado_final, porcion_recibida);
+                // Hacer merge del resultado acumulado con la porción recibida
+                combinar_secuencias<int>(actual.data(), tamano_actual, porcion_recibida.data(), elementos_por_proceso,
+                                         siguiente.data());
+                tamano_actual += elementos_por_proceso;
+                actual.swap(siguiente);
 
-            std::cout << "Proceso 0 hizo merge con datos del proceso " << proceso << std::endl;
+                std::cout << "Proceso 0 hizo merge con datos del proceso " << proceso << std::endl;
+            }
+            resultado_final.assign(actual.data(), actual.data() + tamano_actual);
+        } else {
+            // Otros procesos envían sus porciones ordenadas al proceso 0
+            MPI_Send(ordenado, elementos_por_proceso, MPI_INT, 0, 0, MPI_COMM_WORLD);
         }
+    } else if (modo == MODO_K_VIAS) {
+        // Un único merge k-vías en el proceso 0 a medida que llegan los bloques
+        resultado_final = recolectar_k_vias(ordenado, elementos_por_proceso, mi_rango, numero_procesos);
     } else {
-        // Otros procesos envían sus porciones ordenadas al proceso 0
-        MPI_Send(mi_porcion.data(), elementos_por_proceso, MPI_INT, 0, 0, MPI_COMM_WORLD);
+        // Fase de merge usando comunicación en árbol binomial
+        resultado_final = merge_en_arbol(ordenado, elementos_por_proceso, mi_rango, numero_procesos);
     }
 
+    double fin_merge = MPI_Wtime();
+    temporizador_merge.detener();
+    copia_nodo.liberar();
+
+    // Tiempos de cada fase (peor caso entre todos los procesos)
+    double tiempo_ordenamiento = fin_ordenamiento - inicio_ordenamiento;
+    double tiempo_merge = fin_merge - fin_ordenamiento;
+    double tiempo_max_ordenamiento, tiempo_max_merge;
+    MPI_Reduce(&tiempo_ordenamiento, &tiempo_max_ordenamiento, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&tiempo_merge, &tiempo_max_merge, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
     // El proceso 0 muestra el resultado final
     if (mi_rango == 0) {
+        TemporizadorFase temporizador(FASE_SALIDA);
         std::cout << "\n=== RESULTADO FINAL ===" << std::endl;
         std::cout << "Ordenamiento paralelo completado con " << numero_procesos << " procesos" << std::endl;
+        std::cout << "Hilos de ordenamiento local por proceso: " << numero_hilos << std::endl;
 
         // Verificar que está ordenado
         bool esta_ordenado = std::is_sorted(resultado_final.begin(), resultado_final.end());
@@ -209,8 +1860,141 @@ int main(int argc, char* argv[]) {
         }
 
         std::cout << "\nTotal de elementos ordenados: " << resultado_final.size() << std::endl;
+
+        std::cout << std::fixed << std::setprecision(6);
+        std::cout << "\nFase de merge: " << (modo == MODO_SECUENCIAL ? "secuencial en proceso 0" :
+                                                 modo == MODO_K_VIAS ? "k-vías en proceso 0" : "árbol binomial")
+                  << std::endl;
+        std::cout << "Tiempo de ordenamiento local (máx.): " << tiempo_max_ordenamiento << " segundos" << std::endl;
+        std::cout << "Tiempo de fase de merge (máx.):      " << tiempo_max_merge << " segundos" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int numero_procesos, mi_rango;
+
+    // Solo el hilo principal hace llamadas MPI: los hilos del pool únicamente
+    // ordenan memoria local, así que alcanza con MPI_THREAD_FUNNELED
+    int nivel_provisto;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &nivel_provisto);
+    MPI_Comm_size(MPI_COMM_WORLD, &numero_procesos);
+    MPI_Comm_rank(MPI_COMM_WORLD, &mi_rango);
+
+    // Opción "--hilos=N": hilos por proceso para el ordenamiento local (por
+    // defecto 1). Se quita de argv para no alterar la posición de los demás argumentos
+    int numero_hilos = 1;
+    int argumentos = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--hilos=", 8) == 0) {
+            numero_hilos = std::max(1, atoi(argv[i] + 8));
+        } else {
+            argv[argumentos++] = argv[i];
+        }
+    }
+    argc = argumentos;
+    if (numero_hilos > 1 && nivel_provisto < MPI_THREAD_FUNNELED) {
+        if (mi_rango == 0) {
+            std::cout << "⚠️ MPI no provee MPI_THREAD_FUNNELED, se ordena con 1 hilo" << std::endl;
+        }
+        numero_hilos = 1;
+    }
+    std::unique_ptr<PoolHilos> pool;
+    if (numero_hilos > 1) {
+        pool.reset(new PoolHilos(numero_hilos));
+        pool_ordenamiento = pool.get();
     }
 
+    int n_total;
+
+    // Argumento opcional: "secuencial" (merge progresivo en el proceso 0, para
+    // comparar), "kvias" (merge k-vías en el proceso 0), "muestreo" (sample sort
+    // con resultado distribuido), "local" (comparación de ordenamientos locales),
+    // "externo <entrada> <salida> [memoria_MB] [directorio_temporal]" o
+    // "conteo [clave_mínima clave_máxima]" (counting sort distribuido) o
+    // "registros [directo|indice]" (registros clave/carga, por defecto ambos modos)
+    int modo = MODO_ARBOL;
+
+    // El proceso 0 lee n y genera/distribuye los datos
+    if (mi_rango == 0) {
+        std::cout << "=== MERGE SORT PARALELO CON MPI ===" << std::endl;
+        std::cout << "Ingrese el número total de elementos (n): ";
+        std::cin >> n_total;
+
+        if (argc > 1 && strcmp(argv[1], "secuencial") == 0) modo = MODO_SECUENCIAL;
+        if (argc > 1 && strcmp(argv[1], "muestreo") == 0) modo = MODO_MUESTREO;
+        if (argc > 1 && strcmp(argv[1], "local") == 0) modo = MODO_LOCAL;
+        if (argc > 1 && strcmp(argv[1], "kvias") == 0) modo = MODO_K_VIAS;
+        if (argc > 1 && strcmp(argv[1], "externo") == 0) modo = MODO_EXTERNO;
+        if (argc > 1 && strcmp(argv[1], "conteo") == 0) modo = MODO_CONTEO;
+        if (argc > 1 && strcmp(argv[1], "registros") == 0) modo = MODO_REGISTROS;
+
+        // Verificar que n es divisible por el número de procesos
+        if (n_total % numero_procesos != 0) {
+            std::cout << "Ajustando n para que sea divisible por " << numero_procesos << " procesos" << std::endl;
+            n_total = (n_total / numero_procesos) * numero_procesos;
+            std::cout << "Nuevo n: " << n_total << std::endl;
+        }
+
+        // En modo muestreo cada proceso genera su propia porción
+        if (modo == MODO_MUESTREO) {
+            std::cout << "Modo sample sort: cada proceso genera sus datos entre 1 y 1000" << std::endl;
+        }
+    }
+
+    // Distribuir n a todos los procesos
+    MPI_Bcast(&n_total, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Bcast(&modo, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+    if (modo == MODO_MUESTREO) {
+        ordenar_por_muestreo(n_total, mi_rango, numero_procesos);
+    } else if (modo == MODO_EXTERNO) {
+        std::string ruta_entrada = "entrada.bin", ruta_salida = "salida.bin", directorio_temporal = "/tmp";
+        int memoria_mb = 64;
+        if (mi_rango == 0) {
+            if (argc > 2) ruta_entrada = argv[2];
+            if (argc > 3) ruta_salida = argv[3];
+            if (argc > 4) memoria_mb = std::max(1, atoi(argv[4]));
+            if (argc > 5) directorio_temporal = argv[5];
+        }
+        difundir_cadena(ruta_entrada, mi_rango);
+        difundir_cadena(ruta_salida, mi_rango);
+        difundir_cadena(directorio_temporal, mi_rango);
+        MPI_Bcast(&memoria_mb, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+        ordenar_externo(ruta_entrada, ruta_salida, memoria_mb, directorio_temporal,
+                        n_total, mi_rango, numero_procesos);
+    } else if (modo == MODO_CONTEO) {
+        // Sin rango explícito (mínimo > máximo) se detecta a partir de los datos
+        int rango_claves[2] = {1, 0};
+        if (mi_rango == 0 && argc > 3) {
+            rango_claves[0] = atoi(argv[2]);
+            rango_claves[1] = atoi(argv[3]);
+        }
+        MPI_Bcast(rango_claves, 2, MPI_INT, 0, MPI_COMM_WORLD);
+        ordenar_por_conteo(n_total, mi_rango, numero_procesos, rango_claves[0], rango_claves[1]);
+    } else if (modo == MODO_REGISTROS) {
+        // 1 = directo, 2 = clave-índice, 3 = ambos sobre la misma entrada
+        int variantes = 3;
+        if (mi_rango == 0 && argc > 2) {
+            if (strcmp(argv[2], "directo") == 0) variantes = 1;
+            if (strcmp(argv[2], "indice") == 0) variantes = 2;
+        }
+        MPI_Bcast(&variantes, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        ordenar_registros(n_total, mi_rango, numero_procesos, (variantes & 1) != 0, (variantes & 2) != 0);
+    } else if (modo == MODO_LOCAL) {
+        if (mi_rango == 0) {
+            std::cout << "Hilos de ordenamiento local: " << numero_hilos << std::endl;
+            comparar_ordenamientos_locales(n_total);
+        }
+    } else {
+        ordenar_y_recolectar(n_total, modo, numero_hilos, mi_rango, numero_procesos);
+    }
+
+    reportar_fases(MPI_COMM_WORLD);
+    reportar_contadores(MPI_COMM_WORLD);
+    reportar_pool(MPI_COMM_WORLD);
+    pool_buffers().vaciar();
     MPI_Finalize();
     return 0;
-}
\ No newline at end of file
+}
+#endif
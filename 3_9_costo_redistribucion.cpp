@@ -4,14 +4,1104 @@
 #include <chrono>
 #include <iomanip>
 #include <algorithm>
+#include <string>
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
+#include "temporizador_fases.h"
 
+// Repeticiones medidas (tras una de calentamiento) por estrategia y sentido
+const int REPETICIONES = 10;
+
+// Estrategias de redistribución bloques ↔ cíclica
+enum Estrategia {
+    ESTRATEGIA_RAIZ,       // MPI_Gather al proceso 0, permutación serial y MPI_Scatter
+    ESTRATEGIA_ALLTOALLV,  // empaquetado local y un único MPI_Alltoall/MPI_Alltoallv
+    ESTRATEGIA_ALLTOALLW,  // tipos derivados con paso p y un único MPI_Alltoallw, sin copias
+    ESTRATEGIA_PLAN,       // plan genérico precalculado (listas de índices por proceso)
+    ESTRATEGIA_SENDRECV_LINEAL,  // plan con p - 1 rondas de MPI_Sendrecv
+    ESTRATEGIA_SENDRECV_LOG,     // plan con log p rondas de MPI_Sendrecv (Bruck)
+    ESTRATEGIA_VECINOS,          // plan con MPI_Neighbor_alltoallv
+    ESTRATEGIA_PUT,              // plan con MPI_Put en una ventana
+    NUMERO_ESTRATEGIAS
+};
+const char* NOMBRES_ESTRATEGIAS[NUMERO_ESTRATEGIAS] = {"Gather/Scatter en P0", "Alltoallv empaquetado",
+                                                       "Alltoallw con paso p", "Plan genérico",
+                                                       "Sendrecv p-1 rondas", "Sendrecv log p rondas",
+                                                       "Neighbor_alltoallv", "Put en ventana"};
+// Identificadores cortos para el CSV del barrido
+const char* CLAVES_ESTRATEGIAS[NUMERO_ESTRATEGIAS] = {"gather_scatter", "alltoallv", "alltoallw", "plan_alltoallv",
+                                                      "sendrecv_lineal", "sendrecv_log", "neighbor_alltoallv",
+                                                      "put"};
+
+// Rellena con espacios a "ancho" caracteres visibles (los caracteres UTF-8
+// como "→" o "í" ocupan más de un byte, por eso no alcanza con std::setw)
+std::string rellenar(const std::string& texto, int ancho) {
+    int visibles = 0;
+    for (unsigned char c : texto) {
+        if ((c & 0xC0) != 0x80) visibles++;
+    }
+    return texto + std::string(std::max(0, ancho - visibles), ' ');
+}
+
+// Cantidad de índices g en [0, limite) con g % p == resto
+int contar_congruentes(long long limite, int resto, int p) {
+    return limite > resto ? (int)((limite - resto + p - 1) / p) : 0;
+}
+
+// Patrón de intercambio directo entre la distribución por bloques (m elementos
+// contiguos por proceso) y la cíclica (el elemento g vive en g % p). Con cada
+// proceso par q:
+// - lado por bloques: cuentas_bloques[q] elementos del bloque propio, con paso p
+//   desde inicio_bloques[q] (los que en la cíclica pertenecen a q)
+// - lado cíclico: cuentas_ciclica[q] elementos contiguos del arreglo cíclico
+//   propio desde inicio_ciclica[q] (los que en bloques pertenecen a q)
+// En ambos lados los elementos quedan en orden global creciente, así que el
+// lado cíclico nunca necesita empaquetar ni desempaquetar
+struct PatronRedistribucion {
+    int p;
+    std::vector<int> cuentas_bloques, inicio_bloques, desplazamiento_paquete;
+    std::vector<int> cuentas_ciclica, inicio_ciclica;
+    bool cuentas_uniformes;  // m divisible por p: alcanza con MPI_Alltoall
+
+    // Para MPI_Alltoallw: vectores con paso p en el lado por bloques y tramos
+    // contiguos en el lado cíclico (desplazamientos en bytes)
+    std::vector<MPI_Datatype> tipos_bloques, tipos_ciclica;
+    std::vector<int> bytes_inicio_bloques, bytes_inicio_ciclica, unos;
+};
+
+PatronRedistribucion crear_patron(int mi_rango, int p, int m) {
+    PatronRedistribucion patron;
+    patron.p = p;
+    patron.cuentas_bloques.resize(p);
+    patron.inicio_bloques.resize(p);
+    patron.desplazamiento_paquete.resize(p);
+    patron.cuentas_ciclica.resize(p);
+    patron.inicio_ciclica.resize(p);
+    patron.tipos_bloques.resize(p);
+    patron.tipos_ciclica.resize(p);
+    patron.bytes_inicio_bloques.resize(p);
+    patron.bytes_inicio_ciclica.resize(p);
+    patron.unos.assign(p, 1);
+    patron.cuentas_uniformes = (m % p == 0);
+
+    long long inicio_bloque_propio = (long long)mi_rango * m;
+    int empaquetados = 0;
+    for (int q = 0; q < p; q++) {
+        // Elementos de mi bloque que en la cíclica son de q
+        patron.inicio_bloques[q] = (int)(((q - inicio_bloque_propio) % p + p) % p);
+        patron.cuentas_bloques[q] = contar_congruentes(inicio_bloque_propio + m, q, p) -
+                                    contar_congruentes(inicio_bloque_propio, q, p);
+        patron.desplazamiento_paquete[q] = empaquetados;
+        empaquetados += patron.cuentas_bloques[q];
+
+        // Elementos de mi arreglo cíclico que en bloques son de q
+        long long inicio_bloque_q = (long long)q * m;
+        patron.inicio_ciclica[q] = contar_congruentes(inicio_bloque_q, mi_rango, p);
+        patron.cuentas_ciclica[q] = contar_congruentes(inicio_bloque_q + m, mi_rango, p) - patron.inicio_ciclica[q];
+
+        MPI_Type_vector(patron.cuentas_bloques[q], 1, p, MPI_DOUBLE, &patron.tipos_bloques[q]);
+        MPI_Type_commit(&patron.tipos_bloques[q]);
+        MPI_Type_contiguous(patron.cuentas_ciclica[q], MPI_DOUBLE, &patron.tipos_ciclica[q]);
+        MPI_Type_commit(&patron.tipos_ciclica[q]);
+        patron.bytes_inicio_bloques[q] = patron.inicio_bloques[q] * sizeof(double);
+        patron.bytes_inicio_ciclica[q] = patron.inicio_ciclica[q] * sizeof(double);
+    }
+    return patron;
+}
+
+void liberar_patron(PatronRedistribucion& patron) {
+    for (int q = 0; q < patron.p; q++) {
+        MPI_Type_free(&patron.tipos_bloques[q]);
+        MPI_Type_free(&patron.tipos_ciclica[q]);
+    }
+}
+
+// Redistribución original: recolectar todo en el proceso 0, permutar y
+// repartir. Los buffers del vector completo solo existen en el proceso 0
+void bloques_a_ciclica_raiz(std::vector<double>& vector_bloques, std::vector<double>& vector_ciclico,
+                            int mi_rango, int numero_procesos) {
+    int elementos_por_proceso = vector_bloques.size();
+    int n_vector = elementos_por_proceso * numero_procesos;
+    std::vector<double> buffer_envio, buffer_recepcion;
+    if (mi_rango == 0) {
+        buffer_envio.resize(n_vector);
+        buffer_recepcion.resize(n_vector);
+    }
+
+    // Paso 1: Recolectar todos los datos en el proceso 0
+    MPI_Gather(vector_bloques.data(), elementos_por_proceso, MPI_DOUBLE,
+               buffer_recepcion.data(), elementos_por_proceso, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+    // Paso 2: El proceso 0 redistribuye de forma cíclica
+    if (mi_rango == 0) {
+        for (int i = 0; i < n_vector; i++) {
+            int proceso_destino = i % numero_procesos;
+            int indice_local = i / numero_procesos;
+            buffer_envio[proceso_destino * elementos_por_proceso + indice_local] = buffer_recepcion[i];
+        }
+    }
+
+    // Paso 3: Distribuir datos reorganizados
+    MPI_Scatter(buffer_envio.data(), elementos_por_proceso, MPI_DOUBLE,
+                vector_ciclico.data(), elementos_por_proceso, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+}
+
+void ciclica_a_bloques_raiz(std::vector<double>& vector_ciclico, std::vector<double>& vector_bloques,
+                            int mi_rango, int numero_procesos) {
+    int elementos_por_proceso = vector_ciclico.size();
+    int n_vector = elementos_por_proceso * numero_procesos;
+    std::vector<double> buffer_envio, buffer_recepcion;
+    if (mi_rango == 0) {
+        buffer_envio.resize(n_vector);
+        buffer_recepcion.resize(n_vector);
+    }
+
+    // Paso 1: Recolectar todos los datos en el proceso 0
+    MPI_Gather(vector_ciclico.data(), elementos_por_proceso, MPI_DOUBLE,
+               buffer_recepcion.data(), elementos_por_proceso, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+    // Paso 2: El proceso 0 redistribuye por bloques
+    if (mi_rango == 0) {
+        for (int proc = 0; proc < numero_procesos; proc++) {
+            for (int i = 0; i < elementos_por_proceso; i++) {
+                int indice_global = proc * elementos_por_proceso + i;
+                int indice_ciclico = (indice_global % numero_procesos) * elementos_por_proceso +
+                                     (indice_global / numero_procesos);
+                buffer_envio[proc * elementos_por_proceso + i] = buffer_recepcion[indice_ciclico];
+            }
+        }
+    }
+
+    // Paso 3: Distribuir datos reorganizados
+    MPI_Scatter(buffer_envio.data(), elementos_por_proceso, MPI_DOUBLE,
+                vector_bloques.data(), elementos_por_proceso, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+}
+
+// Redistribución directa: cada proceso empaqueta en "paquete" (m elementos)
+// lo que le toca a cada destino y un solo MPI_Alltoall(v) hace el intercambio.
+// Los datos llegan ya en su posición final del arreglo cíclico
+void bloques_a_ciclica_alltoallv(const PatronRedistribucion& patron, std::vector<double>& vector_bloques,
+                                 std::vector<double>& vector_ciclico, std::vector<double>& paquete) {
+    int p = patron.p;
+    for (int q = 0; q < p; q++) {
+        double* salida = paquete.data() + patron.desplazamiento_paquete[q];
+        const double* entrada = vector_bloques.data() + patron.inicio_bloques[q];
+        for (int k = 0; k < patron.cuentas_bloques[q]; k++) salida[k] = entrada[(long long)k * p];
+    }
+
+    if (patron.cuentas_uniformes) {
+        int por_proceso = vector_bloques.size() / p;
+        MPI_Alltoall(paquete.data(), por_proceso, MPI_DOUBLE, vector_ciclico.data(), por_proceso, MPI_DOUBLE,
+                     MPI_COMM_WORLD);
+    } else {
+        MPI_Alltoallv(paquete.data(), patron.cuentas_bloques.data(), patron.desplazamiento_paquete.data(),
+                      MPI_DOUBLE, vector_ciclico.data(), patron.cuentas_ciclica.data(),
+                      patron.inicio_ciclica.data(), MPI_DOUBLE, MPI_COMM_WORLD);
+    }
+}
+
+// Sentido inverso: el lado cíclico envía tramos contiguos y el lado por
+// bloques recibe en "paquete" y desempaqueta con paso p
+void ciclica_a_bloques_alltoallv(const PatronRedistribucion& patron, std::vector<double>& vector_ciclico,
+                                 std::vector<double>& vector_bloques, std::vector<double>& paquete) {
+    int p = patron.p;
+    if (patron.cuentas_uniformes) {
+        int por_proceso = vector_ciclico.size() / p;
+        MPI_Alltoall(vector_ciclico.data(), por_proceso, MPI_DOUBLE, paquete.data(), por_proceso, MPI_DOUBLE,
+                     MPI_COMM_WORLD);
+    } else {
+        MPI_Alltoallv(vector_ciclico.data(), patron.cuentas_ciclica.data(), patron.inicio_ciclica.data(),
+                      MPI_DOUBLE, paquete.data(), patron.cuentas_bloques.data(),
+                      patron.desplazamiento_paquete.data(), MPI_DOUBLE, MPI_COMM_WORLD);
+    }
+
+    for (int q = 0; q < p; q++) {
+        const double* entrada = paquete.data() + patron.desplazamiento_paquete[q];
+        double* salida = vector_bloques.data() + patron.inicio_bloques[q];
+        for (int k = 0; k < patron.cuentas_bloques[q]; k++) salida[(long long)k * p] = entrada[k];
+    }
+}
+
+// Redistribución con tipos derivados: los elementos con paso p se describen
+// con MPI_Type_vector y MPI_Alltoallw los lee o escribe directamente, sin
+// buffer intermedio en la aplicación
+void bloques_a_ciclica_alltoallw(const PatronRedistribucion& patron, std::vector<double>& vector_bloques,
+                                 std::vector<double>& vector_ciclico) {
+    MPI_Alltoallw(vector_bloques.data(), patron.unos.data(), patron.bytes_inicio_bloques.data(),
+                  patron.tipos_bloques.data(), vector_ciclico.data(), patron.unos.data(),
+                  patron.bytes_inicio_ciclica.data(), patron.tipos_ciclica.data(), MPI_COMM_WORLD);
+}
+
+void ciclica_a_bloques_alltoallw(const PatronRedistribucion& patron, std::vector<double>& vector_ciclico,
+                                 std::vector<double>& vector_bloques) {
+    MPI_Alltoallw(vector_ciclico.data(), patron.unos.data(), patron.bytes_inicio_ciclica.data(),
+                  patron.tipos_ciclica.data(), vector_bloques.data(), patron.unos.data(),
+                  patron.bytes_inicio_bloques.data(), patron.tipos_bloques.data(), MPI_COMM_WORLD);
+}
+
+// ==============================================
+// PLAN DE REDISTRIBUCIÓN GENÉRICO
+// ==============================================
+
+// Distribución bloque-cíclica de n elementos entre p procesos con bloques de
+// b elementos: el bloque k (elementos [k*b, (k+1)*b)) vive en el proceso k % p.
+// La distribución por bloques es el caso b = ceil(n/p) y la cíclica b = 1;
+// n no necesita ser múltiplo de p ni de b
+struct Distribucion {
+    long long n;
+    int p;
+    long long tamano_bloque;
+};
+
+Distribucion distribucion_bloque_ciclica(long long n, int p, long long tamano_bloque) {
+    Distribucion d;
+    d.n = n;
+    d.p = p;
+    d.tamano_bloque = std::max(1LL, tamano_bloque);
+    return d;
+}
+
+Distribucion distribucion_bloques(long long n, int p) {
+    return distribucion_bloque_ciclica(n, p, (n + p - 1) / p);
+}
+
+Distribucion distribucion_ciclica(long long n, int p) {
+    return distribucion_bloque_ciclica(n, p, 1);
+}
+
+std::string describir_distribucion(const Distribucion& d) {
+    if (d.tamano_bloque == 1) return "cíclica";
+    if (d.tamano_bloque == std::max(1LL, (d.n + d.p - 1) / d.p)) return "bloques";
+    return "bloque-cíclica(" + std::to_string(d.tamano_bloque) + ")";
+}
+
+int propietario(const Distribucion& d, long long g) {
+    return (int)((g / d.tamano_bloque) % d.p);
+}
+
+// Posición global del elemento local l del proceso r (crece con l)
+long long indice_global(const Distribucion& d, int r, long long l) {
+    long long b = d.tamano_bloque;
+    return (l / b) * b * d.p + r * b + l % b;
+}
+
+long long elementos_locales(const Distribucion& d, int r) {
+    long long b = d.tamano_bloque;
+    long long ciclos = d.n / (b * d.p);
+    long long resto = d.n - ciclos * b * d.p;
+    return ciclos * b + std::min(b, std::max(0LL, resto - r * b));
+}
+
+// Formas de hacer el intercambio de un plan (entre empaquetar y desempaquetar)
+enum Intercambio {
+    INTERCAMBIO_ALLTOALLV,        // un único MPI_Alltoallv
+    INTERCAMBIO_SENDRECV_LINEAL,  // p - 1 rondas de MPI_Sendrecv con el proceso r + k
+    INTERCAMBIO_SENDRECV_LOG,     // ceil(log2 p) rondas de MPI_Sendrecv (algoritmo de Bruck)
+    INTERCAMBIO_VECINOS,          // MPI_Neighbor_alltoallv sobre un grafo con solo los pares con datos
+    INTERCAMBIO_PUT               // MPI_Put en una ventana sobre el buffer de recepción, entre fences
+};
+
+// Plan de redistribución de "origen" a "destino": las listas de índices por
+// proceso par y los buffers de empaquetado se calculan una sola vez y cada
+// ejecución solo empaqueta, intercambia y desempaqueta. Como en toda
+// distribución bloque-cíclica el índice local crece con el global, emisor y
+// receptor recorren sus elementos en el mismo orden global y pueden armar el
+// plan cada uno por su lado, sin comunicarse. Los recursos propios de cada
+// intercambio (grafo de vecinos, ventana) se crean en su primera ejecución
+struct PlanRedistribucion {
+    Distribucion origen, destino;
+    int mi_rango;
+    std::vector<int> cuentas_envio, desplazamientos_envio, cuentas_recepcion, desplazamientos_recepcion;
+    std::vector<int> indices_envio;      // posición local en el origen de cada elemento empaquetado
+    std::vector<int> indices_recepcion;  // posición local en el destino de cada elemento recibido
+    std::vector<double> buffer_envio, buffer_recepcion;
+    long long elementos_remotos;         // elementos que salen hacia otros procesos
+
+    // MPI_Neighbor_alltoallv: cuentas y desplazamientos en el orden de los vecinos
+    MPI_Comm comunicador_vecinos;
+    std::vector<int> cuentas_envio_vecinos, desplazamientos_envio_vecinos;
+    std::vector<int> cuentas_recepcion_vecinos, desplazamientos_recepcion_vecinos;
+
+    // MPI_Put: ventana sobre buffer_recepcion y dónde escribir en cada destino
+    MPI_Win ventana;
+    std::vector<int> desplazamientos_remotos;
+
+    // Bruck: bloques en tránsito y bytes enviados y recibidos en la última ejecución
+    std::vector<std::vector<double> > bloques_bruck;
+    long long bytes_bruck;
+};
+
+// Agrupa por proceso los elementos locales de "propia" según su dueño en "otra"
+void agrupar_por_proceso(const Distribucion& propia, const Distribucion& otra, int mi_rango,
+                         std::vector<int>& cuentas, std::vector<int>& desplazamientos, std::vector<int>& indices) {
+    int p = propia.p;
+    int locales = (int)elementos_locales(propia, mi_rango);
+    std::vector<int> duenos(locales);
+    cuentas.assign(p, 0);
+    for (int l = 0; l < locales; l++) {
+        duenos[l] = propietario(otra, indice_global(propia, mi_rango, l));
+        cuentas[duenos[l]]++;
+    }
+
+    desplazamientos.assign(p, 0);
+    for (int q = 1; q < p; q++) desplazamientos[q] = desplazamientos[q - 1] + cuentas[q - 1];
+
+    std::vector<int> posicion(desplazamientos);
+    indices.resize(locales);
+    for (int l = 0; l < locales; l++) indices[posicion[duenos[l]]++] = l;
+}
+
+PlanRedistribucion crear_plan(const Distribucion& origen, const Distribucion& destino, int mi_rango) {
+    PlanRedistribucion plan;
+    plan.origen = origen;
+    plan.destino = destino;
+    agrupar_por_proceso(origen, destino, mi_rango, plan.cuentas_envio, plan.desplazamientos_envio,
+                        plan.indices_envio);
+    agrupar_por_proceso(destino, origen, mi_rango, plan.cuentas_recepcion, plan.desplazamientos_recepcion,
+                        plan.indices_recepcion);
+    plan.buffer_envio.resize(plan.indices_envio.size());
+    plan.buffer_recepcion.resize(plan.indices_recepcion.size());
+    plan.elementos_remotos = plan.indices_envio.size() - plan.cuentas_envio[mi_rango];
+    plan.mi_rango = mi_rango;
+    plan.comunicador_vecinos = MPI_COMM_NULL;
+    plan.ventana = MPI_WIN_NULL;
+    plan.bytes_bruck = 0;
+    return plan;
+}
+
+void liberar_plan(PlanRedistribucion& plan) {
+    if (plan.comunicador_vecinos != MPI_COMM_NULL) MPI_Comm_free(&plan.comunicador_vecinos);
+    if (plan.ventana != MPI_WIN_NULL) MPI_Win_free(&plan.ventana);
+}
+
+// p - 1 rondas: en la ronda k cada proceso envía a r + k y recibe de r - k,
+// así en cada ronda todos los procesos participan en exactamente un par
+void intercambio_sendrecv_lineal(PlanRedistribucion& plan) {
+    int p = plan.origen.p, r = plan.mi_rango;
+    std::copy(plan.buffer_envio.begin() + plan.desplazamientos_envio[r],
+              plan.buffer_envio.begin() + plan.desplazamientos_envio[r] + plan.cuentas_envio[r],
+              plan.buffer_recepcion.begin() + plan.desplazamientos_recepcion[r]);
+    for (int k = 1; k < p; k++) {
+        int destino = (r + k) % p, fuente = (r - k + p) % p;
+        MPI_Sendrecv(plan.buffer_envio.data() + plan.desplazamientos_envio[destino], plan.cuentas_envio[destino],
+                     MPI_DOUBLE, destino, 0,
+                     plan.buffer_recepcion.data() + plan.desplazamientos_recepcion[fuente],
+                     plan.cuentas_recepcion[fuente], MPI_DOUBLE, fuente, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    }
+}
+
+// Algoritmo de Bruck: el bloque i de cada proceso va a r + i y avanza 2^k
+// procesos en la ronda k si el bit k de i está prendido, así que en
+// ceil(log2 p) rondas llega a destino. Cada ronda envía unos p/2 bloques
+// (con sus tamaños, que varían) a cambio de pagar la latencia solo log p veces
+void intercambio_sendrecv_log(PlanRedistribucion& plan) {
+    int p = plan.origen.p, r = plan.mi_rango;
+    std::vector<std::vector<double> >& bloques = plan.bloques_bruck;
+    bloques.resize(p);
+    for (int i = 0; i < p; i++) {
+        int q = (r + i) % p;
+        bloques[i].assign(plan.buffer_envio.begin() + plan.desplazamientos_envio[q],
+                          plan.buffer_envio.begin() + plan.desplazamientos_envio[q] + plan.cuentas_envio[q]);
+    }
+
+    plan.bytes_bruck = 0;
+    std::vector<int> indices, tamanos_salida, tamanos_entrada;
+    std::vector<double> salida, entrada;
+    for (int paso = 1; paso < p; paso <<= 1) {
+        int destino = (r + paso) % p, fuente = (r - paso + p) % p;
+        indices.clear();
+        tamanos_salida.clear();
+        salida.clear();
+        for (int i = 0; i < p; i++) {
+            if (!(i & paso)) continue;
+            indices.push_back(i);
+            tamanos_salida.push_back(bloques[i].size());
+            salida.insert(salida.end(), bloques[i].begin(), bloques[i].end());
+        }
+
+        int cantidad = indices.size();
+        tamanos_entrada.resize(cantidad);
+        MPI_Sendrecv(tamanos_salida.data(), cantidad, MPI_INT, destino, 1, tamanos_entrada.data(), cantidad,
+                     MPI_INT, fuente, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        int total_entrada = 0;
+        for (int t : tamanos_entrada) total_entrada += t;
+        entrada.resize(total_entrada);
+        MPI_Sendrecv(salida.data(), salida.size(), MPI_DOUBLE, destino, 0, entrada.data(), total_entrada,
+                     MPI_DOUBLE, fuente, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        plan.bytes_bruck += (long long)(salida.size() + total_entrada) * sizeof(double) +
+                            2LL * cantidad * sizeof(int);
+
+        int posicion = 0;
+        for (int j = 0; j < cantidad; j++) {
+            bloques[indices[j]].assign(entrada.begin() + posicion, entrada.begin() + posicion + tamanos_entrada[j]);
+            posicion += tamanos_entrada[j];
+        }
+    }
+
+    // Al final el bloque i vino del proceso r - i
+    for (int i = 0; i < p; i++) {
+        int q = (r - i + p) % p;
+        std::copy(bloques[i].begin(), bloques[i].end(),
+                  plan.buffer_recepcion.begin() + plan.desplazamientos_recepcion[q]);
+    }
+}
+
+// Grafo distribuido con solo los pares que intercambian datos: para
+// redistribuciones dispersas cada proceso solo trata con sus vecinos reales
+void intercambio_vecinos(PlanRedistribucion& plan) {
+    int p = plan.origen.p;
+    if (plan.comunicador_vecinos == MPI_COMM_NULL) {
+        std::vector<int> destinos, fuentes;
+        for (int q = 0; q < p; q++) {
+            if (plan.cuentas_envio[q] > 0) {
+                destinos.push_back(q);
+                plan.cuentas_envio_vecinos.push_back(plan.cuentas_envio[q]);
+                plan.desplazamientos_envio_vecinos.push_back(plan.desplazamientos_envio[q]);
+            }
+            if (plan.cuentas_recepcion[q] > 0) {
+                fuentes.push_back(q);
+                plan.cuentas_recepcion_vecinos.push_back(plan.cuentas_recepcion[q]);
+                plan.desplazamientos_recepcion_vecinos.push_back(plan.desplazamientos_recepcion[q]);
+            }
+        }
+        MPI_Dist_graph_create_adjacent(MPI_COMM_WORLD, fuentes.size(), fuentes.data(), MPI_UNWEIGHTED,
+                                       destinos.size(), destinos.data(), MPI_UNWEIGHTED, MPI_INFO_NULL, 0,
+                                       &plan.comunicador_vecinos);
+    }
+    MPI_Neighbor_alltoallv(plan.buffer_envio.data(), plan.cuentas_envio_vecinos.data(),
+                           plan.desplazamientos_envio_vecinos.data(), MPI_DOUBLE, plan.buffer_recepcion.data(),
+                           plan.cuentas_recepcion_vecinos.data(), plan.desplazamientos_recepcion_vecinos.data(),
+                           MPI_DOUBLE, plan.comunicador_vecinos);
+}
+
+// Comunicación de un solo lado: cada proceso escribe con MPI_Put su paquete
+// directamente en el buffer de recepción de cada destino. Los desplazamientos
+// remotos se obtienen una sola vez con MPI_Alltoall
+void intercambio_put(PlanRedistribucion& plan) {
+    int p = plan.origen.p;
+    if (p == 1) {
+        // Sin procesos remotos no hace falta ventana (y hay implementaciones
+        // que no pueden crearla sin un transporte RMA)
+        std::copy(plan.buffer_envio.begin(), plan.buffer_envio.end(), plan.buffer_recepcion.begin());
+        return;
+    }
+    if (plan.ventana == MPI_WIN_NULL) {
+        plan.desplazamientos_remotos.resize(p);
+        MPI_Alltoall(plan.desplazamientos_recepcion.data(), 1, MPI_INT, plan.desplazamientos_remotos.data(), 1,
+                     MPI_INT, MPI_COMM_WORLD);
+        MPI_Win_create(plan.buffer_recepcion.data(), plan.buffer_recepcion.size() * sizeof(double),
+                       sizeof(double), MPI_INFO_NULL, MPI_COMM_WORLD, &plan.ventana);
+    }
+    MPI_Win_fence(MPI_MODE_NOPRECEDE, plan.ventana);
+    for (int q = 0; q < p; q++) {
+        if (plan.cuentas_envio[q] == 0) continue;
+        MPI_Put(plan.buffer_envio.data() + plan.desplazamientos_envio[q], plan.cuentas_envio[q], MPI_DOUBLE, q,
+                plan.desplazamientos_remotos[q], plan.cuentas_envio[q], MPI_DOUBLE, plan.ventana);
+    }
+    MPI_Win_fence(MPI_MODE_NOSUCCEED, plan.ventana);
+}
+
+// Redistribuye "entrada" (distribución origen) en "salida" (distribución destino)
+void ejecutar_plan(PlanRedistribucion& plan, const double* entrada, double* salida,
+                   int intercambio = INTERCAMBIO_ALLTOALLV) {
+    int enviados = plan.indices_envio.size();
+    for (int k = 0; k < enviados; k++) plan.buffer_envio[k] = entrada[plan.indices_envio[k]];
+
+    switch (intercambio) {
+    case INTERCAMBIO_ALLTOALLV:
+        MPI_Alltoallv(plan.buffer_envio.data(), plan.cuentas_envio.data(), plan.desplazamientos_envio.data(),
+                      MPI_DOUBLE, plan.buffer_recepcion.data(), plan.cuentas_recepcion.data(),
+                      plan.desplazamientos_recepcion.data(), MPI_DOUBLE, MPI_COMM_WORLD);
+        break;
+    case INTERCAMBIO_SENDRECV_LINEAL: intercambio_sendrecv_lineal(plan); break;
+    case INTERCAMBIO_SENDRECV_LOG: intercambio_sendrecv_log(plan); break;
+    case INTERCAMBIO_VECINOS: intercambio_vecinos(plan); break;
+    case INTERCAMBIO_PUT: intercambio_put(plan); break;
+    }
+
+    int recibidos = plan.indices_recepcion.size();
+    for (int k = 0; k < recibidos; k++) salida[plan.indices_recepcion[k]] = plan.buffer_recepcion[k];
+}
+
+int intercambio_de_estrategia(int estrategia) {
+    switch (estrategia) {
+    case ESTRATEGIA_SENDRECV_LINEAL: return INTERCAMBIO_SENDRECV_LINEAL;
+    case ESTRATEGIA_SENDRECV_LOG: return INTERCAMBIO_SENDRECV_LOG;
+    case ESTRATEGIA_VECINOS: return INTERCAMBIO_VECINOS;
+    case ESTRATEGIA_PUT: return INTERCAMBIO_PUT;
+    default: return INTERCAMBIO_ALLTOALLV;
+    }
+}
+
+// Bytes que este proceso envía más los que recibe de otros procesos en una
+// redistribución con la estrategia dada (lo que realmente pasa por la red)
+long long bytes_movidos(int estrategia, const PlanRedistribucion& plan, int elementos_por_proceso) {
+    int p = plan.origen.p, r = plan.mi_rango;
+    if (p == 1) return 0;
+    if (estrategia == ESTRATEGIA_RAIZ) {
+        // Gather + Scatter: el proceso 0 recibe y envía las porciones de todos
+        long long porcion = (long long)elementos_por_proceso * sizeof(double);
+        return r == 0 ? 2 * (p - 1) * porcion : 2 * porcion;
+    }
+    if (estrategia == ESTRATEGIA_SENDRECV_LOG) return plan.bytes_bruck;
+    long long enviados = plan.indices_envio.size() - plan.cuentas_envio[r];
+    long long recibidos = plan.indices_recepcion.size() - plan.cuentas_recepcion[r];
+    return (enviados + recibidos) * (long long)sizeof(double);
+}
+
+void bloques_a_ciclica(int estrategia, const PatronRedistribucion& patron, PlanRedistribucion& plan,
+                       std::vector<double>& vector_bloques, std::vector<double>& vector_ciclico,
+                       std::vector<double>& paquete, int mi_rango) {
+    switch (estrategia) {
+    case ESTRATEGIA_RAIZ: bloques_a_ciclica_raiz(vector_bloques, vector_ciclico, mi_rango, patron.p); break;
+    case ESTRATEGIA_ALLTOALLV: bloques_a_ciclica_alltoallv(patron, vector_bloques, vector_ciclico, paquete); break;
+    case ESTRATEGIA_ALLTOALLW: bloques_a_ciclica_alltoallw(patron, vector_bloques, vector_ciclico); break;
+    case ESTRATEGIA_PLAN: ejecutar_plan(plan, vector_bloques.data(), vector_ciclico.data()); break;
+    default:
+        ejecutar_plan(plan, vector_bloques.data(), vector_ciclico.data(), intercambio_de_estrategia(estrategia));
+        break;
+    }
+}
+
+void ciclica_a_bloques(int estrategia, const PatronRedistribucion& patron, PlanRedistribucion& plan,
+                       std::vector<double>& vector_ciclico, std::vector<double>& vector_bloques,
+                       std::vector<double>& paquete, int mi_rango) {
+    switch (estrategia) {
+    case ESTRATEGIA_RAIZ: ciclica_a_bloques_raiz(vector_ciclico, vector_bloques, mi_rango, patron.p); break;
+    case ESTRATEGIA_ALLTOALLV: ciclica_a_bloques_alltoallv(patron, vector_ciclico, vector_bloques, paquete); break;
+    case ESTRATEGIA_ALLTOALLW: ciclica_a_bloques_alltoallw(patron, vector_ciclico, vector_bloques); break;
+    case ESTRATEGIA_PLAN: ejecutar_plan(plan, vector_ciclico.data(), vector_bloques.data()); break;
+    default:
+        ejecutar_plan(plan, vector_ciclico.data(), vector_bloques.data(), intercambio_de_estrategia(estrategia));
+        break;
+    }
+}
+
+// Comprueba en todos los procesos que ambos arreglos tengan los valores
+// esperados (el elemento global g vale g + 1)
+bool verificar_distribuciones(const std::vector<double>& vector_bloques, const std::vector<double>& vector_ciclico,
+                              int mi_rango, int numero_procesos) {
+    int elementos_por_proceso = vector_bloques.size();
+    int correcto_local = 1;
+    for (int i = 0; i < elementos_por_proceso; i++) {
+        if (vector_bloques[i] != (double)mi_rango * elementos_por_proceso + i + 1) correcto_local = 0;
+        if (vector_ciclico[i] != (double)i * numero_procesos + mi_rango + 1) correcto_local = 0;
+    }
+    int correcto_global;
+    MPI_Allreduce(&correcto_local, &correcto_global, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+    return correcto_global != 0;
+}
+
+// Recorre una cadena de distribuciones (bloques → cíclica → bloque-cíclica(4)
+// → bloque-cíclica(16) → bloques) con planes creados una sola vez y ejecutados
+// REPETICIONES veces, como haría una aplicación que alterna distribuciones
+// entre fases. n puede no ser múltiplo de p
+void recorrer_distribuciones(long long n, int mi_rango, int numero_procesos) {
+    std::vector<Distribucion> cadena;
+    cadena.push_back(distribucion_bloques(n, numero_procesos));
+    cadena.push_back(distribucion_ciclica(n, numero_procesos));
+    cadena.push_back(distribucion_bloque_ciclica(n, numero_procesos, 4));
+    cadena.push_back(distribucion_bloque_ciclica(n, numero_procesos, 16));
+    cadena.push_back(distribucion_bloques(n, numero_procesos));
+    int numero_planes = cadena.size() - 1;
+
+    // Creación de los planes (una sola vez)
+    std::vector<PlanRedistribucion> planes;
+    planes.reserve(numero_planes);
+    std::vector<double> tiempos_creacion(numero_planes);
+    for (int i = 0; i < numero_planes; i++) {
+        double inicio = MPI_Wtime();
+        planes.push_back(crear_plan(cadena[i], cadena[i + 1], mi_rango));
+        tiempos_creacion[i] = MPI_Wtime() - inicio;
+    }
+
+    // Un arreglo por distribución de la cadena; el elemento global g vale g + 1
+    std::vector<std::vector<double> > arreglos(cadena.size());
+    for (int i = 0; i < (int)cadena.size(); i++) arreglos[i].resize(elementos_locales(cadena[i], mi_rango));
+    for (int l = 0; l < (int)arreglos[0].size(); l++) arreglos[0][l] = indice_global(cadena[0], mi_rango, l) + 1;
+
+    std::vector<double> tiempos_minimos(numero_planes, 0.0), tiempos_promedio(numero_planes, 0.0);
+    int correcto_local = 1;
+    for (int repeticion = -1; repeticion < REPETICIONES; repeticion++) {
+        std::vector<double> tiempos(numero_planes), tiempos_max(numero_planes);
+        for (int i = 0; i < numero_planes; i++) {
+            MPI_Barrier(MPI_COMM_WORLD);
+            double inicio = MPI_Wtime();
+            ejecutar_plan(planes[i], arreglos[i].data(), arreglos[i + 1].data());
+            tiempos[i] = MPI_Wtime() - inicio;
+
+            for (int l = 0; l < (int)arreglos[i + 1].size(); l++) {
+                if (arreglos[i + 1][l] != indice_global(cadena[i + 1], mi_rango, l) + 1) correcto_local = 0;
+            }
+        }
+        MPI_Reduce(tiempos.data(), tiempos_max.data(), numero_planes, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        if (repeticion < 0) continue;  // calentamiento
+        for (int i = 0; i < numero_planes; i++) {
+            if (repeticion == 0 || tiempos_max[i] < tiempos_minimos[i]) tiempos_minimos[i] = tiempos_max[i];
+            tiempos_promedio[i] += tiempos_max[i] / REPETICIONES;
+        }
+    }
+
+    int correcto_global;
+    MPI_Allreduce(&correcto_local, &correcto_global, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+    std::vector<double> creacion_max(numero_planes);
+    MPI_Reduce(tiempos_creacion.data(), creacion_max.data(), numero_planes, MPI_DOUBLE, MPI_MAX, 0,
+               MPI_COMM_WORLD);
+    std::vector<long long> remotos(numero_planes), remotos_total(numero_planes);
+    for (int i = 0; i < numero_planes; i++) remotos[i] = planes[i].elementos_remotos;
+    MPI_Reduce(remotos.data(), remotos_total.data(), numero_planes, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    if (mi_rango == 0) {
+        std::cout << "\nPlanes de redistribución genéricos (n = " << n << ", " << REPETICIONES
+                  << " ejecuciones por plan):" << std::endl;
+        std::cout << "  " << rellenar("Origen → Destino", 44) << std::setw(12)
+                  << "Creación" << std::setw(12) << "Ejec. mín." << std::setw(12) << "Ejec. prom." << std::setw(14)
+                  << "Remotos" << std::endl;
+        std::cout << std::fixed << std::setprecision(6);
+        for (int i = 0; i < numero_planes; i++) {
+            std::string nombre = describir_distribucion(cadena[i]) + " → " + describir_distribucion(cadena[i + 1]);
+            std::cout << "  " << rellenar(nombre, 44) << std::setw(12)
+                      << creacion_max[i] << std::setw(12) << tiempos_minimos[i] << std::setw(12)
+                      << tiempos_promedio[i] << std::setw(14) << remotos_total[i] << std::endl;
+        }
+        std::cout << "  ¿Valores correctos tras cada redistribución? " << (correcto_global ? "✅ SÍ" : "❌ NO")
+                  << std::endl;
+    }
+
+    for (PlanRedistribucion& plan : planes) liberar_plan(plan);
+}
+
+// Repeticiones del barrido según el tamaño: más para vectores chicos, donde
+// el ruido pesa más, sin pasar de unos 2^25 elementos redistribuidos en total
+int repeticiones_para_tamano(long long n) {
+    return (int)std::max(5LL, std::min(100LL, (1LL << 25) / std::max(n, 1LL)));
+}
+
+// Modo barrido: para n = p^2, 2 p^2, 4 p^2, ... hasta n_maximo mide todas las
+// estrategias en ambos sentidos. Por repetición se toma el tiempo máximo entre
+// procesos; se reportan mínimo, mediana y máximo de esas repeticiones y los
+// bytes que realmente envía más recibe el proceso más cargado. Resultado en
+// redistribucion_barrido.csv
+void barrido_estrategias(long long n_maximo, int mi_rango, int numero_procesos) {
+    int p = numero_procesos;
+    std::ofstream csv;
+    if (mi_rango == 0) {
+        csv.open("redistribucion_barrido.csv");
+        csv << "estrategia,sentido,n,procesos,repeticiones,bytes_por_proceso_max,"
+               "t_min_s,t_mediana_s,t_max_s,ancho_banda_GBs,correcto\n";
+        std::cout << "\n=== BARRIDO DE ESTRATEGIAS DE REDISTRIBUCIÓN ===" << std::endl;
+        std::cout << "Procesos: " << p << ", n desde " << (long long)p * p << " hasta " << n_maximo << std::endl;
+    }
+
+    for (long long n = (long long)p * p; n <= n_maximo; n *= 2) {
+        int m = (int)(n / p);
+        int repeticiones = repeticiones_para_tamano(n);
+        std::vector<double> vector_bloques(m), vector_ciclico(m), paquete(m);
+        for (int i = 0; i < m; i++) vector_bloques[i] = (double)mi_rango * m + i + 1;
+
+        PatronRedistribucion patron = crear_patron(mi_rango, p, m);
+        PlanRedistribucion plan_bloques_a_ciclica = crear_plan(distribucion_bloques(n, p), distribucion_ciclica(n, p),
+                                                               mi_rango);
+        PlanRedistribucion plan_ciclica_a_bloques = crear_plan(distribucion_ciclica(n, p), distribucion_bloques(n, p),
+                                                               mi_rango);
+
+        if (mi_rango == 0) {
+            std::cout << "\nn = " << n << " (" << repeticiones << " repeticiones)" << std::endl;
+            std::cout << "  " << rellenar("Estrategia", 24) << rellenar("Sentido", 10) << std::setw(12) << "Mín. (s)"
+                      << std::setw(12) << "Mediana (s)" << std::setw(12) << "Máx. (s)" << std::setw(14)
+                      << "MB/proceso" << std::setw(10) << "GB/s" << std::endl;
+        }
+
+        for (int estrategia = 0; estrategia < NUMERO_ESTRATEGIAS; estrategia++) {
+            std::vector<double> tiempos[2];
+            int correcto = 1;
+            long long bytes[2] = {0, 0};
+
+            for (int repeticion = -1; repeticion < repeticiones; repeticion++) {
+                double medidos[2], maximos[2];
+                std::fill(vector_ciclico.begin(), vector_ciclico.end(), 0.0);
+                MPI_Barrier(MPI_COMM_WORLD);
+                double inicio = MPI_Wtime();
+                {
+                    TemporizadorFase temporizador(FASE_DISTRIBUCION);
+                    bloques_a_ciclica(estrategia, patron, plan_bloques_a_ciclica, vector_bloques, vector_ciclico,
+                                      paquete, mi_rango);
+                }
+                medidos[0] = MPI_Wtime() - inicio;
+                bytes[0] = bytes_movidos(estrategia, plan_bloques_a_ciclica, m);
+
+                std::fill(vector_bloques.begin(), vector_bloques.end(), 0.0);
+                MPI_Barrier(MPI_COMM_WORLD);
+                inicio = MPI_Wtime();
+                {
+                    TemporizadorFase temporizador(FASE_DISTRIBUCION);
+                    ciclica_a_bloques(estrategia, patron, plan_ciclica_a_bloques, vector_ciclico, vector_bloques,
+                                      paquete, mi_rango);
+                }
+                medidos[1] = MPI_Wtime() - inicio;
+                bytes[1] = bytes_movidos(estrategia, plan_ciclica_a_bloques, m);
+
+                MPI_Allreduce(medidos, maximos, 2, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+                if (!verificar_distribuciones(vector_bloques, vector_ciclico, mi_rango, p)) correcto = 0;
+                if (repeticion < 0) continue;  // calentamiento
+                tiempos[0].push_back(maximos[0]);
+                tiempos[1].push_back(maximos[1]);
+            }
+
+            long long bytes_max[2];
+            MPI_Reduce(bytes, bytes_max, 2, MPI_LONG_LONG, MPI_MAX, 0, MPI_COMM_WORLD);
+
+            if (mi_rango == 0) {
+                TemporizadorFase temporizador(FASE_SALIDA);
+                const char* sentidos[2] = {"bloques_a_ciclica", "ciclica_a_bloques"};
+                const char* sentidos_cortos[2] = {"B → C", "C → B"};
+                for (int sentido = 0; sentido < 2; sentido++) {
+                    std::vector<double>& t = tiempos[sentido];
+                    std::sort(t.begin(), t.end());
+                    double minimo = t.front(), mediana = t[t.size() / 2], maximo = t.back();
+                    double ancho_banda = mediana > 0 ? bytes_max[sentido] / mediana / 1e9 : 0.0;
+
+                    csv << CLAVES_ESTRATEGIAS[estrategia] << "," << sentidos[sentido] << "," << n << "," << p << ","
+                        << repeticiones << "," << bytes_max[sentido] << "," << minimo << "," << mediana << ","
+                        << maximo << "," << ancho_banda << "," << correcto << "\n";
+                    std::cout << "  " << rellenar(NOMBRES_ESTRATEGIAS[estrategia], 24)
+                              << rellenar(sentidos_cortos[sentido], 10) << std::fixed << std::setprecision(6)
+                              << std::setw(12) << minimo << std::setw(12) << mediana << std::setw(12) << maximo
+                              << std::setprecision(3) << std::setw(14) << bytes_max[sentido] / 1048576.0
+                              << std::setw(10) << ancho_banda << (correcto ? "" : "  ❌") << std::endl;
+                }
+            }
+        }
+
+        liberar_plan(plan_bloques_a_ciclica);
+        liberar_plan(plan_ciclica_a_bloques);
+        liberar_patron(patron);
+    }
+
+    if (mi_rango == 0) {
+        std::cout << "\nResultados guardados en redistribucion_barrido.csv" << std::endl;
+        std::cout << "GB/s = bytes enviados más recibidos por el proceso más cargado / mediana" << std::endl;
+    }
+}
+
+// ==============================================
+// REDISTRIBUCIÓN DE MATRICES 2D
+// ==============================================
+
+// Distribución de una matriz filas x columnas sobre una grilla de pr x pc
+// procesos: el proceso r = i * pc + j guarda, por filas (row-major), el bloque
+// (i, j) de filas y columnas repartidas en partes casi iguales. Por bloques de
+// filas es la grilla p x 1, por bloques de columnas 1 x p (como en 3_5) y el
+// mosaico 2D es la grilla más cuadrada posible (como las submatrices de 3_6)
+struct DistribucionMatriz {
+    int filas, columnas;
+    int pr, pc;
+};
+
+DistribucionMatriz matriz_por_filas(int filas, int columnas, int p) {
+    DistribucionMatriz d = {filas, columnas, p, 1};
+    return d;
+}
+
+DistribucionMatriz matriz_por_columnas(int filas, int columnas, int p) {
+    DistribucionMatriz d = {filas, columnas, 1, p};
+    return d;
+}
+
+DistribucionMatriz matriz_en_mosaico(int filas, int columnas, int p) {
+    int dimensiones[2] = {0, 0};
+    MPI_Dims_create(p, 2, dimensiones);
+    DistribucionMatriz d = {filas, columnas, dimensiones[0], dimensiones[1]};
+    return d;
+}
+
+// Con pocos procesos el mosaico puede coincidir con otra distribución
+// (p primo da p x 1), por eso se pasa de qué constructor viene
+std::string describir_matriz(const DistribucionMatriz& d, bool mosaico) {
+    if (mosaico) return "mosaico " + std::to_string(d.pr) + "x" + std::to_string(d.pc);
+    return d.pc == 1 ? "filas" : "columnas";
+}
+
+// Rectángulo de la matriz global: esquina (fila, columna) y dimensiones
+struct Rectangulo {
+    int fila, columna, filas, columnas;
+};
+
+Rectangulo rectangulo_de(const DistribucionMatriz& d, int r) {
+    int i = r / d.pc, j = r % d.pc;
+    Rectangulo rect;
+    rect.fila = (int)((long long)d.filas * i / d.pr);
+    rect.filas = (int)((long long)d.filas * (i + 1) / d.pr) - rect.fila;
+    rect.columna = (int)((long long)d.columnas * j / d.pc);
+    rect.columnas = (int)((long long)d.columnas * (j + 1) / d.pc) - rect.columna;
+    return rect;
+}
+
+Rectangulo transponer(const Rectangulo& a) {
+    Rectangulo t = {a.columna, a.fila, a.columnas, a.filas};
+    return t;
+}
+
+Rectangulo interseccion(const Rectangulo& a, const Rectangulo& b) {
+    Rectangulo c;
+    c.fila = std::max(a.fila, b.fila);
+    c.columna = std::max(a.columna, b.columna);
+    c.filas = std::max(0, std::min(a.fila + a.filas, b.fila + b.filas) - c.fila);
+    c.columnas = std::max(0, std::min(a.columna + a.columnas, b.columna + b.columnas) - c.columna);
+    return c;
+}
+
+// Tipo que describe, dentro del bloque local "local", la submatriz "region"
+// (ambos en coordenadas globales)
+MPI_Datatype tipo_submatriz(const Rectangulo& local, const Rectangulo& region) {
+    int tamanos[2] = {local.filas, local.columnas};
+    int subtamanos[2] = {region.filas, region.columnas};
+    int inicios[2] = {region.fila - local.fila, region.columna - local.columna};
+    MPI_Datatype tipo;
+    MPI_Type_create_subarray(2, tamanos, subtamanos, inicios, MPI_ORDER_C, MPI_DOUBLE, &tipo);
+    MPI_Type_commit(&tipo);
+    return tipo;
+}
+
+// Tipo que recibe una submatriz enviada por filas y la escribe transpuesta:
+// "region" está en coordenadas de la matriz transpuesta. Cada fila recibida es
+// una columna local (vector con paso igual al ancho local) y las filas
+// sucesivas se corren un elemento (hvector). El desplazamiento del inicio va
+// aparte, en bytes
+MPI_Datatype tipo_submatriz_transpuesta(const Rectangulo& local, const Rectangulo& region, int& bytes_inicio) {
+    MPI_Datatype columna, tipo;
+    MPI_Type_vector(region.filas, 1, local.columnas, MPI_DOUBLE, &columna);
+    MPI_Type_create_hvector(region.columnas, 1, sizeof(double), columna, &tipo);
+    MPI_Type_commit(&tipo);
+    MPI_Type_free(&columna);
+    bytes_inicio = (int)(((long long)(region.fila - local.fila) * local.columnas + (region.columna - local.columna)) *
+                         sizeof(double));
+    return tipo;
+}
+
+// Plan de redistribución 2D: para cada proceso par, el tipo derivado de lo
+// que se le envía (intersección del bloque propio en el origen con el suyo en
+// el destino) y de lo que se recibe de él. Con transponer, el destino es la
+// matriz transpuesta. Cada ejecución es un único MPI_Alltoallw sin copias ni
+// paso por el proceso 0
+struct PlanMatriz {
+    DistribucionMatriz origen, destino;
+    bool transpuesta;
+    Rectangulo local_origen, local_destino;
+    std::vector<int> cuentas_envio, bytes_envio, cuentas_recepcion, bytes_recepcion;
+    std::vector<MPI_Datatype> tipos_envio, tipos_recepcion;
+    long long bytes_remotos;  // bytes enviados más recibidos de otros procesos
+};
+
+// "destino" describe la matriz resultado (columnas x filas si se transpone)
+PlanMatriz crear_plan_matriz(const DistribucionMatriz& origen, const DistribucionMatriz& destino, bool transponer_matriz,
+                             int mi_rango) {
+    int p = origen.pr * origen.pc;
+    PlanMatriz plan;
+    plan.origen = origen;
+    plan.destino = destino;
+    plan.transpuesta = transponer_matriz;
+    plan.local_origen = rectangulo_de(origen, mi_rango);
+    plan.local_destino = rectangulo_de(destino, mi_rango);
+    plan.cuentas_envio.assign(p, 0);
+    plan.bytes_envio.assign(p, 0);
+    plan.cuentas_recepcion.assign(p, 0);
+    plan.bytes_recepcion.assign(p, 0);
+    plan.tipos_envio.assign(p, MPI_DOUBLE);
+    plan.tipos_recepcion.assign(p, MPI_DOUBLE);
+    plan.bytes_remotos = 0;
+
+    for (int q = 0; q < p; q++) {
+        // Envío: lo mío en el origen que en el destino es de q (en coordenadas del origen)
+        Rectangulo destino_q = rectangulo_de(destino, q);
+        if (transponer_matriz) destino_q = transponer(destino_q);
+        Rectangulo salida = interseccion(plan.local_origen, destino_q);
+        if (salida.filas > 0 && salida.columnas > 0) {
+            plan.cuentas_envio[q] = 1;
+            plan.tipos_envio[q] = tipo_submatriz(plan.local_origen, salida);
+            if (q != mi_rango) plan.bytes_remotos += (long long)salida.filas * salida.columnas * sizeof(double);
+        }
+
+        // Recepción: lo mío en el destino que en el origen era de q (en coordenadas del destino)
+        Rectangulo origen_q = rectangulo_de(origen, q);
+        if (transponer_matriz) origen_q = transponer(origen_q);
+        Rectangulo entrada = interseccion(plan.local_destino, origen_q);
+        if (entrada.filas > 0 && entrada.columnas > 0) {
+            plan.cuentas_recepcion[q] = 1;
+            if (transponer_matriz) {
+                plan.tipos_recepcion[q] = tipo_submatriz_transpuesta(plan.local_destino, entrada,
+                                                                     plan.bytes_recepcion[q]);
+            } else {
+                plan.tipos_recepcion[q] = tipo_submatriz(plan.local_destino, entrada);
+            }
+            if (q != mi_rango) plan.bytes_remotos += (long long)entrada.filas * entrada.columnas * sizeof(double);
+        }
+    }
+    return plan;
+}
+
+void liberar_plan_matriz(PlanMatriz& plan) {
+    for (int q = 0; q < (int)plan.tipos_envio.size(); q++) {
+        if (plan.cuentas_envio[q] > 0) MPI_Type_free(&plan.tipos_envio[q]);
+        if (plan.cuentas_recepcion[q] > 0) MPI_Type_free(&plan.tipos_recepcion[q]);
+    }
+}
+
+void ejecutar_plan_matriz(PlanMatriz& plan, const double* entrada, double* salida) {
+    MPI_Alltoallw(entrada, plan.cuentas_envio.data(), plan.bytes_envio.data(), plan.tipos_envio.data(), salida,
+                  plan.cuentas_recepcion.data(), plan.bytes_recepcion.data(), plan.tipos_recepcion.data(),
+                  MPI_COMM_WORLD);
+}
+
+// Llena el bloque local con A(i, j) = i * columnas + j (exacto en double)
+void llenar_matriz(std::vector<double>& local, const Rectangulo& rect, int columnas) {
+    for (int i = 0; i < rect.filas; i++) {
+        for (int j = 0; j < rect.columnas; j++) {
+            local[(long long)i * rect.columnas + j] = (double)(rect.fila + i) * columnas + (rect.columna + j);
+        }
+    }
+}
+
+// Verifica el bloque local del resultado: A o su transpuesta (B(i, j) = A(j, i))
+bool verificar_matriz(const std::vector<double>& local, const Rectangulo& rect, int columnas_a, bool transpuesta) {
+    for (int i = 0; i < rect.filas; i++) {
+        for (int j = 0; j < rect.columnas; j++) {
+            long long fila_a = rect.fila + i, columna_a = rect.columna + j;
+            if (transpuesta) std::swap(fila_a, columna_a);
+            if (local[(long long)i * rect.columnas + j] != (double)fila_a * columnas_a + columna_a) return false;
+        }
+    }
+    return true;
+}
+
+// Modo matriz: cambia una matriz filas x columnas entre distribuciones por
+// filas, por columnas y en mosaico, y la transpone, con planes de
+// MPI_Alltoallw. Reporta costo de crear el plan, tiempos de ejecución, bytes
+// movidos por el proceso más cargado y ancho de banda
+void redistribuir_matrices(int filas, int columnas, int mi_rango, int numero_procesos) {
+    int p = numero_procesos;
+    struct Paso {
+        DistribucionMatriz origen, destino;
+        bool transponer, origen_mosaico, destino_mosaico;
+    };
+    std::vector<Paso> pasos;
+    Paso paso;
+    paso.transponer = false;
+    paso.origen_mosaico = false;
+    paso.destino_mosaico = false;
+    paso.origen = matriz_por_filas(filas, columnas, p);
+    paso.destino = matriz_por_columnas(filas, columnas, p);
+    pasos.push_back(paso);
+    paso.origen = matriz_por_columnas(filas, columnas, p);
+    paso.destino = matriz_en_mosaico(filas, columnas, p);
+    paso.destino_mosaico = true;
+    pasos.push_back(paso);
+    paso.origen = matriz_en_mosaico(filas, columnas, p);
+    paso.destino = matriz_por_filas(filas, columnas, p);
+    paso.origen_mosaico = true;
+    paso.destino_mosaico = false;
+    pasos.push_back(paso);
+    paso.transponer = true;
+    paso.origen_mosaico = false;
+    paso.origen = matriz_por_filas(filas, columnas, p);
+    paso.destino = matriz_por_filas(columnas, filas, p);
+    pasos.push_back(paso);
+    paso.origen = matriz_en_mosaico(filas, columnas, p);
+    paso.destino = matriz_en_mosaico(columnas, filas, p);
+    paso.origen_mosaico = true;
+    paso.destino_mosaico = true;
+    pasos.push_back(paso);
+
+    if (mi_rango == 0) {
+        std::cout << "\n=== REDISTRIBUCIÓN DE MATRICES 2D (MPI_Alltoallw) ===" << std::endl;
+        std::cout << "Matriz " << filas << " x " << columnas << ", " << p << " procesos, " << REPETICIONES
+                  << " repeticiones por paso" << std::endl;
+        std::cout << "  " << rellenar("Origen → Destino", 44) << std::setw(12) << "Creación" << std::setw(12)
+                  << "Mín. (s)" << std::setw(12) << "Mediana (s)" << std::setw(14) << "MB/proceso" << std::setw(10)
+                  << "GB/s" << "  Correcto" << std::endl;
+    }
+
+    for (const Paso& actual : pasos) {
+        double inicio = MPI_Wtime();
+        PlanMatriz plan = crear_plan_matriz(actual.origen, actual.destino, actual.transponer, mi_rango);
+        double tiempo_creacion = MPI_Wtime() - inicio;
+
+        std::vector<double> entrada((long long)plan.local_origen.filas * plan.local_origen.columnas);
+        std::vector<double> salida((long long)plan.local_destino.filas * plan.local_destino.columnas);
+        llenar_matriz(entrada, plan.local_origen, columnas);
+
+        std::vector<double> tiempos;
+        int correcto_local = 1;
+        for (int repeticion = -1; repeticion < REPETICIONES; repeticion++) {
+            std::fill(salida.begin(), salida.end(), -1.0);
+            MPI_Barrier(MPI_COMM_WORLD);
+            inicio = MPI_Wtime();
+            {
+                TemporizadorFase temporizador(FASE_DISTRIBUCION);
+                ejecutar_plan_matriz(plan, entrada.data(), salida.data());
+            }
+            double tiempo = MPI_Wtime() - inicio, tiempo_max;
+            MPI_Allreduce(&tiempo, &tiempo_max, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+            if (!verificar_matriz(salida, plan.local_destino, columnas, actual.transponer)) correcto_local = 0;
+            if (repeticion >= 0) tiempos.push_back(tiempo_max);
+        }
+
+        int correcto_global;
+        MPI_Allreduce(&correcto_local, &correcto_global, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+        double creacion_max;
+        MPI_Reduce(&tiempo_creacion, &creacion_max, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        long long bytes_max;
+        MPI_Reduce(&plan.bytes_remotos, &bytes_max, 1, MPI_LONG_LONG, MPI_MAX, 0, MPI_COMM_WORLD);
+
+        if (mi_rango == 0) {
+            TemporizadorFase temporizador(FASE_SALIDA);
+            std::sort(tiempos.begin(), tiempos.end());
+            double mediana = tiempos[tiempos.size() / 2];
+            std::string nombre = describir_matriz(actual.origen, actual.origen_mosaico) + " → " +
+                                 describir_matriz(actual.destino, actual.destino_mosaico) +
+                                 (actual.transponer ? " (transpuesta)" : "");
+            std::cout << "  " << rellenar(nombre, 44) << std::fixed << std::setprecision(6) << std::setw(12)
+                      << creacion_max << std::setw(12) << tiempos.front() << std::setw(12) << mediana
+                      << std::setprecision(3) << std::setw(14) << bytes_max / 1048576.0 << std::setw(10)
+                      << (mediana > 0 ? bytes_max / mediana / 1e9 : 0.0) << "  "
+                      << (correcto_global ? "✅" : "❌") << std::endl;
+        }
+        liberar_plan_matriz(plan);
+    }
+}
+
+#ifndef NUCLEOS_SIN_MAIN
 int main(int argc, char* argv[]) {
     int numero_procesos, mi_rango;
     MPI_Init(&argc, &argv);
     MPI_Comm_size(MPI_COMM_WORLD, &numero_procesos);
     MPI_Comm_rank(MPI_COMM_WORLD, &mi_rango);
 
-    int n_vector;
+    // Modo barrido no interactivo: "barrido [n_máximo]"
+    if (argc > 1 && strcmp(argv[1], "barrido") == 0) {
+        long long n_maximo = 1 << 22;
+        if (mi_rango == 0 && argc > 2) n_maximo = std::max(1LL, atoll(argv[2]));
+        MPI_Bcast(&n_maximo, 1, MPI_LONG_LONG, 0, MPI_COMM_WORLD);
+        barrido_estrategias(n_maximo, mi_rango, numero_procesos);
+        reportar_fases(MPI_COMM_WORLD);
+        MPI_Finalize();
+        return 0;
+    }
+
+    // Modo matriz no interactivo: "matriz [filas] [columnas]"
+    if (argc > 1 && strcmp(argv[1], "matriz") == 0) {
+        int dimensiones[2] = {2048, 2048};
+        if (mi_rango == 0 && argc > 2) dimensiones[0] = std::max(1, atoi(argv[2]));
+        if (mi_rango == 0) dimensiones[1] = argc > 3 ? std::max(1, atoi(argv[3])) : dimensiones[0];
+        MPI_Bcast(dimensiones, 2, MPI_INT, 0, MPI_COMM_WORLD);
+        redistribuir_matrices(dimensiones[0], dimensiones[1], mi_rango, numero_procesos);
+        reportar_fases(MPI_COMM_WORLD);
+        MPI_Finalize();
+        return 0;
+    }
+
+    int n_vector, n_solicitado;
     std::vector<double> vector_bloques, vector_ciclico;
 
     if (mi_rango == 0) {
@@ -19,6 +1109,7 @@ int main(int argc, char* argv[]) {
         std::cout << "Midiendo tiempo de cambio entre distribución por bloques y cíclica" << std::endl;
         std::cout << "Ingrese el tamaño del vector: ";
         std::cin >> n_vector;
+        n_solicitado = n_vector;
 
         // Ajustar n para que sea divisible por el número de procesos
         if (n_vector % numero_procesos != 0) {
@@ -29,13 +1120,22 @@ int main(int argc, char* argv[]) {
 
     // Distribuir el tamaño del vector a todos los procesos
     MPI_Bcast(&n_vector, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Bcast(&n_solicitado, 1, MPI_INT, 0, MPI_COMM_WORLD);
 
     // Calcular elementos por proceso
     int elementos_por_proceso = n_vector / numero_procesos;
 
-    // Preparar buffers
+    // Preparar buffers: todo es O(n/p) por proceso salvo los buffers del
+    // proceso 0 en la estrategia original
+    TemporizadorFase temporizador_entrada(FASE_ENTRADA);
     vector_bloques.resize(elementos_por_proceso);
     vector_ciclico.resize(elementos_por_proceso);
+    std::vector<double> paquete(elementos_por_proceso);
+    PatronRedistribucion patron = crear_patron(mi_rango, numero_procesos, elementos_por_proceso);
+    PlanRedistribucion plan_bloques_a_ciclica = crear_plan(distribucion_bloques(n_vector, numero_procesos),
+                                                           distribucion_ciclica(n_vector, numero_procesos), mi_rango);
+    PlanRedistribucion plan_ciclica_a_bloques = crear_plan(distribucion_ciclica(n_vector, numero_procesos),
+                                                           distribucion_bloques(n_vector, numero_procesos), mi_rango);
 
     // ==============================================
     // INICIALIZACIÓN: Crear distribución por bloques
@@ -48,6 +1148,7 @@ int main(int argc, char* argv[]) {
     for (int i = 0; i < elementos_por_proceso; i++) {
         vector_bloques[i] = mi_rango * elementos_por_proceso + i + 1;
     }
+    temporizador_entrada.detener();
 
     // Mostrar distribución inicial si el vector es pequeño
     if (n_vector <= 40) {
@@ -73,28 +1174,10 @@ int main(int argc, char* argv[]) {
     }
 
     double inicio_bloques_a_ciclica = MPI_Wtime();
-
-    // Algoritmo para redistribuir de bloques a cíclico
-    std::vector<double> buffer_envio(n_vector);
-    std::vector<double> buffer_recepcion(n_vector);
-
-    // Paso 1: Recolectar todos los datos en el proceso 0
-    MPI_Gather(vector_bloques.data(), elementos_por_proceso, MPI_DOUBLE,
-               buffer_recepcion.data(), elementos_por_proceso, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-
-    // Paso 2: El proceso 0 redistribuye de forma cíclica
-    if (mi_rango == 0) {
-        for (int i = 0; i < n_vector; i++) {
-            int proceso_destino = i % numero_procesos;
-            int indice_local = i / numero_procesos;
-            buffer_envio[proceso_destino * elementos_por_proceso + indice_local] = buffer_recepcion[i];
-        }
+    {
+        TemporizadorFase temporizador(FASE_DISTRIBUCION);
+        bloques_a_ciclica_alltoallv(patron, vector_bloques, vector_ciclico, paquete);
     }
-
-    // Paso 3: Distribuir datos reorganizados
-    MPI_Scatter(buffer_envio.data(), elementos_por_proceso, MPI_DOUBLE,
-                vector_ciclico.data(), elementos_por_proceso, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-
     double fin_bloques_a_ciclica = MPI_Wtime();
     double tiempo_bloques_a_ciclica = fin_bloques_a_ciclica - inicio_bloques_a_ciclica;
 
@@ -121,29 +1204,12 @@ int main(int argc, char* argv[]) {
         std::cout << "\n3. Convirtiendo de distribución cíclica a por bloques..." << std::endl;
     }
 
+    std::fill(vector_bloques.begin(), vector_bloques.end(), 0.0);
     double inicio_ciclica_a_bloques = MPI_Wtime();
-
-    // Algoritmo para redistribuir de cíclico a bloques
-    // Paso 1: Recolectar todos los datos en el proceso 0
-    MPI_Gather(vector_ciclico.data(), elementos_por_proceso, MPI_DOUBLE,
-               buffer_recepcion.data(), elementos_por_proceso, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-
-    // Paso 2: El proceso 0 redistribuye por bloques
-    if (mi_rango == 0) {
-        for (int proc = 0; proc < numero_procesos; proc++) {
-            for (int i = 0; i < elementos_por_proceso; i++) {
-                int indice_global = proc * elementos_por_proceso + i;
-                int indice_ciclico = (indice_global % numero_procesos) * elementos_por_proceso +
-                                     (indice_global / numero_procesos);
-                buffer_envio[proc * elementos_por_proceso + i] = buffer_recepcion[indice_ciclico];
-            }
-        }
+    {
+        TemporizadorFase temporizador(FASE_DISTRIBUCION);
+        ciclica_a_bloques_alltoallv(patron, vector_ciclico, vector_bloques, paquete);
     }
-
-    // Paso 3: Distribuir datos reorganizados
-    MPI_Scatter(buffer_envio.data(), elementos_por_proceso, MPI_DOUBLE,
-                vector_bloques.data(), elementos_por_proceso, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-
     double fin_ciclica_a_bloques = MPI_Wtime();
     double tiempo_ciclica_a_bloques = fin_ciclica_a_bloques - inicio_ciclica_a_bloques;
 
@@ -161,6 +1227,62 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    // ==============================================
+    // MEDICIÓN 3: Comparación de estrategias
+    // ==============================================
+    // Cada repetición se cronometra entre barreras y se toma el máximo entre
+    // procesos; por estrategia y sentido se reportan el mínimo y el promedio
+    if (mi_rango == 0) {
+        std::cout << "\n4. Comparando estrategias (" << REPETICIONES << " repeticiones)..." << std::endl;
+    }
+
+    double tiempos_minimos[NUMERO_ESTRATEGIAS][2], tiempos_promedio[NUMERO_ESTRATEGIAS][2];
+    bool estrategia_correcta[NUMERO_ESTRATEGIAS];
+    for (int estrategia = 0; estrategia < NUMERO_ESTRATEGIAS; estrategia++) {
+        estrategia_correcta[estrategia] = true;
+        for (int sentido = 0; sentido < 2; sentido++) {
+            tiempos_minimos[estrategia][sentido] = 0.0;
+            tiempos_promedio[estrategia][sentido] = 0.0;
+        }
+
+        for (int repeticion = -1; repeticion < REPETICIONES; repeticion++) {
+            std::fill(vector_ciclico.begin(), vector_ciclico.end(), 0.0);
+            MPI_Barrier(MPI_COMM_WORLD);
+            double t0 = MPI_Wtime();
+            {
+                TemporizadorFase temporizador(FASE_DISTRIBUCION);
+                bloques_a_ciclica(estrategia, patron, plan_bloques_a_ciclica, vector_bloques, vector_ciclico,
+                                  paquete, mi_rango);
+            }
+            double t1 = MPI_Wtime();
+
+            std::fill(vector_bloques.begin(), vector_bloques.end(), 0.0);
+            MPI_Barrier(MPI_COMM_WORLD);
+            double t2 = MPI_Wtime();
+            {
+                TemporizadorFase temporizador(FASE_DISTRIBUCION);
+                ciclica_a_bloques(estrategia, patron, plan_ciclica_a_bloques, vector_ciclico, vector_bloques,
+                                  paquete, mi_rango);
+            }
+            double t3 = MPI_Wtime();
+
+            double tiempos[2] = {t1 - t0, t3 - t2}, tiempos_max[2];
+            MPI_Reduce(tiempos, tiempos_max, 2, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+            // La verificación (comparación local y un Allreduce) queda fuera de las fases
+            if (!verificar_distribuciones(vector_bloques, vector_ciclico, mi_rango, numero_procesos)) {
+                estrategia_correcta[estrategia] = false;
+            }
+            if (repeticion < 0) continue;  // calentamiento
+
+            for (int sentido = 0; sentido < 2; sentido++) {
+                if (repeticion == 0 || tiempos_max[sentido] < tiempos_minimos[estrategia][sentido]) {
+                    tiempos_minimos[estrategia][sentido] = tiempos_max[sentido];
+                }
+                tiempos_promedio[estrategia][sentido] += tiempos_max[sentido] / REPETICIONES;
+            }
+        }
+    }
+
     // ==============================================
     // RECOLECTAR Y MOSTRAR RESULTADOS
     // ==============================================
@@ -172,7 +1294,15 @@ int main(int argc, char* argv[]) {
     MPI_Reduce(&tiempo_ciclica_a_bloques, &tiempo_max_ciclica_a_bloques, 1,
                MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
 
+    // Tráfico de las mediciones 1 y 2 (Alltoallv empaquetado) contado como en
+    // barrido_estrategias: lo que envía y recibe el proceso más cargado
+    long long bytes[2] = {bytes_movidos(ESTRATEGIA_ALLTOALLV, plan_bloques_a_ciclica, elementos_por_proceso),
+                          bytes_movidos(ESTRATEGIA_ALLTOALLV, plan_ciclica_a_bloques, elementos_por_proceso)};
+    long long bytes_max[2];
+    MPI_Reduce(bytes, bytes_max, 2, MPI_LONG_LONG, MPI_MAX, 0, MPI_COMM_WORLD);
+
     if (mi_rango == 0) {
+        TemporizadorFase temporizador(FASE_SALIDA);
         std::cout << "\n=== RESULTADOS DE MEDICIÓN ===" << std::endl;
         std::cout << std::fixed << std::setprecision(6);
 
@@ -180,34 +1310,70 @@ int main(int argc, char* argv[]) {
         std::cout << "Número de procesos: " << numero_procesos << std::endl;
         std::cout << "Elementos por proceso: " << elementos_por_proceso << std::endl;
 
-        std::cout << "\nTiempos de redistribución:" << std::endl;
+        std::cout << "\nTiempos de redistribución (Alltoall directo, primera ejecución):" << std::endl;
         std::cout << "  Bloques → Cíclica:  " << tiempo_max_bloques_a_ciclica << " segundos" << std::endl;
         std::cout << "  Cíclica → Bloques:  " << tiempo_max_ciclica_a_bloques << " segundos" << std::endl;
 
         double promedio = (tiempo_max_bloques_a_ciclica + tiempo_max_ciclica_a_bloques) / 2.0;
         std::cout << "  Tiempo promedio:    " << promedio << " segundos" << std::endl;
 
-        // Análisis del overhead
-        double elementos_transferidos = n_vector * sizeof(double);
-        double mbytes_transferidos = elementos_transferidos / (1024.0 * 1024.0);
+        // Memoria auxiliar por proceso de cada estrategia (el peor proceso)
+        double mbytes_vector = n_vector * sizeof(double) / (1024.0 * 1024.0);
+        double mbytes_porcion = elementos_por_proceso * sizeof(double) / (1024.0 * 1024.0);
+        double memoria_auxiliar[NUMERO_ESTRATEGIAS] = {2 * mbytes_vector, mbytes_porcion, 0.0,
+                                                       3 * mbytes_porcion, 3 * mbytes_porcion,
+                                                       5 * mbytes_porcion, 3 * mbytes_porcion,
+                                                       3 * mbytes_porcion};
 
-        std::cout << "\nAnálisis del overhead:" << std::endl;
-        std::cout << "  Datos transferidos: " << mbytes_transferidos << " MB" << std::endl;
-
-        if (tiempo_max_bloques_a_ciclica > 0) {
-            double bandwidth_1 = mbytes_transferidos / tiempo_max_bloques_a_ciclica;
-            std::cout << "  Ancho de banda efectivo (B→C): " << bandwidth_1 << " MB/s" << std::endl;
+        std::cout << "\nComparación de estrategias (máx. entre procesos, mín. / promedio en segundos):" << std::endl;
+        std::cout << "  " << std::left << std::setw(24) << "Estrategia" << std::right << std::setw(25)
+                  << "Bloques → Cíclica" << std::setw(26) << "Cíclica → Bloques" << std::setw(16)
+                  << "Memoria aux." << "  Correcto" << std::endl;
+        for (int estrategia = 0; estrategia < NUMERO_ESTRATEGIAS; estrategia++) {
+            std::cout << "  " << rellenar(NOMBRES_ESTRATEGIAS[estrategia], 24)
+                      << std::setw(10) << tiempos_minimos[estrategia][0] << " / " << std::setw(9)
+                      << tiempos_promedio[estrategia][0] << std::setw(11) << tiempos_minimos[estrategia][1]
+                      << " / " << std::setw(9) << tiempos_promedio[estrategia][1] << std::setprecision(3)
+                      << std::setw(13) << memoria_auxiliar[estrategia] << " MB" << "  "
+                      << (estrategia_correcta[estrategia] ? "✅" : "❌") << std::setprecision(6) << std::endl;
+        }
+        if (tiempos_minimos[ESTRATEGIA_ALLTOALLV][0] > 0) {
+            std::cout << "  Aceleración Alltoallv vs Gather/Scatter (B→C): " << std::setprecision(2)
+                      << tiempos_minimos[ESTRATEGIA_RAIZ][0] / tiempos_minimos[ESTRATEGIA_ALLTOALLV][0] << "x"
+                      << std::setprecision(6) << std::endl;
         }
 
-        if (tiempo_max_ciclica_a_bloques > 0) {
-            double bandwidth_2 = mbytes_transferidos / tiempo_max_ciclica_a_bloques;
-            std::cout << "  Ancho de banda efectivo (C→B): " << bandwidth_2 << " MB/s" << std::endl;
+        // Análisis del overhead: la parte que cada proceso ya tiene no viaja,
+        // así que se usan los bytes movidos y no n · 8
+        std::cout << "\nAnálisis del overhead (proceso más cargado, enviados + recibidos):" << std::endl;
+        const char* sentidos[2] = {"B→C", "C→B"};
+        double tiempos_medidos[2] = {tiempo_max_bloques_a_ciclica, tiempo_max_ciclica_a_bloques};
+        for (int sentido = 0; sentido < 2; sentido++) {
+            std::cout << "  " << sentidos[sentido] << ": " << std::setprecision(3) << bytes_max[sentido] / 1048576.0
+                      << " MB";
+            if (tiempos_medidos[sentido] > 0) {
+                std::cout << ", " << bytes_max[sentido] / tiempos_medidos[sentido] / 1e9 << " GB/s";
+            }
+            std::cout << std::setprecision(6) << std::endl;
         }
 
         std::cout << "\nNota: Este overhead debe considerarse al decidir la estrategia de distribución" << std::endl;
         std::cout << "      en algoritmos que requieren cambios de distribución." << std::endl;
     }
 
+    // ==============================================
+    // PLANES GENÉRICOS: cadena de distribuciones con n sin ajustar
+    // ==============================================
+    if (mi_rango == 0) {
+        std::cout << "\n5. Alternando distribuciones con planes precalculados..." << std::endl;
+    }
+    recorrer_distribuciones(n_solicitado, mi_rango, numero_procesos);
+
+    liberar_plan(plan_bloques_a_ciclica);
+    liberar_plan(plan_ciclica_a_bloques);
+    liberar_patron(patron);
+    reportar_fases(MPI_COMM_WORLD);
     MPI_Finalize();
     return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -0,0 +1,800 @@
+// Barrido no interactivo de los nueve núcleos en una sola sesión MPI
+//
+//   mpirun -np 4 bin/barrido_nucleos histograma=1M,4M pi=16M columnas=512,1024
+//   mpirun -np 4 bin/barrido_nucleos --config=barrido.txt --repeticiones=10
+//   mpirun -np 4 bin/barrido_nucleos --config=debil.txt --debil --escalamiento=resultados.csv
+//   bin/barrido_nucleos --analizar=resultados.csv --base=linea_base.csv
+//
+// Cada programa 3_x se incluye sin su main (NUCLEOS_SIN_MAIN) y se llama a
+// sus funciones de cálculo con los parámetros de cada configuración, de modo
+// que el arranque de MPI se paga una sola vez y los buffers se reutilizan
+// entre configuraciones
+#define NUCLEOS_SIN_MAIN
+#include "3_1_histograma.cpp"
+#include "3_2_monte_carlo_pi.cpp"
+#include "3_3_suma_arbol.cpp"
+#include "3_4_suma_mariposa.cpp"
+#include "3_5_matriz_vector_columnas.cpp"
+#include "3_6_matriz_vector_submatrices.cpp"
+#include "3_7_ping_pong_tiempo.cpp"
+#include "3_8_merge_sort_paralelo.cpp"
+#include "3_9_costo_redistribucion.cpp"
+
+#include <climits>
+#include <sstream>
+
+enum Nucleo {
+    NUCLEO_HISTOGRAMA,     // 3_1: Scatter + conteo + Reduce
+    NUCLEO_PI,             // 3_2: lanzamientos Monte Carlo + Reduce
+    NUCLEO_ARBOL,          // 3_3: suma en árbol de un vector por proceso
+    NUCLEO_MARIPOSA,       // 3_4: suma mariposa de un vector por proceso
+    NUCLEO_COLUMNAS,       // 3_5: matriz-vector por bloques de columnas
+    NUCLEO_SUBMATRICES,    // 3_6: matriz-vector por submatrices (p cuadrado perfecto)
+    NUCLEO_PING_PONG,      // 3_7: ping-pong entre los procesos 0 y 1
+    NUCLEO_MERGE_SORT,     // 3_8: Scatter + ordenamiento local + merge en árbol
+    NUCLEO_REDISTRIBUCION, // 3_9: bloques → cíclica → bloques con MPI_Alltoall(v)
+    NUMERO_NUCLEOS
+};
+
+const char* NOMBRES_NUCLEOS[NUMERO_NUCLEOS] = {"histograma", "pi", "arbol", "mariposa", "columnas",
+                                               "submatrices", "ping_pong", "merge_sort", "redistribucion"};
+
+// Qué significa el tamaño de una configuración en cada núcleo
+const char* UNIDADES_NUCLEOS[NUMERO_NUCLEOS] = {"datos", "lanzamientos", "doubles por proceso",
+                                                "doubles por proceso", "orden de la matriz",
+                                                "orden de la matriz", "bytes por mensaje",
+                                                "elementos", "elementos"};
+
+const int BINS_HISTOGRAMA = 10;
+const int PANELES_SUBMATRICES = 4;
+
+struct Configuracion {
+    int nucleo;
+    long long tamano;
+};
+
+// Buffers de todos los núcleos. Viven durante todo el barrido: como un
+// std::vector no libera memoria al achicarse, una configuración solo pide
+// memoria nueva si necesita más que todas las anteriores
+struct EspacioTrabajo {
+    std::vector<float> datos_histograma, porcion_histograma;
+    std::vector<int> histograma_local, histograma_global;
+    std::vector<double> suma_parcial, valor_recibido;
+    std::vector<double> matriz, vector_x, resultado, bloque, parcial, subvector, subresultado, resultado_fila;
+    std::vector<char> mensaje;
+    std::vector<int> datos_orden, porcion_orden, auxiliar_orden, ordenado;
+    std::vector<double> vector_bloques, vector_ciclico, paquete;
+    PatronRedistribucion patron;
+    bool patron_creado;
+    VentanaNodo copia_nodo;  // datos compartidos por nodo (MEMORIA_NODO=1)
+    LineaTiempoPaneles linea;
+    std::mt19937 generador;
+    MPI_Comm comunicador_fila;  // filas de la grilla de 3_6 (si p es cuadrado perfecto)
+    int sqrt_procesos;
+    long long puntos_en_circulo;
+    long long reservas;  // veces que un buffer tuvo que crecer
+};
+
+// Clase de tamaño de n: la potencia de 2 mayor o igual. Los buffers se
+// reservan por clase, así que las configuraciones de una misma clase (o de
+// una menor) usan la misma memoria sin volver a pedirla
+long long clase_de_tamano(long long n) {
+    long long clase = 1;
+    while (clase < n) clase <<= 1;
+    return clase;
+}
+
+template <typename T>
+void preparar_buffer(std::vector<T>& buffer, long long elementos, EspacioTrabajo& espacio) {
+    if ((long long)buffer.capacity() < elementos) {
+        buffer.reserve(clase_de_tamano(elementos));
+        espacio.reservas++;
+    }
+    buffer.resize(elementos);
+}
+
+// Ajusta el tamaño a un múltiplo de "multiplo" (al menos uno)
+long long redondear_a_multiplo(long long tamano, long long multiplo) {
+    return std::max(multiplo, (tamano + multiplo - 1) / multiplo * multiplo);
+}
+
+// Prepara las entradas de una configuración, fuera de la medición. Puede
+// ajustar el tamaño a lo que el núcleo admite; devuelve el motivo si la
+// configuración no se puede ejecutar con esta cantidad de procesos
+std::string preparar(int nucleo, long long& tamano, EspacioTrabajo& e, int mi_rango, int p) {
+    switch (nucleo) {
+    case NUCLEO_HISTOGRAMA:
+        tamano = redondear_a_multiplo(tamano, p);
+        if (mi_rango == 0) {
+            preparar_buffer(e.datos_histograma, tamano, e);
+            generar_datos(e.datos_histograma, tamano, 0.0f, 100.0f);
+        }
+        preparar_buffer(e.porcion_histograma, tamano / p, e);
+        break;
+    case NUCLEO_PI:
+        tamano = redondear_a_multiplo(tamano, p);
+        break;
+    case NUCLEO_ARBOL:
+    case NUCLEO_MARIPOSA:
+        tamano = std::max(1LL, tamano);
+        preparar_buffer(e.suma_parcial, tamano, e);
+        preparar_buffer(e.valor_recibido, tamano, e);
+        break;
+    case NUCLEO_COLUMNAS:
+        tamano = redondear_a_multiplo(tamano, p);
+        if (tamano * tamano > INT_MAX) return "n * n no entra en un int";
+        if (mi_rango == 0) {
+            preparar_buffer(e.matriz, tamano * tamano, e);
+            preparar_buffer(e.resultado, tamano, e);
+        }
+        preparar_buffer(e.vector_x, tamano, e);
+        if (mi_rango == 0) generar_matriz_vector_columnas(tamano, e.matriz, e.vector_x);
+        preparar_buffer(e.bloque, tamano * tamano / p, e);
+        preparar_buffer(e.parcial, tamano, e);
+        break;
+    case NUCLEO_SUBMATRICES:
+        if (e.sqrt_procesos * e.sqrt_procesos != p) return "requiere un número de procesos cuadrado perfecto";
+        tamano = redondear_a_multiplo(tamano, e.sqrt_procesos);
+        if (tamano * tamano > INT_MAX) return "n * n no entra en un int";
+        if (mi_rango == 0) {
+            preparar_buffer(e.matriz, tamano * tamano, e);
+            preparar_buffer(e.resultado, tamano, e);
+        }
+        preparar_buffer(e.vector_x, tamano, e);
+        if (mi_rango == 0) generar_matriz_vector_submatrices(tamano, e.matriz, e.vector_x);
+        preparar_buffer(e.bloque, tamano * tamano / p, e);
+        preparar_buffer(e.subvector, tamano / e.sqrt_procesos, e);
+        preparar_buffer(e.subresultado, tamano / e.sqrt_procesos, e);
+        preparar_buffer(e.resultado_fila, tamano / e.sqrt_procesos, e);
+        break;
+    case NUCLEO_PING_PONG:
+        if (p < 2) return "requiere al menos 2 procesos";
+        if (tamano > INT_MAX) return "mensaje de más de 2 GB";
+        preparar_buffer(e.mensaje, std::max(1LL, tamano), e);
+        break;
+    case NUCLEO_MERGE_SORT:
+        tamano = redondear_a_multiplo(tamano, p);
+        if (tamano > INT_MAX) return "n no entra en un int";
+        if (mi_rango == 0) {
+            preparar_buffer(e.datos_orden, tamano, e);
+            std::uniform_int_distribution<> dis(1, 1000);
+            for (long long i = 0; i < tamano; i++) e.datos_orden[i] = dis(e.generador);
+        }
+        preparar_buffer(e.porcion_orden, tamano / p, e);
+        preparar_buffer(e.auxiliar_orden, tamano / p, e);
+        break;
+    case NUCLEO_REDISTRIBUCION: {
+        tamano = redondear_a_multiplo(tamano, p);
+        if (tamano > INT_MAX) return "n no entra en un int";
+        int m = tamano / p;
+        preparar_buffer(e.vector_bloques, m, e);
+        preparar_buffer(e.vector_ciclico, m, e);
+        preparar_buffer(e.paquete, m, e);
+        for (int i = 0; i < m; i++) e.vector_bloques[i] = (double)mi_rango * m + i;
+        e.patron = crear_patron(mi_rango, p, m);
+        e.patron_creado = true;
+        break;
+    }
+    }
+    return "";
+}
+
+// Deja las entradas como antes de cada repetición (fuera de la medición)
+void reiniciar(int nucleo, EspacioTrabajo& e, int mi_rango) {
+    if (nucleo == NUCLEO_ARBOL || nucleo == NUCLEO_MARIPOSA) {
+        std::fill(e.suma_parcial.begin(), e.suma_parcial.end(), mi_rango + 1.0);
+    }
+}
+
+// Una ejecución del núcleo: lo que se mide
+void ejecutar(int nucleo, long long tamano, EspacioTrabajo& e, int mi_rango, int p) {
+    switch (nucleo) {
+    case NUCLEO_HISTOGRAMA:
+        calcular_histograma(e.datos_histograma, tamano, BINS_HISTOGRAMA, 0.0f, 100.0f, p, e.porcion_histograma,
+                            e.copia_nodo, e.histograma_local, e.histograma_global);
+        break;
+    case NUCLEO_PI:
+        e.puntos_en_circulo = lanzar_dardos(tamano, p, e.generador);
+        break;
+    case NUCLEO_ARBOL:
+        suma_en_arbol(e.suma_parcial, e.valor_recibido, mi_rango, p, false);
+        break;
+    case NUCLEO_MARIPOSA:
+        suma_mariposa(e.suma_parcial, e.valor_recibido, mi_rango, p, false);
+        break;
+    case NUCLEO_COLUMNAS:
+        multiplicar_por_columnas(tamano, e.matriz, e.vector_x, e.resultado, e.bloque, e.parcial, e.copia_nodo, mi_rango,
+                                 p, false);
+        break;
+    case NUCLEO_SUBMATRICES:
+        multiplicar_por_submatrices(tamano, PANELES_SUBMATRICES, e.matriz, e.vector_x, e.resultado, e.bloque,
+                                    e.subvector, e.subresultado, e.resultado_fila, e.copia_nodo, e.comunicador_fila,
+                                    mi_rango, e.sqrt_procesos, e.linea, false);
+        break;
+    case NUCLEO_PING_PONG:
+        // Una repetición son varias idas y vueltas, con un volumen parecido para
+        // cada tamaño; medir_primitiva cuenta su tiempo como distribución
+        medir_primitiva(PRIMITIVA_SEND, mi_rango, e.mensaje, e.mensaje, MPI_WIN_NULL, tamano,
+                        std::max(1, iteraciones_para_tamano(tamano) / 10), 0);
+        break;
+    case NUCLEO_MERGE_SORT: {
+        int elementos_por_proceso = tamano / p;
+        int* bloque;
+        const int* ordenado;
+        {
+            TemporizadorFase temporizador(FASE_DISTRIBUCION);
+            bloque = repartir_porcion(e.datos_orden, elementos_por_proceso, e.porcion_orden, e.copia_nodo);
+        }
+        {
+            TemporizadorFase temporizador(FASE_CALCULO);
+            ordenado = ordenar_local(bloque, elementos_por_proceso, e.auxiliar_orden);
+        }
+        TemporizadorFase temporizador(FASE_REDUCCION);
+        e.ordenado = merge_en_arbol(ordenado, elementos_por_proceso, mi_rango, p);
+        break;
+    }
+    case NUCLEO_REDISTRIBUCION: {
+        TemporizadorFase temporizador(FASE_DISTRIBUCION);
+        bloques_a_ciclica_alltoallv(e.patron, e.vector_bloques, e.vector_ciclico, e.paquete);
+        ciclica_a_bloques_alltoallv(e.patron, e.vector_ciclico, e.vector_bloques, e.paquete);
+        break;
+    }
+    }
+}
+
+bool casi_igual(double valor, double esperado) {
+    return std::abs(valor - esperado) <= 1e-9 * std::max(1.0, std::abs(esperado));
+}
+
+// Verifica el resultado de la última ejecución en este proceso
+bool verificar(int nucleo, long long tamano, EspacioTrabajo& e, int mi_rango, int p) {
+    double n = tamano;
+    switch (nucleo) {
+    case NUCLEO_HISTOGRAMA: {
+        if (mi_rango != 0) return true;
+        long long total = 0;
+        for (int conteo : e.histograma_global) total += conteo;
+        return total == tamano;
+    }
+    case NUCLEO_PI: {
+        // Error de la estimación dentro de 6 desviaciones estándar (≈ 1.64 / sqrt(n))
+        if (mi_rango != 0) return true;
+        double estimacion = 4.0 * e.puntos_en_circulo / n;
+        return std::abs(estimacion - 3.141592653589793) <= 6 * 1.65 / std::sqrt(n);
+    }
+    case NUCLEO_ARBOL:
+    case NUCLEO_MARIPOSA: {
+        // Como en 3_4, la variante generalizada (p no potencia de 2) solo se
+        // verifica en el proceso 0: los procesos sin socio en algún paso no
+        // reciben todas las contribuciones
+        bool todos = nucleo == NUCLEO_MARIPOSA && (p & (p - 1)) == 0;
+        if (!todos && mi_rango != 0) return true;
+        for (double valor : e.suma_parcial) {
+            if (!casi_igual(valor, p * (p + 1) / 2.0)) return false;
+        }
+        return true;
+    }
+    case NUCLEO_COLUMNAS:
+    case NUCLEO_SUBMATRICES: {
+        // Con x[j] = j + 1: sum(j + 1) = n(n+1)/2, sum(j (j + 1)) = (n-1)n(n+1)/3,
+        // sum((j + 1)^2) = n(n+1)(2n+1)/6
+        if (mi_rango != 0) return true;
+        double s1 = n * (n + 1) / 2, s2 = (n - 1) * n * (n + 1) / 3, s3 = n * (n + 1) * (2 * n + 1) / 6;
+        for (long long i = 0; i < tamano; i++) {
+            double esperado = nucleo == NUCLEO_COLUMNAS ? (i + 1) * s1 + s2 : 10 * (i + 1) * s1 + s3;
+            if (!casi_igual(e.resultado[i], esperado)) return false;
+        }
+        return true;
+    }
+    case NUCLEO_PING_PONG:
+        return true;
+    case NUCLEO_MERGE_SORT:
+        if (mi_rango != 0) return true;
+        return (long long)e.ordenado.size() == tamano && std::is_sorted(e.ordenado.begin(), e.ordenado.end());
+    case NUCLEO_REDISTRIBUCION: {
+        int m = e.vector_bloques.size();
+        for (int i = 0; i < m; i++) {
+            if (e.vector_bloques[i] != (double)mi_rango * m + i) return false;
+            if (e.vector_ciclico[i] != (double)i * p + mi_rango) return false;
+        }
+        return true;
+    }
+    }
+    return false;
+}
+
+void liberar(int nucleo, EspacioTrabajo& e) {
+    if (nucleo == NUCLEO_REDISTRIBUCION && e.patron_creado) {
+        liberar_patron(e.patron);
+        e.patron_creado = false;
+    }
+}
+
+int buscar_nucleo(const std::string& nombre) {
+    for (int i = 0; i < NUMERO_NUCLEOS; i++) {
+        if (nombre == NOMBRES_NUCLEOS[i]) return i;
+    }
+    return -1;
+}
+
+// Tamaño con sufijo opcional K, M o G (potencias de 1024): "64K", "16M"
+long long interpretar_tamano(const std::string& texto) {
+    char* fin = nullptr;
+    long long valor = strtoll(texto.c_str(), &fin, 10);
+    if (fin == texto.c_str()) return -1;
+    if (*fin == 'K' || *fin == 'k') valor <<= 10, fin++;
+    else if (*fin == 'M' || *fin == 'm') valor <<= 20, fin++;
+    else if (*fin == 'G' || *fin == 'g') valor <<= 30, fin++;
+    return *fin == '\0' ? valor : -1;
+}
+
+// Agrega las configuraciones de un núcleo ("todos" = los nueve). Devuelve false
+// si el núcleo o algún tamaño no es válido
+bool agregar_configuraciones(const std::string& nombre, const std::vector<std::string>& tamanos,
+                             std::vector<Configuracion>& configuraciones) {
+    int nucleo = buscar_nucleo(nombre);
+    if (nucleo < 0 && nombre != "todos") {
+        std::cout << "Núcleo desconocido: " << nombre << std::endl;
+        return false;
+    }
+    for (int actual = 0; actual < NUMERO_NUCLEOS; actual++) {
+        if (nucleo >= 0 && actual != nucleo) continue;
+        for (const std::string& texto : tamanos) {
+            long long tamano = interpretar_tamano(texto);
+            if (tamano < 0) {
+                std::cout << "Tamaño no válido para " << nombre << ": " << texto << std::endl;
+                return false;
+            }
+            Configuracion configuracion = {actual, tamano};
+            configuraciones.push_back(configuracion);
+        }
+    }
+    return true;
+}
+
+// Archivo de configuración: una línea por núcleo, "nucleo tamaño [tamaño ...]";
+// las líneas vacías y lo que sigue a '#' se ignoran
+bool leer_archivo_configuracion(const std::string& ruta, std::vector<Configuracion>& configuraciones) {
+    std::ifstream archivo(ruta);
+    if (!archivo) {
+        std::cout << "No se pudo abrir " << ruta << std::endl;
+        return false;
+    }
+    std::string linea;
+    while (std::getline(archivo, linea)) {
+        linea = linea.substr(0, linea.find('#'));
+        std::istringstream palabras(linea);
+        std::string nombre, texto;
+        if (!(palabras >> nombre)) continue;
+        std::vector<std::string> tamanos;
+        while (palabras >> texto) tamanos.push_back(texto);
+        if (!agregar_configuraciones(nombre, tamanos, configuraciones)) return false;
+    }
+    return true;
+}
+
+// Barrido por defecto: tamaños chicos de todos los núcleos
+void configuraciones_por_defecto(std::vector<Configuracion>& configuraciones) {
+    const char* defecto[NUMERO_NUCLEOS][2] = {{"1M", "4M"},  {"1M", "4M"},  {"1K", "64K"},
+                                              {"1K", "64K"}, {"256", "1K"}, {"256", "1K"},
+                                              {"1K", "1M"},  {"1M", "4M"},  {"1M", "4M"}};
+    for (int nucleo = 0; nucleo < NUMERO_NUCLEOS; nucleo++) {
+        std::vector<std::string> tamanos(defecto[nucleo], defecto[nucleo] + 2);
+        agregar_configuraciones(NOMBRES_NUCLEOS[nucleo], tamanos, configuraciones);
+    }
+}
+
+// ==============================================
+// ESCALAMIENTO FUERTE Y DÉBIL
+// ==============================================
+
+// Tamaño para escalamiento débil con p procesos: el trabajo por proceso se
+// mantiene igual al de un proceso con el tamaño base
+long long tamano_debil(int nucleo, long long base, int p) {
+    switch (nucleo) {
+    case NUCLEO_COLUMNAS:
+    case NUCLEO_SUBMATRICES:
+        return std::llround(base * std::sqrt((double)p));  // n² / p constante
+    case NUCLEO_ARBOL:
+    case NUCLEO_MARIPOSA:
+    case NUCLEO_PING_PONG:
+        return base;  // el tamaño ya es por proceso o por mensaje
+    default:
+        return base * p;
+    }
+}
+
+// Una fila del archivo de escalamiento: una configuración con p procesos
+struct MedicionEscalamiento {
+    std::string modo, nucleo;
+    long long tamano_base, tamano;
+    int procesos;
+    double t_mediana;
+    double fases[NUMERO_FASES];
+    bool correcto;
+};
+
+std::string clave_grupo(const MedicionEscalamiento& m) {
+    return m.modo + "," + m.nucleo + "," + std::to_string(m.tamano_base);
+}
+
+// Lee un archivo de escalamiento; las columnas se buscan por nombre en el encabezado
+bool leer_escalamiento(const std::string& ruta, std::vector<MedicionEscalamiento>& mediciones) {
+    std::ifstream archivo(ruta);
+    std::string linea;
+    if (!archivo || !std::getline(archivo, linea)) {
+        std::cout << "No se pudo leer " << ruta << std::endl;
+        return false;
+    }
+    std::vector<std::string> columnas;
+    std::stringstream encabezado(linea);
+    std::string campo;
+    while (std::getline(encabezado, campo, ',')) columnas.push_back(campo);
+    auto indice = [&columnas](const std::string& nombre) {
+        return (int)(std::find(columnas.begin(), columnas.end(), nombre) - columnas.begin());
+    };
+
+    while (std::getline(archivo, linea)) {
+        if (linea.empty()) continue;
+        std::vector<std::string> campos;
+        std::stringstream fila(linea);
+        while (std::getline(fila, campo, ',')) campos.push_back(campo);
+        campos.resize(columnas.size() + 1);  // una columna ausente queda vacía
+
+        MedicionEscalamiento m;
+        m.modo = campos[indice("modo")];
+        m.nucleo = campos[indice("nucleo")];
+        m.tamano_base = atoll(campos[indice("tamano_base")].c_str());
+        m.tamano = atoll(campos[indice("tamano")].c_str());
+        m.procesos = atoi(campos[indice("procesos")].c_str());
+        m.t_mediana = atof(campos[indice("t_mediana_s")].c_str());
+        for (int fase = 0; fase < NUMERO_FASES; fase++) {
+            m.fases[fase] = atof(campos[indice(std::string("t_") + NOMBRES_FASES[fase] + "_s")].c_str());
+        }
+        m.correcto = campos[indice("correcto")] == "1";
+        if (m.procesos > 0 && m.t_mediana > 0) mediciones.push_back(m);
+    }
+    return true;
+}
+
+// Speedup, eficiencia y fracción serial de Karp-Flatt de cada medición
+// respecto de la de menos procesos de su grupo (modo, núcleo, tamaño base),
+// y comparación con una línea base. Devuelve la cantidad de regresiones
+// (tiempo mayor que el de la línea base en más de la tolerancia) o -1 si no
+// se pudieron leer los archivos
+int analizar_escalamiento(const std::string& ruta, const std::string& ruta_base, double tolerancia,
+                          const std::string& ruta_salida) {
+    std::vector<MedicionEscalamiento> mediciones, base;
+    if (!leer_escalamiento(ruta, mediciones)) return -1;
+    if (!ruta_base.empty() && !leer_escalamiento(ruta_base, base)) return -1;
+
+    std::sort(mediciones.begin(), mediciones.end(),
+              [](const MedicionEscalamiento& a, const MedicionEscalamiento& b) {
+                  if (clave_grupo(a) != clave_grupo(b)) return clave_grupo(a) < clave_grupo(b);
+                  return a.procesos < b.procesos;
+              });
+
+    std::ofstream salida(ruta_salida);
+    salida << "modo,nucleo,tamano_base,tamano,procesos,t_mediana_s,referencia,speedup,eficiencia,karp_flatt,"
+              "fase_dominante,t_linea_base_s,cambio_relativo,regresion"
+           << std::endl;
+
+    std::cout << "=== ANÁLISIS DE ESCALAMIENTO ===" << std::endl;
+    std::cout << "Speedup y eficiencia respecto de la medición con menos procesos de cada grupo: absolutos si"
+              << " es p = 1, relativos a ese p si no (sin Karp-Flatt); ping_pong solo latencia" << std::endl;
+    if (!ruta_base.empty()) {
+        std::cout << "Línea base: " << ruta_base << " (regresión si el tiempo sube más de "
+                  << std::fixed << std::setprecision(0) << tolerancia * 100 << "%)" << std::endl;
+    }
+    std::cout << "\n  " << rellenar("Modo", 8) << rellenar("Núcleo", 16) << std::setw(11) << "Tamaño" << std::setw(6)
+              << "p" << std::setw(12) << "T (s)" << "  " << rellenar("Referencia", 12) << std::setw(9) << "Speedup"
+              << std::setw(11) << "Eficiencia"
+              << std::setw(12) << "Karp-Flatt" << "  " << rellenar("Fase dominante", 16) << "Línea base" << std::endl;
+
+    int regresiones = 0;
+    size_t inicio_grupo = 0;
+    for (size_t i = 0; i < mediciones.size(); i++) {
+        const MedicionEscalamiento& m = mediciones[i];
+        if (clave_grupo(m) != clave_grupo(mediciones[inicio_grupo])) inicio_grupo = i;
+        const MedicionEscalamiento& referencia = mediciones[inicio_grupo];
+
+        // Fuerte: S = T_ref / T y E = S p_ref / p. Débil: E = T_ref / T y el
+        // speedup escalado es S = (p / p_ref) E. Con p_ref = 1 son absolutos;
+        // si no, son relativos a p_ref (no se supone escalamiento lineal hasta
+        // p_ref) y Karp-Flatt, e = (1/S - 1/p) / (1 - 1/p), no aplica.
+        // ping_pong mide un solo par sin importar p: solo se informa su latencia
+        bool solo_latencia = m.nucleo == NOMBRES_NUCLEOS[NUCLEO_PING_PONG];
+        bool relativo = referencia.procesos > 1;
+        double escala = (double)m.procesos / referencia.procesos;
+        double speedup, eficiencia;
+        if (m.modo == "debil") {
+            eficiencia = referencia.t_mediana / m.t_mediana;
+            speedup = escala * eficiencia;
+        } else {
+            speedup = referencia.t_mediana / m.t_mediana;
+            eficiencia = speedup / escala;
+        }
+        std::string tipo_referencia = solo_latencia ? "latencia" : relativo ? "relativo" : "absoluto";
+        std::string texto_referencia =
+            solo_latencia ? "latencia" : "p=" + std::to_string(referencia.procesos) + (relativo ? " rel." : "");
+        bool con_karp_flatt = !solo_latencia && !relativo && m.procesos > 1;
+        double karp_flatt = con_karp_flatt ? (1.0 / speedup - 1.0 / m.procesos) / (1.0 - 1.0 / m.procesos) : 0.0;
+        // La entrada se mide una vez por configuración, fuera del tiempo total
+        int dominante = std::max_element(m.fases + FASE_DISTRIBUCION, m.fases + NUMERO_FASES) - m.fases;
+
+        double t_base = 0.0;
+        for (const MedicionEscalamiento& b : base) {
+            if (clave_grupo(b) == clave_grupo(m) && b.procesos == m.procesos) t_base = b.t_mediana;
+        }
+        double cambio = t_base > 0 ? m.t_mediana / t_base - 1.0 : 0.0;
+        bool regresion = t_base > 0 && cambio > tolerancia;
+        if (regresion) regresiones++;
+
+        std::cout << "  " << rellenar(m.modo, 8) << rellenar(m.nucleo, 16) << std::setw(11) << m.tamano
+                  << std::setw(6) << m.procesos << std::fixed << std::setprecision(6) << std::setw(12)
+                  << m.t_mediana << "  " << rellenar(texto_referencia, 12) << std::setprecision(2);
+        if (solo_latencia) std::cout << std::setw(9) << "-" << std::setw(11) << "-";
+        else std::cout << std::setw(9) << speedup << std::setw(11) << eficiencia;
+        std::cout << std::setprecision(3) << std::setw(12);
+        if (con_karp_flatt) std::cout << karp_flatt;
+        else std::cout << "-";
+        std::cout << "  " << rellenar(NOMBRES_FASES[dominante], 16);
+        if (t_base > 0) {
+            std::cout << std::showpos << std::setprecision(1) << cambio * 100 << "%" << std::noshowpos
+                      << (regresion ? "  ⚠️ regresión" : "");
+        }
+        if (!m.correcto) std::cout << "  ❌ resultado incorrecto";
+        std::cout << std::endl;
+
+        salida << m.modo << "," << m.nucleo << "," << m.tamano_base << "," << m.tamano << "," << m.procesos
+               << std::scientific << std::setprecision(6) << "," << m.t_mediana << "," << tipo_referencia << ",";
+        if (!solo_latencia) salida << speedup << "," << eficiencia;
+        else salida << ",";
+        salida << ",";
+        if (con_karp_flatt) salida << karp_flatt;
+        salida << "," << NOMBRES_FASES[dominante] << ",";
+        if (t_base > 0) salida << t_base << "," << cambio;
+        else salida << ",";
+        salida << "," << (regresion ? 1 : 0) << std::endl;
+        salida.unsetf(std::ios::floatfield);
+    }
+
+    std::cout << "\nAnálisis en " << ruta_salida;
+    if (!ruta_base.empty()) std::cout << "; regresiones: " << regresiones;
+    std::cout << std::endl;
+    return regresiones;
+}
+
+int main(int argc, char* argv[]) {
+    int numero_procesos, mi_rango;
+    double inicio_mpi = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    MPI_Init(&argc, &argv);
+    double tiempo_inicio_mpi =
+        std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count() - inicio_mpi;
+    MPI_Comm_size(MPI_COMM_WORLD, &numero_procesos);
+    MPI_Comm_rank(MPI_COMM_WORLD, &mi_rango);
+
+    // El proceso 0 interpreta los argumentos:
+    //   nucleo=t1,t2,...   tamaños de un núcleo ("todos=..." para los nueve)
+    //   --config=archivo   configuraciones desde un archivo
+    //   --calentamiento=N  ejecuciones sin medir por configuración (1)
+    //   --repeticiones=N   ejecuciones medidas por configuración (5)
+    //   --csv=archivo      resultados (barrido_nucleos.csv; vacío para no escribirlos)
+    //   --debil            escalamiento débil: los tamaños son los de un proceso y
+    //                      crecen con p (ver tamano_debil)
+    //   --escalamiento=archivo  agrega las mediciones a un archivo de escalamiento
+    //   --analizar=archivo      solo analiza un archivo de escalamiento:
+    //   --base=archivo          línea base contra la que buscar regresiones
+    //   --tolerancia=F          aumento relativo tolerado (0.10)
+    std::vector<Configuracion> configuraciones;
+    int parametros[4] = {1, 5, 1, 0};  // calentamiento, repeticiones, argumentos válidos, débil
+    std::string ruta_csv = "barrido_nucleos.csv", ruta_escalamiento, ruta_analisis, ruta_base;
+    double tolerancia = 0.10;
+    if (mi_rango == 0) {
+        for (int i = 1; i < argc && parametros[2]; i++) {
+            std::string argumento = argv[i];
+            size_t igual = argumento.find('=');
+            std::string clave = argumento.substr(0, igual);
+            std::string valor = igual == std::string::npos ? "" : argumento.substr(igual + 1);
+            if (clave == "--config") {
+                parametros[2] = leer_archivo_configuracion(valor, configuraciones);
+            } else if (clave == "--calentamiento") {
+                parametros[0] = std::max(0, atoi(valor.c_str()));
+            } else if (clave == "--repeticiones") {
+                parametros[1] = std::max(1, atoi(valor.c_str()));
+            } else if (clave == "--csv") {
+                ruta_csv = valor;
+            } else if (clave == "--debil") {
+                parametros[3] = 1;
+            } else if (clave == "--escalamiento") {
+                ruta_escalamiento = valor;
+            } else if (clave == "--analizar") {
+                ruta_analisis = valor;
+            } else if (clave == "--base") {
+                ruta_base = valor;
+            } else if (clave == "--tolerancia") {
+                tolerancia = atof(valor.c_str());
+            } else if (igual != std::string::npos) {
+                std::vector<std::string> tamanos;
+                std::stringstream lista(valor);
+                std::string texto;
+                while (std::getline(lista, texto, ',')) tamanos.push_back(texto);
+                parametros[2] = agregar_configuraciones(clave, tamanos, configuraciones);
+            } else {
+                std::cout << "Argumento no reconocido: " << argumento << std::endl;
+                parametros[2] = 0;
+            }
+        }
+        if (parametros[2] && configuraciones.empty()) configuraciones_por_defecto(configuraciones);
+
+        // Modo análisis: el resultado (1 si hubo regresiones o errores) reemplaza la validez
+        if (parametros[2] && !ruta_analisis.empty()) {
+            int regresiones = analizar_escalamiento(ruta_analisis, ruta_base, tolerancia, "escalamiento_analisis.csv");
+            parametros[2] = regresiones == 0 ? -1 : -2;
+        }
+    }
+    MPI_Bcast(parametros, 4, MPI_INT, 0, MPI_COMM_WORLD);
+    if (parametros[2] <= 0) {
+        MPI_Finalize();
+        return parametros[2] == -1 ? 0 : 1;
+    }
+    int calentamiento = parametros[0], repeticiones = parametros[1];
+    bool debil = parametros[3] != 0;
+
+    int numero_configuraciones = configuraciones.size();
+    MPI_Bcast(&numero_configuraciones, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    std::vector<int> nucleos(numero_configuraciones);
+    std::vector<long long> tamanos(numero_configuraciones);
+    if (mi_rango == 0) {
+        for (int i = 0; i < numero_configuraciones; i++) {
+            nucleos[i] = configuraciones[i].nucleo;
+            tamanos[i] = configuraciones[i].tamano;
+        }
+    }
+    MPI_Bcast(nucleos.data(), numero_configuraciones, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Bcast(tamanos.data(), numero_configuraciones, MPI_LONG_LONG, 0, MPI_COMM_WORLD);
+
+    EspacioTrabajo espacio;
+    espacio.patron_creado = false;
+    espacio.reservas = 0;
+    espacio.puntos_en_circulo = 0;
+    espacio.generador.seed(12345 + mi_rango);
+    srand(12345);
+    espacio.sqrt_procesos = (int)std::sqrt((double)numero_procesos);
+    while (espacio.sqrt_procesos * espacio.sqrt_procesos > numero_procesos) espacio.sqrt_procesos--;
+    while ((espacio.sqrt_procesos + 1) * (espacio.sqrt_procesos + 1) <= numero_procesos) espacio.sqrt_procesos++;
+    espacio.comunicador_fila = MPI_COMM_NULL;
+    if (espacio.sqrt_procesos * espacio.sqrt_procesos == numero_procesos) {
+        MPI_Comm_split(MPI_COMM_WORLD, mi_rango / espacio.sqrt_procesos, mi_rango % espacio.sqrt_procesos,
+                       &espacio.comunicador_fila);
+    }
+
+    double inicio_mpi_max;
+    MPI_Reduce(&tiempo_inicio_mpi, &inicio_mpi_max, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    std::ofstream archivo_csv, archivo_escalamiento;
+    if (mi_rango == 0) {
+        std::cout << "=== BARRIDO DE NÚCLEOS ===" << std::endl;
+        std::cout << numero_procesos << " procesos, " << numero_configuraciones << " configuraciones, "
+                  << calentamiento << " de calentamiento y " << repeticiones << " medidas por configuración"
+                  << (debil ? ", escalamiento débil" : "") << std::endl;
+        std::cout << "MPI_Init (máx. entre procesos, se paga una sola vez): " << std::fixed << std::setprecision(3)
+                  << inicio_mpi_max << " s" << std::endl;
+        std::cout << "\n  " << rellenar("Núcleo", 16) << std::setw(12) << "Tamaño" << std::setw(12) << "Mín. (s)"
+                  << std::setw(13) << "Mediana (s)" << std::setw(12) << "Máx. (s)" << std::setw(16)
+                  << "Buffers nuevos" << "  Correcto" << std::endl;
+        if (!ruta_csv.empty()) {
+            archivo_csv.open(ruta_csv);
+            archivo_csv << "nucleo,unidad,tamano,procesos,calentamiento,repeticiones,t_min_s,t_mediana_s,t_max_s";
+            for (int fase = 0; fase < NUMERO_FASES; fase++) archivo_csv << ",t_" << NOMBRES_FASES[fase] << "_s";
+            archivo_csv << ",buffers_nuevos,correcto" << std::endl;
+        }
+        if (!ruta_escalamiento.empty()) {
+            // El encabezado solo si el archivo es nuevo: cada corrida (un p) agrega sus filas
+            std::ifstream existente(ruta_escalamiento);
+            bool nuevo = !existente || existente.peek() == std::ifstream::traits_type::eof();
+            existente.close();
+            archivo_escalamiento.open(ruta_escalamiento, std::ios::app);
+            if (nuevo) {
+                archivo_escalamiento << "modo,nucleo,tamano_base,tamano,procesos,repeticiones,t_min_s,t_mediana_s";
+                for (int fase = 0; fase < NUMERO_FASES; fase++) {
+                    archivo_escalamiento << ",t_" << NOMBRES_FASES[fase] << "_s";
+                }
+                archivo_escalamiento << ",correcto" << std::endl;
+            }
+        }
+    }
+
+    for (int c = 0; c < numero_configuraciones; c++) {
+        int nucleo = nucleos[c];
+        long long tamano_base = tamanos[c];
+        long long tamano = debil ? tamano_debil(nucleo, tamano_base, numero_procesos) : tamano_base;
+        long long reservas_antes = espacio.reservas;
+
+        // Todos los procesos llegan a la misma decisión: depende solo de p y del tamaño
+        std::string motivo;
+        reiniciar_fases();
+        {
+            TemporizadorFase temporizador(FASE_ENTRADA);
+            motivo = preparar(nucleo, tamano, espacio, mi_rango, numero_procesos);
+        }
+        double tiempo_entrada = tiempos_fases()[FASE_ENTRADA];
+        if (!motivo.empty()) {
+            if (mi_rango == 0) {
+                std::cout << "  " << rellenar(NOMBRES_NUCLEOS[nucleo], 16) << std::setw(12) << tamano
+                          << "  omitido: " << motivo << std::endl;
+            }
+            continue;
+        }
+
+        // Por repetición: el máximo entre procesos de cada fase y del total (última posición)
+        std::vector<double> tiempos;
+        std::vector<std::vector<double>> tiempos_por_fase(NUMERO_FASES);
+        for (int repeticion = -calentamiento; repeticion < repeticiones; repeticion++) {
+            reiniciar(nucleo, espacio, mi_rango);
+            reiniciar_fases();
+            MPI_Barrier(MPI_COMM_WORLD);
+            double inicio = MPI_Wtime();
+            ejecutar(nucleo, tamano, espacio, mi_rango, numero_procesos);
+            double locales[NUMERO_FASES + 1], maximos[NUMERO_FASES + 1];
+            locales[NUMERO_FASES] = MPI_Wtime() - inicio;
+            std::copy(tiempos_fases(), tiempos_fases() + NUMERO_FASES, locales);
+            locales[FASE_ENTRADA] = tiempo_entrada;
+            MPI_Allreduce(locales, maximos, NUMERO_FASES + 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+            if (repeticion < 0) continue;
+            tiempos.push_back(maximos[NUMERO_FASES]);
+            for (int fase = 0; fase < NUMERO_FASES; fase++) tiempos_por_fase[fase].push_back(maximos[fase]);
+        }
+
+        int correcto_local = verificar(nucleo, tamano, espacio, mi_rango, numero_procesos), correcto_global;
+        MPI_Allreduce(&correcto_local, &correcto_global, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+        long long reservas = espacio.reservas - reservas_antes, reservas_max;
+        MPI_Reduce(&reservas, &reservas_max, 1, MPI_LONG_LONG, MPI_MAX, 0, MPI_COMM_WORLD);
+        liberar(nucleo, espacio);
+
+        if (mi_rango == 0) {
+            std::sort(tiempos.begin(), tiempos.end());
+            double mediana = tiempos[tiempos.size() / 2];
+            double medianas_fases[NUMERO_FASES];
+            for (int fase = 0; fase < NUMERO_FASES; fase++) {
+                std::sort(tiempos_por_fase[fase].begin(), tiempos_por_fase[fase].end());
+                medianas_fases[fase] = tiempos_por_fase[fase][tiempos_por_fase[fase].size() / 2];
+            }
+            std::cout << "  " << rellenar(NOMBRES_NUCLEOS[nucleo], 16) << std::setw(12) << tamano << std::fixed
+                      << std::setprecision(6) << std::setw(12) << tiempos.front() << std::setw(13) << mediana
+                      << std::setw(12) << tiempos.back() << std::setw(16) << reservas_max << "  "
+                      << (correcto_global ? "✅" : "❌") << std::endl;
+            if (archivo_csv.is_open()) {
+                archivo_csv << NOMBRES_NUCLEOS[nucleo] << "," << UNIDADES_NUCLEOS[nucleo] << "," << tamano << ","
+                            << numero_procesos << "," << calentamiento << "," << repeticiones << std::scientific
+                            << std::setprecision(6) << "," << tiempos.front() << "," << mediana << ","
+                            << tiempos.back();
+                for (int fase = 0; fase < NUMERO_FASES; fase++) archivo_csv << "," << medianas_fases[fase];
+                archivo_csv << "," << reservas_max << "," << (correcto_global ? 1 : 0) << std::endl;
+                archivo_csv.unsetf(std::ios::floatfield);
+            }
+            if (archivo_escalamiento.is_open()) {
+                archivo_escalamiento << (debil ? "debil" : "fuerte") << "," << NOMBRES_NUCLEOS[nucleo] << ","
+                                     << tamano_base << "," << tamano << "," << numero_procesos << ","
+                                     << repeticiones << std::scientific << std::setprecision(6) << ","
+                                     << tiempos.front() << "," << mediana;
+                for (int fase = 0; fase < NUMERO_FASES; fase++) archivo_escalamiento << "," << medianas_fases[fase];
+                archivo_escalamiento << "," << (correcto_global ? 1 : 0) << std::endl;
+                archivo_escalamiento.unsetf(std::ios::floatfield);
+            }
+            std::cout.unsetf(std::ios::floatfield);
+        }
+    }
+
+    if (mi_rango == 0 && !ruta_csv.empty()) std::cout << "\nResultados en " << ruta_csv << std::endl;
+    if (mi_rango == 0 && !ruta_escalamiento.empty()) {
+        std::cout << "Mediciones agregadas a " << ruta_escalamiento << std::endl;
+    }
+
+    if (espacio.comunicador_fila != MPI_COMM_NULL) MPI_Comm_free(&espacio.comunicador_fila);
+    espacio.copia_nodo.liberar();
+    reportar_pool(MPI_COMM_WORLD);
+    pool_buffers().vaciar();
+    MPI_Finalize();
+    return 0;
+}
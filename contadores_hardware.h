@@ -0,0 +1,308 @@
+#ifndef CONTADORES_HARDWARE_H
+#define CONTADORES_HARDWARE_H
+
+#include <mpi.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "temporizador_fases.h"
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Contadores de hardware opcionales (perf_event_open) alrededor de los bucles
+// principales. Se activan con la variable de entorno CONTADORES_HW=1; sin ella
+// las mediciones no hacen nada. Los contadores que el sistema no provee (por
+// ejemplo en una máquina virtual o con perf_event_paranoid alto) quedan en -1
+// y el reporte usa el tiempo de CPU y los bytes declarados por cada bucle
+enum Contador {
+    CONTADOR_CICLOS,
+    CONTADOR_INSTRUCCIONES,
+    CONTADOR_FALLOS_LLC,     // fallos de la última caché: cada uno trae una línea de memoria
+    CONTADOR_FALLOS_SALTO,   // predicciones de salto erradas
+    CONTADOR_FALLOS_PAGINA,  // contador de software: primer toque de páginas nuevas
+    NUMERO_CONTADORES
+};
+
+static const char* const NOMBRES_CONTADORES[NUMERO_CONTADORES] = {"ciclos", "instrucciones", "fallos_llc",
+                                                                  "fallos_salto", "fallos_pagina"};
+
+// Bytes que trae de memoria cada fallo de la última caché
+const int BYTES_LINEA_CACHE = 64;
+
+// Descriptores de los contadores de este proceso (-1 si no está disponible)
+struct ContadoresProceso {
+    bool activos;
+    int descriptores[NUMERO_CONTADORES];
+    std::string motivo;  // por qué faltan los de hardware, si faltan
+};
+
+inline ContadoresProceso abrir_contadores() {
+    ContadoresProceso contadores;
+    const char* variable = getenv("CONTADORES_HW");
+    contadores.activos = variable && *variable && strcmp(variable, "0") != 0;
+    for (int c = 0; c < NUMERO_CONTADORES; c++) contadores.descriptores[c] = -1;
+    if (!contadores.activos) return contadores;
+
+#ifdef __linux__
+    const unsigned int tipos[NUMERO_CONTADORES] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+                                                   PERF_TYPE_HARDWARE, PERF_TYPE_SOFTWARE};
+    const unsigned long long configuraciones[NUMERO_CONTADORES] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_SW_PAGE_FAULTS};
+
+    // Cada contador por separado (sin grupo) para que la falta de uno no
+    // impida abrir los demás; solo el hilo que llama, sin el núcleo
+    for (int c = 0; c < NUMERO_CONTADORES; c++) {
+        perf_event_attr atributos;
+        memset(&atributos, 0, sizeof(atributos));
+        atributos.size = sizeof(atributos);
+        atributos.type = tipos[c];
+        atributos.config = configuraciones[c];
+        atributos.exclude_kernel = 1;
+        atributos.exclude_hv = 1;
+        atributos.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        contadores.descriptores[c] = syscall(SYS_perf_event_open, &atributos, 0, -1, -1, 0);
+        if (contadores.descriptores[c] < 0 && c < CONTADOR_FALLOS_PAGINA && contadores.motivo.empty()) {
+            contadores.motivo = std::string(NOMBRES_CONTADORES[c]) + ": " + strerror(errno);
+        }
+    }
+#else
+    contadores.motivo = "perf_event_open solo existe en Linux";
+#endif
+    return contadores;
+}
+
+inline ContadoresProceso& contadores_proceso() {
+    static ContadoresProceso contadores = abrir_contadores();
+    return contadores;
+}
+
+// Valor actual de cada contador, escalado si el núcleo los multiplexó (-1 si no está)
+inline void leer_contadores(double valores[NUMERO_CONTADORES]) {
+    for (int c = 0; c < NUMERO_CONTADORES; c++) {
+        valores[c] = -1.0;
+#ifdef __linux__
+        unsigned long long lectura[3];  // valor, tiempo habilitado, tiempo contando
+        int descriptor = contadores_proceso().descriptores[c];
+        if (descriptor >= 0 && read(descriptor, lectura, sizeof(lectura)) == (ssize_t)sizeof(lectura)) {
+            valores[c] = lectura[2] > 0 ? (double)lectura[0] * lectura[1] / lectura[2] : 0.0;
+        }
+#endif
+    }
+}
+
+// Tiempo de CPU del hilo, disponible aunque falten todos los contadores
+inline double tiempo_cpu_hilo() {
+    timespec ahora;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ahora);
+    return ahora.tv_sec + ahora.tv_nsec * 1e-9;
+}
+
+// Lo acumulado por una región en este proceso
+struct RegionHardware {
+    std::string nombre;
+    long long veces;
+    double elementos, bytes;  // bytes que el bucle recorre al menos una vez
+    double segundos, segundos_cpu;
+    double contadores[NUMERO_CONTADORES];  // -1 si no está disponible
+    bool solo_hilo_principal;              // hubo trabajo en otros hilos, fuera de los contadores
+};
+
+inline std::vector<RegionHardware>& regiones_hardware() {
+    static std::vector<RegionHardware> regiones;
+    return regiones;
+}
+
+inline RegionHardware& region_hardware(const char* nombre) {
+    for (RegionHardware& region : regiones_hardware()) {
+        if (region.nombre == nombre) return region;
+    }
+    RegionHardware region;
+    region.nombre = nombre;
+    region.veces = 0;
+    region.elementos = region.bytes = region.segundos = region.segundos_cpu = 0.0;
+    for (int c = 0; c < NUMERO_CONTADORES; c++) region.contadores[c] = 0.0;
+    region.solo_hilo_principal = false;
+    regiones_hardware().push_back(region);
+    return regiones_hardware().back();
+}
+
+// Suma a la región los contadores de su ámbito, junto con los elementos que
+// procesa y los bytes que recorre:
+//   { MedicionHardware m("histograma", n, n * sizeof(float)); ...bucle... }
+// Los contadores son del hilo que mide. Si el bucle reparte trabajo entre
+// otros hilos, "otros_hilos" marca la región y el reporte deja solo las
+// métricas de reloj y de bytes, que sí cubren todo el trabajo
+class MedicionHardware {
+public:
+    MedicionHardware(const char* nombre, double elementos, double bytes, bool otros_hilos = false)
+        : activa(contadores_proceso().activos), nombre(nombre), elementos(elementos), bytes(bytes),
+          otros_hilos(otros_hilos) {
+        if (!activa) return;
+        leer_contadores(inicio);
+        inicio_cpu = tiempo_cpu_hilo();
+        inicio_reloj = reloj_monotono();
+    }
+
+    ~MedicionHardware() {
+        if (!activa) return;
+        double fin_reloj = reloj_monotono(), fin_cpu = tiempo_cpu_hilo(), fin[NUMERO_CONTADORES];
+        leer_contadores(fin);
+
+        RegionHardware& region = region_hardware(nombre);
+        region.veces++;
+        region.elementos += elementos;
+        region.bytes += bytes;
+        region.segundos += fin_reloj - inicio_reloj;
+        region.segundos_cpu += fin_cpu - inicio_cpu;
+        if (otros_hilos) region.solo_hilo_principal = true;
+        for (int c = 0; c < NUMERO_CONTADORES; c++) {
+            if (fin[c] < 0 || region.contadores[c] < 0) region.contadores[c] = -1.0;
+            else region.contadores[c] += fin[c] - inicio[c];
+        }
+    }
+
+private:
+    bool activa;
+    const char* nombre;
+    double elementos, bytes;
+    bool otros_hilos;
+    double inicio[NUMERO_CONTADORES], inicio_cpu, inicio_reloj;
+};
+
+// Métricas por proceso de cada región, impresas por la raíz. Colectiva; no
+// hace nada si ningún proceso activó los contadores:
+//  - IPC: instrucciones por ciclo
+//  - fallos de LLC y de salto por elemento
+//  - GB/s (LLC): fallos de LLC x 64 bytes / tiempo, el tráfico real con memoria
+//  - GB/s (datos): bytes declarados / tiempo, disponible siempre
+// En las regiones con trabajo en otros hilos, CPU %, IPC, las métricas por
+// elemento de los contadores y los fallos de página quedan en "-"
+inline void reportar_contadores(MPI_Comm comunicador, int raiz = 0) {
+    // Fuera del perfil de perfil_pmpi.cpp hasta terminar de juntar las regiones
+    MPI_Pcontrol(0);
+    int activos_local = contadores_proceso().activos ? 1 : 0, activos;
+    MPI_Allreduce(&activos_local, &activos, 1, MPI_INT, MPI_MAX, comunicador);
+    if (!activos) {
+        MPI_Pcontrol(1);
+        return;
+    }
+
+    int mi_rango, numero_procesos;
+    MPI_Comm_rank(comunicador, &mi_rango);
+    MPI_Comm_size(comunicador, &numero_procesos);
+
+    // Cada proceso manda sus regiones como texto (los nombres son cadenas)
+    std::ostringstream salida;
+    salida << std::setprecision(17);
+    for (const RegionHardware& region : regiones_hardware()) {
+        salida << region.nombre << ' ' << region.veces << ' ' << region.elementos << ' ' << region.bytes << ' '
+               << region.segundos << ' ' << region.segundos_cpu << ' ' << region.solo_hilo_principal;
+        for (int c = 0; c < NUMERO_CONTADORES; c++) salida << ' ' << region.contadores[c];
+        salida << '\n';
+    }
+    std::string texto = salida.str();
+    if (mi_rango == raiz && !contadores_proceso().motivo.empty()) {
+        texto = "#" + contadores_proceso().motivo + "\n" + texto;
+    }
+
+    int longitud = texto.size();
+    std::vector<int> longitudes(numero_procesos), desplazamientos(numero_procesos, 0);
+    MPI_Gather(&longitud, 1, MPI_INT, longitudes.data(), 1, MPI_INT, raiz, comunicador);
+    std::string todo;
+    if (mi_rango == raiz) {
+        for (int q = 1; q < numero_procesos; q++) desplazamientos[q] = desplazamientos[q - 1] + longitudes[q - 1];
+        todo.resize(desplazamientos[numero_procesos - 1] + longitudes[numero_procesos - 1]);
+    }
+    MPI_Gatherv(texto.data(), longitud, MPI_CHAR, &todo[0], longitudes.data(), desplazamientos.data(), MPI_CHAR,
+                raiz, comunicador);
+    MPI_Pcontrol(1);
+    if (mi_rango != raiz) return;
+
+    // Filas (proceso, región) agrupadas por región en orden de aparición
+    std::vector<std::string> nombres;
+    std::vector<std::vector<std::pair<int, RegionHardware>>> filas;
+    std::string motivo;
+    for (int q = 0; q < numero_procesos; q++) {
+        std::istringstream lineas(todo.substr(desplazamientos[q], longitudes[q]));
+        std::string linea;
+        while (std::getline(lineas, linea)) {
+            if (linea.empty()) continue;
+            if (linea[0] == '#') {
+                motivo = linea.substr(1);
+                continue;
+            }
+            std::istringstream campos(linea);
+            RegionHardware r;
+            campos >> r.nombre >> r.veces >> r.elementos >> r.bytes >> r.segundos >> r.segundos_cpu >>
+                r.solo_hilo_principal;
+            for (int c = 0; c < NUMERO_CONTADORES; c++) campos >> r.contadores[c];
+            size_t i = std::find(nombres.begin(), nombres.end(), r.nombre) - nombres.begin();
+            if (i == nombres.size()) {
+                nombres.push_back(r.nombre);
+                filas.emplace_back();
+            }
+            filas[i].push_back(std::make_pair(q, r));
+        }
+    }
+
+    std::ios formato(nullptr);
+    formato.copyfmt(std::cout);
+    std::cout << "\n=== CONTADORES DE HARDWARE POR PROCESO ===" << std::endl;
+    if (!motivo.empty()) {
+        std::cout << "Sin contadores de hardware en el proceso " << raiz << " (" << motivo
+                  << "): se reportan tiempo de CPU y GB/s a partir de los bytes recorridos" << std::endl;
+    }
+
+    // Un valor o "-" si el contador no estaba
+    auto columna = [](double valor, int ancho, int decimales) {
+        std::ostringstream texto;
+        if (valor < 0) texto << std::setw(ancho) << "-";
+        else texto << std::fixed << std::setprecision(decimales) << std::setw(ancho) << valor;
+        return texto.str();
+    };
+
+    for (size_t i = 0; i < nombres.size(); i++) {
+        bool solo_hilo_principal = false;
+        for (const auto& par : filas[i]) solo_hilo_principal = solo_hilo_principal || par.second.solo_hilo_principal;
+        std::cout << "\nRegión " << nombres[i]
+                  << (solo_hilo_principal ? " (solo hilo principal: se omiten CPU % y contadores)" : "")
+                  << ":" << std::endl;
+        std::cout << "  " << std::setw(7) << "Proceso" << std::setw(13) << "Elementos" << std::setw(12) << "Tiempo (s)"
+                  << std::setw(9) << "CPU %" << std::setw(10) << "ns/elem" << std::setw(7) << "IPC" << std::setw(11)
+                  << "LLC/elem" << std::setw(12) << "Saltos/elem" << std::setw(11) << "GB/s LLC" << std::setw(12)
+                  << "GB/s datos" << std::setw(13) << "Fallos pág." << std::endl;
+        for (const auto& par : filas[i]) {
+            const RegionHardware& r = par.second;
+            double c[NUMERO_CONTADORES];
+            for (int k = 0; k < NUMERO_CONTADORES; k++) c[k] = r.solo_hilo_principal ? -1.0 : r.contadores[k];
+            double cpu = r.solo_hilo_principal ? -1.0 : 100.0 * r.segundos_cpu / std::max(r.segundos, 1e-12);
+            double elementos = std::max(r.elementos, 1.0), segundos = std::max(r.segundos, 1e-12);
+            std::cout << "  " << std::setw(7) << par.first << std::setw(13) << (long long)r.elementos << std::fixed
+                      << std::setprecision(6) << std::setw(12) << r.segundos
+                      << columna(cpu, 9, 1)
+                      << columna(1e9 * r.segundos / elementos, 10, 3)
+                      << columna(c[CONTADOR_CICLOS] > 0 && c[CONTADOR_INSTRUCCIONES] >= 0
+                                     ? c[CONTADOR_INSTRUCCIONES] / c[CONTADOR_CICLOS] : -1.0, 7, 2)
+                      << columna(c[CONTADOR_FALLOS_LLC] >= 0 ? c[CONTADOR_FALLOS_LLC] / elementos : -1.0, 11, 4)
+                      << columna(c[CONTADOR_FALLOS_SALTO] >= 0 ? c[CONTADOR_FALLOS_SALTO] / elementos : -1.0, 12, 4)
+                      << columna(c[CONTADOR_FALLOS_LLC] >= 0
+                                     ? c[CONTADOR_FALLOS_LLC] * BYTES_LINEA_CACHE / segundos / 1e9 : -1.0, 11, 2)
+                      << columna(r.bytes > 0 ? r.bytes / segundos / 1e9 : -1.0, 12, 2)
+                      << columna(c[CONTADOR_FALLOS_PAGINA], 12, 0) << std::endl;
+        }
+    }
+    std::cout.copyfmt(formato);
+}
+
+#endif
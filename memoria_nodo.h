@@ -0,0 +1,207 @@
+#ifndef MEMORIA_NODO_H
+#define MEMORIA_NODO_H
+
+#include <mpi.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// Datos compartidos por nodo (MPI-3, MPI_Win_allocate_shared). Con la
+// variable de entorno MEMORIA_NODO=1, los datos que se difunden o reparten
+// desde el proceso 0 llegan una sola vez a cada nodo: el proceso 0 los envía
+// solo a los líderes (el primer proceso de cada nodo), el líder los deja en
+// una ventana de memoria compartida y los demás procesos del nodo la leen
+// directamente, sin copia propia ni mensaje
+inline bool memoria_nodo_activa() {
+    static const bool activa = [] {
+        const char* variable = getenv("MEMORIA_NODO");
+        return variable && *variable && strcmp(variable, "0") != 0;
+    }();
+    return activa;
+}
+
+// Procesos de MPI_COMM_WORLD que comparten memoria y líderes de cada nodo.
+// Ordenados por rango global: el proceso 0 es el líder del nodo 0
+struct ComunicadoresNodo {
+    MPI_Comm nodo;     // procesos del mismo nodo (MPI_COMM_TYPE_SHARED)
+    MPI_Comm lideres;  // un proceso por nodo; MPI_COMM_NULL en los demás
+    int rango_nodo, procesos_nodo;
+    int numero_nodo, numero_nodos;
+    int max_procesos_nodo;
+};
+
+// Se crean en la primera llamada, que es colectiva sobre MPI_COMM_WORLD
+inline const ComunicadoresNodo& comunicadores_nodo() {
+    static const ComunicadoresNodo comunicadores = [] {
+        ComunicadoresNodo c;
+        int mi_rango;
+        MPI_Comm_rank(MPI_COMM_WORLD, &mi_rango);
+        MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, mi_rango, MPI_INFO_NULL, &c.nodo);
+        MPI_Comm_rank(c.nodo, &c.rango_nodo);
+        MPI_Comm_size(c.nodo, &c.procesos_nodo);
+        MPI_Comm_split(MPI_COMM_WORLD, c.rango_nodo == 0 ? 0 : MPI_UNDEFINED, mi_rango, &c.lideres);
+
+        int nodo_y_total[2] = {0, 0};
+        if (c.lideres != MPI_COMM_NULL) {
+            MPI_Comm_rank(c.lideres, &nodo_y_total[0]);
+            MPI_Comm_size(c.lideres, &nodo_y_total[1]);
+        }
+        MPI_Bcast(nodo_y_total, 2, MPI_INT, 0, c.nodo);
+        c.numero_nodo = nodo_y_total[0];
+        c.numero_nodos = nodo_y_total[1];
+        MPI_Allreduce(&c.procesos_nodo, &c.max_procesos_nodo, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+        return c;
+    }();
+    return comunicadores;
+}
+
+// Bloque de memoria compartida del nodo: lo reserva el líder y los demás
+// procesos lo mapean. Como los demás buffers, lo pasa quien llama para
+// reutilizarlo: solo se vuelve a reservar si se necesita más espacio.
+// Todas las operaciones son colectivas sobre el nodo
+class VentanaNodo {
+public:
+    VentanaNodo() : ventana(MPI_WIN_NULL), base(nullptr), capacidad(0) {}
+    ~VentanaNodo() {
+        int finalizado;
+        MPI_Finalized(&finalizado);
+        if (!finalizado) liberar();
+    }
+    VentanaNodo(const VentanaNodo&) = delete;
+    VentanaNodo& operator=(const VentanaNodo&) = delete;
+
+    // Deja al menos "bytes" disponibles. Si reutiliza la ventana, espera a que
+    // todo el nodo haya terminado de leer el contenido anterior
+    void reservar(MPI_Aint bytes) {
+        const ComunicadoresNodo& c = comunicadores_nodo();
+        if (ventana != MPI_WIN_NULL && bytes <= capacidad) {
+            sincronizar();
+            return;
+        }
+        liberar();
+        void* local;
+        MPI_Win_allocate_shared(c.rango_nodo == 0 ? bytes : 0, 1, MPI_INFO_NULL, c.nodo, &local, &ventana);
+        MPI_Aint tamano;
+        int unidad;
+        MPI_Win_shared_query(ventana, 0, &tamano, &unidad, &base);
+        capacidad = bytes;
+        // Un acceso pasivo abierto durante toda la vida de la ventana: las
+        // lecturas y escrituras son loads y stores comunes, ordenados con sincronizar()
+        MPI_Win_lock_all(MPI_MODE_NOCHECK, ventana);
+    }
+
+    // Lo escrito antes por cualquier proceso del nodo queda visible para todos
+    void sincronizar() {
+        MPI_Win_sync(ventana);
+        MPI_Barrier(comunicadores_nodo().nodo);
+        MPI_Win_sync(ventana);
+    }
+
+    void liberar() {
+        if (ventana == MPI_WIN_NULL) return;
+        MPI_Win_unlock_all(ventana);
+        MPI_Win_free(&ventana);
+        base = nullptr;
+        capacidad = 0;
+    }
+
+    template <typename T>
+    T* datos() const {
+        return static_cast<T*>(base);
+    }
+
+private:
+    MPI_Win ventana;
+    void* base;
+    MPI_Aint capacidad;
+};
+
+// Equivalente a MPI_Bcast desde el proceso 0 de MPI_COMM_WORLD, pero con una
+// copia por nodo: MPI_Bcast entre líderes directo a la ventana del nodo.
+// Devuelve la copia del nodo; "origen" solo se lee en el proceso 0
+template <typename T>
+const T* difundir_en_nodo(VentanaNodo& copia_nodo, const T* origen, int elementos, MPI_Datatype tipo) {
+    const ComunicadoresNodo& c = comunicadores_nodo();
+    copia_nodo.reservar((MPI_Aint)elementos * sizeof(T));
+    T* copia = copia_nodo.datos<T>();
+    if (c.lideres != MPI_COMM_NULL) {
+        if (c.numero_nodo == 0) std::memcpy(copia, origen, (size_t)elementos * sizeof(T));
+        MPI_Bcast(copia, elementos, tipo, 0, c.lideres);
+    }
+    copia_nodo.sincronizar();
+    return copia;
+}
+
+// Equivalente a MPI_Scatter de bloques iguales desde el proceso 0, pero cada
+// nodo recibe en su ventana los bloques de todos sus procesos en un solo
+// mensaje (MPI_Scatterv entre líderes). Devuelve el bloque de este proceso
+// dentro de la copia del nodo; ningún otro proceso lo lee, así que puede
+// modificarse en el lugar hasta la próxima reserva de la ventana
+template <typename T>
+T* repartir_en_nodo(VentanaNodo& copia_nodo, const T* origen, int elementos_por_proceso,
+                   MPI_Datatype tipo) {
+    const ComunicadoresNodo& c = comunicadores_nodo();
+    copia_nodo.reservar((MPI_Aint)c.procesos_nodo * elementos_por_proceso * sizeof(T));
+    T* copia = copia_nodo.datos<T>();
+
+    // El proceso 0 agrupa los bloques por nodo: dentro de un nodo quedan en
+    // orden de rango global, que es el orden de rango_nodo
+    int mi_rango, numero_procesos;
+    MPI_Comm_rank(MPI_COMM_WORLD, &mi_rango);
+    MPI_Comm_size(MPI_COMM_WORLD, &numero_procesos);
+    std::vector<int> nodo_de_proceso(mi_rango == 0 ? numero_procesos : 0);
+    MPI_Gather(&c.numero_nodo, 1, MPI_INT, nodo_de_proceso.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+    if (c.lideres != MPI_COMM_NULL) {
+        std::vector<int> cantidades, desplazamientos;
+        std::vector<T> agrupados;
+        const T* envio = origen;
+        if (mi_rango == 0) {
+            cantidades.assign(c.numero_nodos, 0);
+            desplazamientos.assign(c.numero_nodos, 0);
+            for (int proceso = 0; proceso < numero_procesos; proceso++) {
+                cantidades[nodo_de_proceso[proceso]] += elementos_por_proceso;
+            }
+            for (int nodo = 1; nodo < c.numero_nodos; nodo++) {
+                desplazamientos[nodo] = desplazamientos[nodo - 1] + cantidades[nodo - 1];
+            }
+
+            // Con procesos consecutivos en cada nodo (lo habitual) el arreglo
+            // ya está agrupado; si no, se reordena por nodo
+            bool agrupado = true;
+            for (int proceso = 1; proceso < numero_procesos; proceso++) {
+                if (nodo_de_proceso[proceso] < nodo_de_proceso[proceso - 1]) agrupado = false;
+            }
+            if (!agrupado) {
+                agrupados.resize((size_t)numero_procesos * elementos_por_proceso);
+                std::vector<int> siguiente(desplazamientos);
+                for (int proceso = 0; proceso < numero_procesos; proceso++) {
+                    int& destino = siguiente[nodo_de_proceso[proceso]];
+                    std::memcpy(&agrupados[destino], origen + (size_t)proceso * elementos_por_proceso,
+                                (size_t)elementos_por_proceso * sizeof(T));
+                    destino += elementos_por_proceso;
+                }
+                envio = agrupados.data();
+            }
+        }
+        MPI_Scatterv(envio, cantidades.data(), desplazamientos.data(), tipo, copia,
+                     c.procesos_nodo * elementos_por_proceso, tipo, 0, c.lideres);
+    }
+    copia_nodo.sincronizar();
+    return copia + (size_t)c.rango_nodo * elementos_por_proceso;
+}
+
+// Línea informativa del proceso 0 sobre el modo de datos compartidos
+inline void informar_memoria_nodo() {
+    if (!memoria_nodo_activa()) return;
+    const ComunicadoresNodo& c = comunicadores_nodo();
+    int mi_rango;
+    MPI_Comm_rank(MPI_COMM_WORLD, &mi_rango);
+    if (mi_rango == 0) {
+        std::cout << "Datos compartidos por nodo (MEMORIA_NODO): " << c.numero_nodos << " nodo(s), hasta "
+                  << c.max_procesos_nodo << " procesos por nodo leen una sola copia" << std::endl;
+    }
+}
+
+#endif
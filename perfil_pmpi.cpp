@@ -0,0 +1,1013 @@
+// Biblioteca de perfilado de comunicación sobre la interfaz de perfilado de
+// MPI (PMPI): cada MPI_X de abajo reemplaza al de la biblioteca MPI, mide la
+// llamada y delega en PMPI_X. Se usa sin tocar los programas:
+//
+//   mpic++ -std=c++11 -O2 -fPIC -shared perfil_pmpi.cpp -o bin/libperfil_pmpi.so -ldl
+//
+//   # Precargada
+//   mpirun -np 4 -x LD_PRELOAD=$PWD/bin/libperfil_pmpi.so bin/3_1_histograma
+//
+//   # Enlazada (antes que la biblioteca MPI, que mpic++ agrega al final)
+//   mpic++ -std=c++11 -O2 -rdynamic 3_1_histograma.cpp -o bin/3_1_histograma -Lbin -lperfil_pmpi -Wl,-rpath,$PWD/bin
+//
+// Por cada (operación, sitio de llamada, socio) cuenta llamadas, bytes, tiempo
+// y un histograma de tamaños de mensaje. En MPI_Finalize el proceso 0 junta los
+// registros de todos e imprime el resumen; el detalle completo va a
+// perfil_pmpi.csv (variable de entorno PERFIL_PMPI_CSV; vacía para no escribirlo).
+// MPI_Pcontrol(0) suspende el registro y MPI_Pcontrol(1) lo reanuda: así los
+// reportes de los programas (reportar_fases, ...) no se mezclan con lo medido
+#include <mpi.h>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <mutex>
+#include <atomic>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <dlfcn.h>
+#include <cxxabi.h>
+
+namespace {
+
+// Operaciones interceptadas
+enum Operacion {
+    OP_SEND,
+    OP_SSEND,
+    OP_RECV,
+    OP_SENDRECV,
+    OP_ISEND,
+    OP_IRECV,
+    OP_START,
+    OP_WAIT,
+    OP_WAITALL,
+    OP_TEST,
+    OP_TESTALL,
+    OP_IPROBE,
+    OP_BCAST,
+    OP_SCATTER,
+    OP_SCATTERV,
+    OP_GATHER,
+    OP_GATHERV,
+    OP_ALLGATHER,
+    OP_REDUCE,
+    OP_IREDUCE,
+    OP_ALLREDUCE,
+    OP_EXSCAN,
+    OP_ALLTOALL,
+    OP_ALLTOALLV,
+    OP_ALLTOALLW,
+    OP_NEIGHBOR_ALLTOALLV,
+    OP_PUT,
+    OP_GET,
+    OP_WIN_FENCE,
+    OP_WIN_LOCK,
+    OP_WIN_UNLOCK,
+    OP_WIN_FLUSH,
+    OP_FILE_READ_AT,
+    OP_FILE_READ_AT_ALL,
+    OP_FILE_WRITE_AT_ALL,
+    OP_BARRIER,
+    OP_COMM_SPLIT,
+    NUMERO_OPERACIONES
+};
+
+const char* NOMBRES_OPERACIONES[NUMERO_OPERACIONES] = {
+    "MPI_Send",      "MPI_Ssend",     "MPI_Recv",     "MPI_Sendrecv",  "MPI_Isend",
+    "MPI_Irecv",     "MPI_Start",     "MPI_Wait",     "MPI_Waitall",   "MPI_Test",
+    "MPI_Testall",   "MPI_Iprobe",    "MPI_Bcast",    "MPI_Scatter",   "MPI_Scatterv",
+    "MPI_Gather",    "MPI_Gatherv",   "MPI_Allgather", "MPI_Reduce",   "MPI_Ireduce",
+    "MPI_Allreduce", "MPI_Exscan",    "MPI_Alltoall", "MPI_Alltoallv", "MPI_Alltoallw",
+    "MPI_Neighbor_alltoallv", "MPI_Put", "MPI_Get",   "MPI_Win_fence", "MPI_Win_lock",
+    "MPI_Win_unlock", "MPI_Win_flush", "MPI_File_read_at", "MPI_File_read_at_all", "MPI_File_write_at_all",
+    "MPI_Barrier",   "MPI_Comm_split"};
+
+// Cubetas del histograma de tamaños: la 0 son los mensajes vacíos y la k los
+// de [2^(k-1), 2^k) bytes; la última junta todo lo que es mayor
+const int NUMERO_CUBETAS = 32;
+
+int cubeta_de(long long bytes) {
+    int cubeta = 0;
+    while (bytes > 0 && cubeta < NUMERO_CUBETAS - 1) {
+        bytes >>= 1;
+        cubeta++;
+    }
+    return cubeta;
+}
+
+// Un registro por operación, sitio de llamada (dirección de retorno) y socio
+// (destino, origen o raíz, como rango en MPI_COMM_WORLD; -1 si no hay)
+struct Clave {
+    int operacion;
+    void* sitio;
+    int socio;
+    bool operator<(const Clave& otra) const {
+        if (operacion != otra.operacion) return operacion < otra.operacion;
+        if (sitio != otra.sitio) return sitio < otra.sitio;
+        return socio < otra.socio;
+    }
+};
+
+struct Estadistica {
+    long long llamadas = 0;
+    long long bytes = 0;
+    double tiempo = 0.0;
+    long long cubetas[NUMERO_CUBETAS] = {0};
+};
+
+std::map<Clave, Estadistica> registros;
+std::mutex candado_registros;  // por si otro hilo hace llamadas MPI
+double inicio_mpi = 0.0;
+std::atomic<bool> registro_activo(true);  // MPI_Pcontrol
+
+void registrar(Operacion operacion, void* sitio, int socio, long long bytes, double tiempo) {
+    if (!registro_activo) return;
+    std::lock_guard<std::mutex> guarda(candado_registros);
+    Estadistica& e = registros[Clave{operacion, sitio, socio}];
+    e.llamadas++;
+    e.bytes += bytes;
+    e.tiempo += tiempo;
+    e.cubetas[cubeta_de(bytes)]++;
+}
+
+long long bytes_de(int cantidad, MPI_Datatype tipo) {
+    int tamano = 0;
+    PMPI_Type_size(tipo, &tamano);
+    return (long long)cantidad * tamano;
+}
+
+// Suma de cantidad[i] elementos de tipo[i] (o de "tipo" para todos)
+long long bytes_de(int elementos, const int* cantidades, const MPI_Datatype* tipos, MPI_Datatype tipo) {
+    long long bytes = 0;
+    for (int i = 0; i < elementos; i++) bytes += bytes_de(cantidades[i], tipos ? tipos[i] : tipo);
+    return bytes;
+}
+
+// Rangos en MPI_COMM_WORLD de todos los procesos de "grupo" (-1 si no está)
+std::vector<int> traducir_grupo(MPI_Group grupo) {
+    int tamano;
+    PMPI_Group_size(grupo, &tamano);
+    std::vector<int> locales(tamano), globales(tamano);
+    for (int i = 0; i < tamano; i++) locales[i] = i;
+    MPI_Group grupo_global;
+    PMPI_Comm_group(MPI_COMM_WORLD, &grupo_global);
+    PMPI_Group_translate_ranks(grupo, tamano, locales.data(), grupo_global, globales.data());
+    PMPI_Group_free(&grupo_global);
+    for (int& global : globales) {
+        if (global == MPI_UNDEFINED) global = -1;
+    }
+    return globales;
+}
+
+// Traducciones por comunicador y por ventana: se hacen en el primer mensaje y
+// no en cada uno. Se olvidan en MPI_Comm_free y MPI_Win_free, porque MPI puede
+// reutilizar el handle para un objeto nuevo
+std::map<MPI_Comm, std::vector<int>> rangos_comunicadores;
+std::map<MPI_Win, std::vector<int>> rangos_ventanas;
+
+int buscar_rango(const std::vector<int>& globales, int rango) {
+    return rango < (int)globales.size() ? globales[rango] : -1;
+}
+
+// Rango en MPI_COMM_WORLD de "rango" en "comunicador"
+int rango_global(int rango, MPI_Comm comunicador) {
+    if (rango < 0 || comunicador == MPI_COMM_WORLD) return rango;
+    std::lock_guard<std::mutex> guarda(candado_registros);
+    auto traduccion = rangos_comunicadores.find(comunicador);
+    if (traduccion == rangos_comunicadores.end()) {
+        MPI_Group grupo;
+        PMPI_Comm_group(comunicador, &grupo);
+        traduccion = rangos_comunicadores.insert(std::make_pair(comunicador, traducir_grupo(grupo))).first;
+        PMPI_Group_free(&grupo);
+    }
+    return buscar_rango(traduccion->second, rango);
+}
+
+// Rango en MPI_COMM_WORLD del proceso "rango" de la ventana
+int rango_global(int rango, MPI_Win ventana) {
+    if (rango < 0) return rango;
+    std::lock_guard<std::mutex> guarda(candado_registros);
+    auto traduccion = rangos_ventanas.find(ventana);
+    if (traduccion == rangos_ventanas.end()) {
+        MPI_Group grupo;
+        PMPI_Win_get_group(ventana, &grupo);
+        traduccion = rangos_ventanas.insert(std::make_pair(ventana, traducir_grupo(grupo))).first;
+        PMPI_Group_free(&grupo);
+    }
+    return buscar_rango(traduccion->second, rango);
+}
+
+// Vecinos de un comunicador con topología (para las colectivas de vecindario)
+void contar_vecinos(MPI_Comm comunicador, int& entrantes, int& salientes) {
+    int topologia, mi_rango;
+    entrantes = salientes = 0;
+    PMPI_Topo_test(comunicador, &topologia);
+    if (topologia == MPI_DIST_GRAPH) {
+        int ponderado;
+        PMPI_Dist_graph_neighbors_count(comunicador, &entrantes, &salientes, &ponderado);
+    } else if (topologia == MPI_CART) {
+        PMPI_Cartdim_get(comunicador, &entrantes);
+        entrantes *= 2;
+        salientes = entrantes;
+    } else if (topologia == MPI_GRAPH) {
+        PMPI_Comm_rank(comunicador, &mi_rango);
+        PMPI_Graph_neighbors_count(comunicador, mi_rango, &entrantes);
+        salientes = entrantes;
+    }
+}
+
+// Solicitud no bloqueante viva: el tiempo de MPI_Wait y MPI_Test se atribuye
+// al sitio y al socio de la llamada que la creó, no al de la espera. Las
+// persistentes (MPI_Send_init, MPI_Recv_init) siguen registradas hasta
+// MPI_Request_free y guardan los bytes para contarlos en cada MPI_Start
+struct Pendiente {
+    void* sitio;
+    int socio;
+    long long bytes;
+    bool persistente;
+};
+
+std::map<MPI_Request, Pendiente> pendientes;
+
+void guardar_pendiente(MPI_Request solicitud, void* sitio, int socio, long long bytes, bool persistente) {
+    if (!registro_activo) return;
+    std::lock_guard<std::mutex> guarda(candado_registros);
+    pendientes[solicitud] = Pendiente{sitio, socio, bytes, persistente};
+}
+
+// Solicitudes conocidas entre las "cantidad" dadas (las nulas o creadas con el
+// registro suspendido no aparecen)
+std::vector<Pendiente> buscar_pendientes(int cantidad, const MPI_Request* solicitudes) {
+    std::vector<Pendiente> encontradas;
+    std::lock_guard<std::mutex> guarda(candado_registros);
+    for (int i = 0; i < cantidad; i++) {
+        auto pendiente = pendientes.find(solicitudes[i]);
+        if (pendiente != pendientes.end()) encontradas.push_back(pendiente->second);
+    }
+    return encontradas;
+}
+
+// Olvida las solicitudes completadas que no son persistentes
+void completar_pendientes(int cantidad, const MPI_Request* solicitudes) {
+    std::lock_guard<std::mutex> guarda(candado_registros);
+    for (int i = 0; i < cantidad; i++) {
+        auto pendiente = pendientes.find(solicitudes[i]);
+        if (pendiente != pendientes.end() && !pendiente->second.persistente) pendientes.erase(pendiente);
+    }
+}
+
+// Reparte el tiempo de una espera en partes iguales entre los sitios de las
+// solicitudes que espera, con una llamada por solicitud; sin ninguna conocida
+// queda en el sitio de la propia espera
+void registrar_espera(Operacion operacion, const std::vector<Pendiente>& esperadas, void* sitio, double tiempo) {
+    if (esperadas.empty()) {
+        registrar(operacion, sitio, -1, 0, tiempo);
+        return;
+    }
+    for (const Pendiente& p : esperadas) registrar(operacion, p.sitio, p.socio, 0, tiempo / esperadas.size());
+}
+
+// Nombre legible del sitio de llamada. Con el símbolo disponible (programas
+// compilados con -rdynamic) es "función+0xdesplazamiento"; si no,
+// "binario+0xdesplazamiento", que se traduce con addr2line -e bin/binario. Se
+// usa la dirección de la instrucción de llamada (retorno - 1), que además es
+// la misma en todos los procesos aunque el binario cargue en otra dirección
+std::string nombre_sitio(void* sitio) {
+    char* llamada = (char*)sitio - 1;
+    Dl_info info;
+    if (!dladdr(llamada, &info)) return "?";
+
+    char texto[64];
+    if (info.dli_sname) {
+        int estado = 0;
+        char* legible = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &estado);
+        std::string nombre = estado == 0 && legible ? legible : info.dli_sname;
+        free(legible);
+        nombre = nombre.substr(0, nombre.find('('));  // sin la lista de parámetros
+        snprintf(texto, sizeof(texto), "+0x%lx", (unsigned long)(llamada - (char*)info.dli_saddr));
+        return nombre + texto;
+    }
+
+    std::string binario = info.dli_fname ? info.dli_fname : "?";
+    binario = binario.substr(binario.find_last_of('/') + 1);
+    snprintf(texto, sizeof(texto), "+0x%lx", (unsigned long)(llamada - (char*)info.dli_fbase));
+    return binario + texto;
+}
+
+// Registro ya resuelto, tal como viaja al proceso 0
+struct Fila {
+    int rango;
+    std::string operacion, sitio;
+    int socio;
+    Estadistica e;
+};
+
+std::string serializar(int mi_rango) {
+    std::ostringstream texto;
+    texto << std::setprecision(17);
+    for (const auto& par : registros) {
+        const Estadistica& e = par.second;
+        texto << mi_rango << '\t' << NOMBRES_OPERACIONES[par.first.operacion] << '\t'
+              << nombre_sitio(par.first.sitio) << '\t' << par.first.socio << '\t' << e.llamadas << '\t'
+              << e.bytes << '\t' << e.tiempo;
+        for (int c = 0; c < NUMERO_CUBETAS; c++) texto << '\t' << e.cubetas[c];
+        texto << '\n';
+    }
+    return texto.str();
+}
+
+std::vector<Fila> deserializar(const std::string& texto) {
+    std::vector<Fila> filas;
+    std::istringstream lineas(texto);
+    std::string linea;
+    while (std::getline(lineas, linea)) {
+        std::istringstream campos(linea);
+        Fila f;
+        std::getline(campos, f.operacion, '\t');  // rango
+        f.rango = atoi(f.operacion.c_str());
+        std::getline(campos, f.operacion, '\t');
+        std::getline(campos, f.sitio, '\t');
+        campos >> f.socio >> f.e.llamadas >> f.e.bytes >> f.e.tiempo;
+        for (int c = 0; c < NUMERO_CUBETAS; c++) campos >> f.e.cubetas[c];
+        filas.push_back(f);
+    }
+    return filas;
+}
+
+void acumular(Estadistica& total, const Estadistica& e) {
+    total.llamadas += e.llamadas;
+    total.bytes += e.bytes;
+    total.tiempo += e.tiempo;
+    for (int c = 0; c < NUMERO_CUBETAS; c++) total.cubetas[c] += e.cubetas[c];
+}
+
+std::string texto_bytes(double bytes) {
+    const char* unidades[] = {"B", "KB", "MB", "GB", "TB"};
+    int u = 0;
+    while (bytes >= 1024.0 && u < 4) {
+        bytes /= 1024.0;
+        u++;
+    }
+    std::ostringstream texto;
+    texto << std::fixed << std::setprecision(u == 0 ? 0 : 1) << bytes << " " << unidades[u];
+    return texto.str();
+}
+
+// Límite inferior de la cubeta, como texto
+std::string texto_cubeta(int cubeta) {
+    return cubeta == 0 ? "0 B" : texto_bytes((double)(1LL << (cubeta - 1)));
+}
+
+// Rellena con espacios a "ancho" caracteres visibles (UTF-8)
+std::string rellenar(const std::string& texto, int ancho) {
+    int visibles = 0;
+    for (unsigned char c : texto) {
+        if ((c & 0xC0) != 0x80) visibles++;
+    }
+    return texto + std::string(std::max(0, ancho - visibles), ' ');
+}
+
+// Resumen en el proceso 0: por operación, por sitio de llamada, los pares
+// (sitio, socio) más costosos y el histograma de tamaños por operación
+void reportar(const std::vector<Fila>& filas, int numero_procesos, double tiempo_total) {
+    const int MAXIMO_FILAS = 15;
+    std::ios formato(nullptr);
+    formato.copyfmt(std::cout);
+
+    double tiempo_mpi = 0.0;
+    std::map<std::string, Estadistica> por_operacion;
+    std::map<std::pair<std::string, std::string>, Estadistica> por_sitio;
+    std::map<std::pair<std::string, std::string>, double> maximo_por_sitio;  // peor proceso
+    std::map<std::pair<std::pair<std::string, std::string>, int>, double> tiempo_sitio_rango;
+    for (const Fila& f : filas) {
+        tiempo_mpi += f.e.tiempo;
+        acumular(por_operacion[f.operacion], f.e);
+        acumular(por_sitio[std::make_pair(f.operacion, f.sitio)], f.e);
+        tiempo_sitio_rango[std::make_pair(std::make_pair(f.operacion, f.sitio), f.rango)] += f.e.tiempo;
+    }
+    for (const auto& par : tiempo_sitio_rango) {
+        double& maximo = maximo_por_sitio[par.first.first];
+        maximo = std::max(maximo, par.second);
+    }
+
+    std::cout << "\n=== PERFIL PMPI (" << numero_procesos << " procesos) ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(6);
+    std::cout << "Tiempo en MPI (suma de procesos): " << tiempo_mpi << " s de " << tiempo_total * numero_procesos
+              << " s entre MPI_Init y MPI_Finalize (" << std::setprecision(1)
+              << (tiempo_total > 0 ? 100.0 * tiempo_mpi / (tiempo_total * numero_procesos) : 0.0) << "%)"
+              << std::endl;
+
+    std::cout << "\nPor operación:" << std::endl;
+    std::cout << "  " << rellenar("Operación", 24) << std::setw(12) << "Llamadas" << std::setw(14) << "Bytes"
+              << std::setw(13) << "Tiempo (s)" << std::setw(9) << "% MPI" << std::endl;
+    for (const auto& par : por_operacion) {
+        const Estadistica& e = par.second;
+        std::cout << "  " << rellenar(par.first, 24) << std::setw(12) << e.llamadas << std::setw(14)
+                  << texto_bytes(e.bytes) << std::setprecision(6) << std::setw(13) << e.tiempo << std::setprecision(1)
+                  << std::setw(8) << (tiempo_mpi > 0 ? 100.0 * e.tiempo / tiempo_mpi : 0.0) << "%" << std::endl;
+    }
+
+    // Sitios de llamada ordenados por tiempo
+    std::vector<std::pair<std::pair<std::string, std::string>, Estadistica>> sitios(por_sitio.begin(),
+                                                                                    por_sitio.end());
+    std::sort(sitios.begin(), sitios.end(), [](const decltype(sitios)::value_type& a,
+                                               const decltype(sitios)::value_type& b) {
+        return a.second.tiempo > b.second.tiempo;
+    });
+    std::cout << "\nPor sitio de llamada (suma de procesos; máx. = el proceso que más esperó; en las esperas, "
+              << "el sitio que creó la solicitud):" << std::endl;
+    std::cout << "  " << rellenar("Operación", 24) << rellenar("Sitio", 40) << std::setw(10) << "Llamadas"
+              << std::setw(13) << "Bytes" << std::setw(13) << "Tiempo (s)" << std::setw(13) << "Máx. (s)"
+              << std::endl;
+    for (int i = 0; i < (int)sitios.size() && i < MAXIMO_FILAS; i++) {
+        const Estadistica& e = sitios[i].second;
+        std::cout << "  " << rellenar(sitios[i].first.first, 24) << rellenar(sitios[i].first.second, 40)
+                  << std::setw(10) << e.llamadas << std::setw(13) << texto_bytes(e.bytes) << std::setprecision(6)
+                  << std::setw(13) << e.tiempo << std::setw(13) << maximo_por_sitio[sitios[i].first] << std::endl;
+    }
+    if ((int)sitios.size() > MAXIMO_FILAS) {
+        std::cout << "  ... " << sitios.size() - MAXIMO_FILAS << " sitios más en el CSV" << std::endl;
+    }
+
+    // Registros individuales (proceso, sitio, socio) ordenados por tiempo
+    std::vector<const Fila*> ordenadas;
+    for (const Fila& f : filas) ordenadas.push_back(&f);
+    std::sort(ordenadas.begin(), ordenadas.end(), [](const Fila* a, const Fila* b) {
+        return a->e.tiempo > b->e.tiempo;
+    });
+    std::cout << "\nPares proceso → socio más costosos:" << std::endl;
+    std::cout << "  " << std::setw(7) << "Proceso" << std::setw(7) << "Socio" << "  " << rellenar("Operación", 24)
+              << rellenar("Sitio", 40) << std::setw(10) << "Llamadas" << std::setw(13) << "Bytes" << std::setw(13)
+              << "Tiempo (s)" << std::endl;
+    for (int i = 0; i < (int)ordenadas.size() && i < MAXIMO_FILAS; i++) {
+        const Fila& f = *ordenadas[i];
+        std::cout << "  " << std::setw(7) << f.rango << std::setw(7);
+        if (f.socio >= 0) std::cout << f.socio;
+        else std::cout << "-";
+        std::cout << "  " << rellenar(f.operacion, 24) << rellenar(f.sitio, 40) << std::setw(10) << f.e.llamadas
+                  << std::setw(13) << texto_bytes(f.e.bytes) << std::setprecision(6) << std::setw(13) << f.e.tiempo
+                  << std::endl;
+    }
+
+    std::cout << "\nHistograma de tamaños de mensaje (llamadas por rango de bytes):" << std::endl;
+    for (const auto& par : por_operacion) {
+        if (par.second.bytes == 0) continue;  // esperas, sondeos, barreras
+        std::cout << "  " << par.first << ":";
+        for (int c = 0; c < NUMERO_CUBETAS; c++) {
+            if (par.second.cubetas[c] == 0) continue;
+            std::cout << "  [" << texto_cubeta(c);
+            if (c > 0 && c < NUMERO_CUBETAS - 1) std::cout << ", " << texto_cubeta(c + 1);
+            std::cout << (c == 0 ? "]" : ")") << " " << par.second.cubetas[c];
+        }
+        std::cout << std::endl;
+    }
+
+    std::cout.copyfmt(formato);
+}
+
+void escribir_csv(const std::string& ruta, const std::vector<Fila>& filas) {
+    std::ofstream archivo(ruta);
+    archivo << "proceso,operacion,sitio,socio,llamadas,bytes,tiempo_s";
+    for (int c = 0; c < NUMERO_CUBETAS; c++) archivo << ",cubeta_" << c;
+    archivo << std::endl;
+    for (const Fila& f : filas) {
+        archivo << f.rango << "," << f.operacion << "," << f.sitio << "," << f.socio << "," << f.e.llamadas << ","
+                << f.e.bytes << "," << std::scientific << std::setprecision(6) << f.e.tiempo;
+        archivo.unsetf(std::ios::floatfield);
+        for (int c = 0; c < NUMERO_CUBETAS; c++) archivo << "," << f.e.cubetas[c];
+        archivo << std::endl;
+    }
+    std::cout << "Detalle en " << ruta << std::endl;
+}
+
+}  // namespace
+
+extern "C" {
+
+int MPI_Init(int* argc, char*** argv) {
+    int resultado = PMPI_Init(argc, argv);
+    inicio_mpi = PMPI_Wtime();
+    return resultado;
+}
+
+int MPI_Init_thread(int* argc, char*** argv, int requerido, int* provisto) {
+    int resultado = PMPI_Init_thread(argc, argv, requerido, provisto);
+    inicio_mpi = PMPI_Wtime();
+    return resultado;
+}
+
+int MPI_Send(const void* buffer, int cantidad, MPI_Datatype tipo, int destino, int etiqueta, MPI_Comm comunicador) {
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Send(buffer, cantidad, tipo, destino, etiqueta, comunicador);
+    registrar(OP_SEND, __builtin_return_address(0), rango_global(destino, comunicador), bytes_de(cantidad, tipo),
+              PMPI_Wtime() - inicio);
+    return resultado;
+}
+
+int MPI_Ssend(const void* buffer, int cantidad, MPI_Datatype tipo, int destino, int etiqueta, MPI_Comm comunicador) {
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Ssend(buffer, cantidad, tipo, destino, etiqueta, comunicador);
+    registrar(OP_SSEND, __builtin_return_address(0), rango_global(destino, comunicador), bytes_de(cantidad, tipo),
+              PMPI_Wtime() - inicio);
+    return resultado;
+}
+
+int MPI_Recv(void* buffer, int cantidad, MPI_Datatype tipo, int origen, int etiqueta, MPI_Comm comunicador,
+             MPI_Status* estado) {
+    // El origen y el tamaño reales salen del estado, aunque quien llama lo ignore
+    MPI_Status estado_propio;
+    if (estado == MPI_STATUS_IGNORE) estado = &estado_propio;
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Recv(buffer, cantidad, tipo, origen, etiqueta, comunicador, estado);
+    double tiempo = PMPI_Wtime() - inicio;
+    int recibidos = 0;
+    PMPI_Get_count(estado, tipo, &recibidos);
+    if (recibidos == MPI_UNDEFINED) recibidos = 0;
+    registrar(OP_RECV, __builtin_return_address(0), rango_global(estado->MPI_SOURCE, comunicador),
+              bytes_de(recibidos, tipo), tiempo);
+    return resultado;
+}
+
+int MPI_Sendrecv(const void* buffer_envio, int cantidad_envio, MPI_Datatype tipo_envio, int destino,
+                 int etiqueta_envio, void* buffer_recepcion, int cantidad_recepcion, MPI_Datatype tipo_recepcion,
+                 int origen, int etiqueta_recepcion, MPI_Comm comunicador, MPI_Status* estado) {
+    // El socio es el destino; los bytes son los enviados más los recibidos
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Sendrecv(buffer_envio, cantidad_envio, tipo_envio, destino, etiqueta_envio,
+                                  buffer_recepcion, cantidad_recepcion, tipo_recepcion, origen, etiqueta_recepcion,
+                                  comunicador, estado);
+    registrar(OP_SENDRECV, __builtin_return_address(0), rango_global(destino, comunicador),
+              bytes_de(cantidad_envio, tipo_envio) + bytes_de(cantidad_recepcion, tipo_recepcion),
+              PMPI_Wtime() - inicio);
+    return resultado;
+}
+
+// No bloqueantes: la llamada cuenta los bytes y el tiempo de iniciarla; lo que
+// se espera después en MPI_Wait/MPI_Test se anota al mismo sitio y socio. En
+// MPI_Irecv los bytes son la capacidad del buffer y el socio el origen pedido
+int MPI_Isend(const void* buffer, int cantidad, MPI_Datatype tipo, int destino, int etiqueta, MPI_Comm comunicador,
+              MPI_Request* solicitud) {
+    void* sitio = __builtin_return_address(0);
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Isend(buffer, cantidad, tipo, destino, etiqueta, comunicador, solicitud);
+    double tiempo = PMPI_Wtime() - inicio;
+    int socio = rango_global(destino, comunicador);
+    registrar(OP_ISEND, sitio, socio, bytes_de(cantidad, tipo), tiempo);
+    guardar_pendiente(*solicitud, sitio, socio, bytes_de(cantidad, tipo), false);
+    return resultado;
+}
+
+int MPI_Irecv(void* buffer, int cantidad, MPI_Datatype tipo, int origen, int etiqueta, MPI_Comm comunicador,
+              MPI_Request* solicitud) {
+    void* sitio = __builtin_return_address(0);
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Irecv(buffer, cantidad, tipo, origen, etiqueta, comunicador, solicitud);
+    double tiempo = PMPI_Wtime() - inicio;
+    int socio = rango_global(origen, comunicador);
+    registrar(OP_IRECV, sitio, socio, bytes_de(cantidad, tipo), tiempo);
+    guardar_pendiente(*solicitud, sitio, socio, bytes_de(cantidad, tipo), false);
+    return resultado;
+}
+
+int MPI_Send_init(const void* buffer, int cantidad, MPI_Datatype tipo, int destino, int etiqueta,
+                  MPI_Comm comunicador, MPI_Request* solicitud) {
+    int resultado = PMPI_Send_init(buffer, cantidad, tipo, destino, etiqueta, comunicador, solicitud);
+    guardar_pendiente(*solicitud, __builtin_return_address(0), rango_global(destino, comunicador),
+                      bytes_de(cantidad, tipo), true);
+    return resultado;
+}
+
+int MPI_Recv_init(void* buffer, int cantidad, MPI_Datatype tipo, int origen, int etiqueta, MPI_Comm comunicador,
+                  MPI_Request* solicitud) {
+    int resultado = PMPI_Recv_init(buffer, cantidad, tipo, origen, etiqueta, comunicador, solicitud);
+    guardar_pendiente(*solicitud, __builtin_return_address(0), rango_global(origen, comunicador),
+                      bytes_de(cantidad, tipo), true);
+    return resultado;
+}
+
+// Cada arranque de una solicitud persistente cuenta como una llamada con los
+// bytes de la solicitud, en el sitio que la creó
+int MPI_Start(MPI_Request* solicitud) {
+    std::vector<Pendiente> iniciadas = buscar_pendientes(1, solicitud);
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Start(solicitud);
+    double tiempo = PMPI_Wtime() - inicio;
+    if (iniciadas.empty()) registrar(OP_START, __builtin_return_address(0), -1, 0, tiempo);
+    for (const Pendiente& p : iniciadas) registrar(OP_START, p.sitio, p.socio, p.bytes, tiempo);
+    return resultado;
+}
+
+int MPI_Startall(int cantidad, MPI_Request solicitudes[]) {
+    std::vector<Pendiente> iniciadas = buscar_pendientes(cantidad, solicitudes);
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Startall(cantidad, solicitudes);
+    double tiempo = PMPI_Wtime() - inicio;
+    if (iniciadas.empty()) registrar(OP_START, __builtin_return_address(0), -1, 0, tiempo);
+    for (const Pendiente& p : iniciadas) registrar(OP_START, p.sitio, p.socio, p.bytes, tiempo / iniciadas.size());
+    return resultado;
+}
+
+int MPI_Request_free(MPI_Request* solicitud) {
+    {
+        std::lock_guard<std::mutex> guarda(candado_registros);
+        pendientes.erase(*solicitud);
+    }
+    return PMPI_Request_free(solicitud);
+}
+
+// Las esperas buscan las solicitudes antes de llamar, porque al completarse
+// MPI las reemplaza por MPI_REQUEST_NULL
+int MPI_Wait(MPI_Request* solicitud, MPI_Status* estado) {
+    MPI_Request original = *solicitud;
+    std::vector<Pendiente> esperadas = buscar_pendientes(1, &original);
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Wait(solicitud, estado);
+    registrar_espera(OP_WAIT, esperadas, __builtin_return_address(0), PMPI_Wtime() - inicio);
+    completar_pendientes(1, &original);
+    return resultado;
+}
+
+int MPI_Waitall(int cantidad, MPI_Request solicitudes[], MPI_Status estados[]) {
+    std::vector<MPI_Request> originales(solicitudes, solicitudes + cantidad);
+    std::vector<Pendiente> esperadas = buscar_pendientes(cantidad, originales.data());
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Waitall(cantidad, solicitudes, estados);
+    registrar_espera(OP_WAITALL, esperadas, __builtin_return_address(0), PMPI_Wtime() - inicio);
+    completar_pendientes(cantidad, originales.data());
+    return resultado;
+}
+
+int MPI_Test(MPI_Request* solicitud, int* terminada, MPI_Status* estado) {
+    MPI_Request original = *solicitud;
+    std::vector<Pendiente> esperadas = buscar_pendientes(1, &original);
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Test(solicitud, terminada, estado);
+    registrar_espera(OP_TEST, esperadas, __builtin_return_address(0), PMPI_Wtime() - inicio);
+    if (*terminada) completar_pendientes(1, &original);
+    return resultado;
+}
+
+int MPI_Testall(int cantidad, MPI_Request solicitudes[], int* terminadas, MPI_Status estados[]) {
+    std::vector<MPI_Request> originales(solicitudes, solicitudes + cantidad);
+    std::vector<Pendiente> esperadas = buscar_pendientes(cantidad, originales.data());
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Testall(cantidad, solicitudes, terminadas, estados);
+    registrar_espera(OP_TESTALL, esperadas, __builtin_return_address(0), PMPI_Wtime() - inicio);
+    if (*terminadas) completar_pendientes(cantidad, originales.data());
+    return resultado;
+}
+
+// El socio es el origen del mensaje encontrado, o el pedido si no hay ninguno
+int MPI_Iprobe(int origen, int etiqueta, MPI_Comm comunicador, int* hay_mensaje, MPI_Status* estado) {
+    MPI_Status estado_propio;
+    if (estado == MPI_STATUS_IGNORE) estado = &estado_propio;
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Iprobe(origen, etiqueta, comunicador, hay_mensaje, estado);
+    double tiempo = PMPI_Wtime() - inicio;
+    registrar(OP_IPROBE, __builtin_return_address(0),
+              rango_global(*hay_mensaje ? estado->MPI_SOURCE : origen, comunicador), 0, tiempo);
+    return resultado;
+}
+
+int MPI_Bcast(void* buffer, int cantidad, MPI_Datatype tipo, int raiz, MPI_Comm comunicador) {
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Bcast(buffer, cantidad, tipo, raiz, comunicador);
+    registrar(OP_BCAST, __builtin_return_address(0), rango_global(raiz, comunicador), bytes_de(cantidad, tipo),
+              PMPI_Wtime() - inicio);
+    return resultado;
+}
+
+// En Scatter y Gather la raíz cuenta todo el buffer repartido o recolectado y
+// los demás procesos solo su parte
+int MPI_Scatter(const void* buffer_envio, int cantidad_envio, MPI_Datatype tipo_envio, void* buffer_recepcion,
+                int cantidad_recepcion, MPI_Datatype tipo_recepcion, int raiz, MPI_Comm comunicador) {
+    int mi_rango, numero_procesos;
+    PMPI_Comm_rank(comunicador, &mi_rango);
+    PMPI_Comm_size(comunicador, &numero_procesos);
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Scatter(buffer_envio, cantidad_envio, tipo_envio, buffer_recepcion, cantidad_recepcion,
+                                 tipo_recepcion, raiz, comunicador);
+    long long bytes = mi_rango == raiz ? bytes_de(cantidad_envio, tipo_envio) * numero_procesos
+                                       : bytes_de(cantidad_recepcion, tipo_recepcion);
+    registrar(OP_SCATTER, __builtin_return_address(0), rango_global(raiz, comunicador), bytes,
+              PMPI_Wtime() - inicio);
+    return resultado;
+}
+
+int MPI_Gather(const void* buffer_envio, int cantidad_envio, MPI_Datatype tipo_envio, void* buffer_recepcion,
+               int cantidad_recepcion, MPI_Datatype tipo_recepcion, int raiz, MPI_Comm comunicador) {
+    int mi_rango, numero_procesos;
+    PMPI_Comm_rank(comunicador, &mi_rango);
+    PMPI_Comm_size(comunicador, &numero_procesos);
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Gather(buffer_envio, cantidad_envio, tipo_envio, buffer_recepcion, cantidad_recepcion,
+                                tipo_recepcion, raiz, comunicador);
+    long long bytes = mi_rango == raiz ? bytes_de(cantidad_recepcion, tipo_recepcion) * numero_procesos
+                                       : bytes_de(cantidad_envio, tipo_envio);
+    registrar(OP_GATHER, __builtin_return_address(0), rango_global(raiz, comunicador), bytes,
+              PMPI_Wtime() - inicio);
+    return resultado;
+}
+
+int MPI_Scatterv(const void* buffer_envio, const int cantidades_envio[], const int desplazamientos[],
+                 MPI_Datatype tipo_envio, void* buffer_recepcion, int cantidad_recepcion,
+                 MPI_Datatype tipo_recepcion, int raiz, MPI_Comm comunicador) {
+    int mi_rango, numero_procesos;
+    PMPI_Comm_rank(comunicador, &mi_rango);
+    PMPI_Comm_size(comunicador, &numero_procesos);
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Scatterv(buffer_envio, cantidades_envio, desplazamientos, tipo_envio, buffer_recepcion,
+                                  cantidad_recepcion, tipo_recepcion, raiz, comunicador);
+    long long bytes = mi_rango == raiz ? bytes_de(numero_procesos, cantidades_envio, nullptr, tipo_envio)
+                                       : bytes_de(cantidad_recepcion, tipo_recepcion);
+    registrar(OP_SCATTERV, __builtin_return_address(0), rango_global(raiz, comunicador), bytes,
+              PMPI_Wtime() - inicio);
+    return resultado;
+}
+
+int MPI_Gatherv(const void* buffer_envio, int cantidad_envio, MPI_Datatype tipo_envio, void* buffer_recepcion,
+                const int cantidades_recepcion[], const int desplazamientos[], MPI_Datatype tipo_recepcion, int raiz,
+                MPI_Comm comunicador) {
+    int mi_rango, numero_procesos;
+    PMPI_Comm_rank(comunicador, &mi_rango);
+    PMPI_Comm_size(comunicador, &numero_procesos);
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Gatherv(buffer_envio, cantidad_envio, tipo_envio, buffer_recepcion, cantidades_recepcion,
+                                 desplazamientos, tipo_recepcion, raiz, comunicador);
+    long long bytes = mi_rango == raiz ? bytes_de(numero_procesos, cantidades_recepcion, nullptr, tipo_recepcion)
+                                       : bytes_de(cantidad_envio, tipo_envio);
+    registrar(OP_GATHERV, __builtin_return_address(0), rango_global(raiz, comunicador), bytes,
+              PMPI_Wtime() - inicio);
+    return resultado;
+}
+
+int MPI_Reduce(const void* buffer_envio, void* buffer_recepcion, int cantidad, MPI_Datatype tipo, MPI_Op operacion,
+               int raiz, MPI_Comm comunicador) {
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Reduce(buffer_envio, buffer_recepcion, cantidad, tipo, operacion, raiz, comunicador);
+    registrar(OP_REDUCE, __builtin_return_address(0), rango_global(raiz, comunicador), bytes_de(cantidad, tipo),
+              PMPI_Wtime() - inicio);
+    return resultado;
+}
+
+int MPI_Ireduce(const void* buffer_envio, void* buffer_recepcion, int cantidad, MPI_Datatype tipo, MPI_Op operacion,
+                int raiz, MPI_Comm comunicador, MPI_Request* solicitud) {
+    void* sitio = __builtin_return_address(0);
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Ireduce(buffer_envio, buffer_recepcion, cantidad, tipo, operacion, raiz, comunicador,
+                                 solicitud);
+    double tiempo = PMPI_Wtime() - inicio;
+    int socio = rango_global(raiz, comunicador);
+    registrar(OP_IREDUCE, sitio, socio, bytes_de(cantidad, tipo), tiempo);
+    guardar_pendiente(*solicitud, sitio, socio, bytes_de(cantidad, tipo), false);
+    return resultado;
+}
+
+int MPI_Allreduce(const void* buffer_envio, void* buffer_recepcion, int cantidad, MPI_Datatype tipo,
+                  MPI_Op operacion, MPI_Comm comunicador) {
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Allreduce(buffer_envio, buffer_recepcion, cantidad, tipo, operacion, comunicador);
+    registrar(OP_ALLREDUCE, __builtin_return_address(0), -1, bytes_de(cantidad, tipo), PMPI_Wtime() - inicio);
+    return resultado;
+}
+
+int MPI_Exscan(const void* buffer_envio, void* buffer_recepcion, int cantidad, MPI_Datatype tipo, MPI_Op operacion,
+               MPI_Comm comunicador) {
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Exscan(buffer_envio, buffer_recepcion, cantidad, tipo, operacion, comunicador);
+    registrar(OP_EXSCAN, __builtin_return_address(0), -1, bytes_de(cantidad, tipo), PMPI_Wtime() - inicio);
+    return resultado;
+}
+
+// En las colectivas de todos con todos se suma lo enviado y lo recibido por
+// el proceso, como en MPI_Sendrecv
+int MPI_Allgather(const void* buffer_envio, int cantidad_envio, MPI_Datatype tipo_envio, void* buffer_recepcion,
+                  int cantidad_recepcion, MPI_Datatype tipo_recepcion, MPI_Comm comunicador) {
+    int numero_procesos;
+    PMPI_Comm_size(comunicador, &numero_procesos);
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Allgather(buffer_envio, cantidad_envio, tipo_envio, buffer_recepcion, cantidad_recepcion,
+                                   tipo_recepcion, comunicador);
+    long long bytes = bytes_de(cantidad_recepcion, tipo_recepcion) * numero_procesos;
+    if (buffer_envio != MPI_IN_PLACE) bytes += bytes_de(cantidad_envio, tipo_envio);
+    registrar(OP_ALLGATHER, __builtin_return_address(0), -1, bytes, PMPI_Wtime() - inicio);
+    return resultado;
+}
+
+int MPI_Alltoall(const void* buffer_envio, int cantidad_envio, MPI_Datatype tipo_envio, void* buffer_recepcion,
+                 int cantidad_recepcion, MPI_Datatype tipo_recepcion, MPI_Comm comunicador) {
+    int numero_procesos;
+    PMPI_Comm_size(comunicador, &numero_procesos);
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Alltoall(buffer_envio, cantidad_envio, tipo_envio, buffer_recepcion, cantidad_recepcion,
+                                  tipo_recepcion, comunicador);
+    long long bytes = (bytes_de(cantidad_envio, tipo_envio) + bytes_de(cantidad_recepcion, tipo_recepcion)) *
+                      numero_procesos;
+    registrar(OP_ALLTOALL, __builtin_return_address(0), -1, bytes, PMPI_Wtime() - inicio);
+    return resultado;
+}
+
+int MPI_Alltoallv(const void* buffer_envio, const int cantidades_envio[], const int desplazamientos_envio[],
+                  MPI_Datatype tipo_envio, void* buffer_recepcion, const int cantidades_recepcion[],
+                  const int desplazamientos_recepcion[], MPI_Datatype tipo_recepcion, MPI_Comm comunicador) {
+    int numero_procesos;
+    PMPI_Comm_size(comunicador, &numero_procesos);
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Alltoallv(buffer_envio, cantidades_envio, desplazamientos_envio, tipo_envio,
+                                   buffer_recepcion, cantidades_recepcion, desplazamientos_recepcion,
+                                   tipo_recepcion, comunicador);
+    long long bytes = bytes_de(numero_procesos, cantidades_envio, nullptr, tipo_envio) +
+                      bytes_de(numero_procesos, cantidades_recepcion, nullptr, tipo_recepcion);
+    registrar(OP_ALLTOALLV, __builtin_return_address(0), -1, bytes, PMPI_Wtime() - inicio);
+    return resultado;
+}
+
+int MPI_Alltoallw(const void* buffer_envio, const int cantidades_envio[], const int desplazamientos_envio[],
+                  const MPI_Datatype tipos_envio[], void* buffer_recepcion, const int cantidades_recepcion[],
+                  const int desplazamientos_recepcion[], const MPI_Datatype tipos_recepcion[],
+                  MPI_Comm comunicador) {
+    int numero_procesos;
+    PMPI_Comm_size(comunicador, &numero_procesos);
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Alltoallw(buffer_envio, cantidades_envio, desplazamientos_envio, tipos_envio,
+                                   buffer_recepcion, cantidades_recepcion, desplazamientos_recepcion,
+                                   tipos_recepcion, comunicador);
+    long long bytes = bytes_de(numero_procesos, cantidades_envio, tipos_envio, MPI_DATATYPE_NULL) +
+                      bytes_de(numero_procesos, cantidades_recepcion, tipos_recepcion, MPI_DATATYPE_NULL);
+    registrar(OP_ALLTOALLW, __builtin_return_address(0), -1, bytes, PMPI_Wtime() - inicio);
+    return resultado;
+}
+
+int MPI_Neighbor_alltoallv(const void* buffer_envio, const int cantidades_envio[], const int desplazamientos_envio[],
+                           MPI_Datatype tipo_envio, void* buffer_recepcion, const int cantidades_recepcion[],
+                           const int desplazamientos_recepcion[], MPI_Datatype tipo_recepcion,
+                           MPI_Comm comunicador) {
+    int entrantes, salientes;
+    contar_vecinos(comunicador, entrantes, salientes);
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Neighbor_alltoallv(buffer_envio, cantidades_envio, desplazamientos_envio, tipo_envio,
+                                            buffer_recepcion, cantidades_recepcion, desplazamientos_recepcion,
+                                            tipo_recepcion, comunicador);
+    long long bytes = bytes_de(salientes, cantidades_envio, nullptr, tipo_envio) +
+                      bytes_de(entrantes, cantidades_recepcion, nullptr, tipo_recepcion);
+    registrar(OP_NEIGHBOR_ALLTOALLV, __builtin_return_address(0), -1, bytes, PMPI_Wtime() - inicio);
+    return resultado;
+}
+
+// Un solo lado: MPI_Put y MPI_Get solo inician la transferencia; el tiempo de
+// completarla aparece en la sincronización (MPI_Win_fence, o MPI_Win_flush y
+// MPI_Win_unlock con acceso pasivo)
+int MPI_Put(const void* buffer, int cantidad, MPI_Datatype tipo, int destino, MPI_Aint desplazamiento,
+            int cantidad_destino, MPI_Datatype tipo_destino, MPI_Win ventana) {
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Put(buffer, cantidad, tipo, destino, desplazamiento, cantidad_destino, tipo_destino,
+                             ventana);
+    registrar(OP_PUT, __builtin_return_address(0), rango_global(destino, ventana), bytes_de(cantidad, tipo),
+              PMPI_Wtime() - inicio);
+    return resultado;
+}
+
+int MPI_Get(void* buffer, int cantidad, MPI_Datatype tipo, int origen, MPI_Aint desplazamiento,
+            int cantidad_origen, MPI_Datatype tipo_origen, MPI_Win ventana) {
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Get(buffer, cantidad, tipo, origen, desplazamiento, cantidad_origen, tipo_origen,
+                             ventana);
+    registrar(OP_GET, __builtin_return_address(0), rango_global(origen, ventana), bytes_de(cantidad, tipo),
+              PMPI_Wtime() - inicio);
+    return resultado;
+}
+
+int MPI_Win_fence(int afirmacion, MPI_Win ventana) {
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Win_fence(afirmacion, ventana);
+    registrar(OP_WIN_FENCE, __builtin_return_address(0), -1, 0, PMPI_Wtime() - inicio);
+    return resultado;
+}
+
+// Acceso pasivo: el socio es el proceso dueño de la ventana bloqueada
+int MPI_Win_lock(int tipo_bloqueo, int rango, int afirmacion, MPI_Win ventana) {
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Win_lock(tipo_bloqueo, rango, afirmacion, ventana);
+    registrar(OP_WIN_LOCK, __builtin_return_address(0), rango_global(rango, ventana), 0, PMPI_Wtime() - inicio);
+    return resultado;
+}
+
+int MPI_Win_unlock(int rango, MPI_Win ventana) {
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Win_unlock(rango, ventana);
+    registrar(OP_WIN_UNLOCK, __builtin_return_address(0), rango_global(rango, ventana), 0, PMPI_Wtime() - inicio);
+    return resultado;
+}
+
+int MPI_Win_flush(int rango, MPI_Win ventana) {
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Win_flush(rango, ventana);
+    registrar(OP_WIN_FLUSH, __builtin_return_address(0), rango_global(rango, ventana), 0, PMPI_Wtime() - inicio);
+    return resultado;
+}
+
+// MPI-IO con desplazamiento explícito: los bytes son los pedidos y no hay socio
+int MPI_File_read_at(MPI_File archivo, MPI_Offset desplazamiento, void* buffer, int cantidad, MPI_Datatype tipo,
+                     MPI_Status* estado) {
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_File_read_at(archivo, desplazamiento, buffer, cantidad, tipo, estado);
+    registrar(OP_FILE_READ_AT, __builtin_return_address(0), -1, bytes_de(cantidad, tipo), PMPI_Wtime() - inicio);
+    return resultado;
+}
+
+int MPI_File_read_at_all(MPI_File archivo, MPI_Offset desplazamiento, void* buffer, int cantidad,
+                         MPI_Datatype tipo, MPI_Status* estado) {
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_File_read_at_all(archivo, desplazamiento, buffer, cantidad, tipo, estado);
+    registrar(OP_FILE_READ_AT_ALL, __builtin_return_address(0), -1, bytes_de(cantidad, tipo),
+              PMPI_Wtime() - inicio);
+    return resultado;
+}
+
+int MPI_File_write_at_all(MPI_File archivo, MPI_Offset desplazamiento, const void* buffer, int cantidad,
+                          MPI_Datatype tipo, MPI_Status* estado) {
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_File_write_at_all(archivo, desplazamiento, buffer, cantidad, tipo, estado);
+    registrar(OP_FILE_WRITE_AT_ALL, __builtin_return_address(0), -1, bytes_de(cantidad, tipo),
+              PMPI_Wtime() - inicio);
+    return resultado;
+}
+
+int MPI_Barrier(MPI_Comm comunicador) {
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Barrier(comunicador);
+    registrar(OP_BARRIER, __builtin_return_address(0), -1, 0, PMPI_Wtime() - inicio);
+    return resultado;
+}
+
+int MPI_Comm_split(MPI_Comm comunicador, int color, int clave, MPI_Comm* nuevo) {
+    double inicio = PMPI_Wtime();
+    int resultado = PMPI_Comm_split(comunicador, color, clave, nuevo);
+    registrar(OP_COMM_SPLIT, __builtin_return_address(0), -1, 0, PMPI_Wtime() - inicio);
+    return resultado;
+}
+
+int MPI_Comm_free(MPI_Comm* comunicador) {
+    {
+        std::lock_guard<std::mutex> guarda(candado_registros);
+        rangos_comunicadores.erase(*comunicador);
+    }
+    return PMPI_Comm_free(comunicador);
+}
+
+int MPI_Win_free(MPI_Win* ventana) {
+    {
+        std::lock_guard<std::mutex> guarda(candado_registros);
+        rangos_ventanas.erase(*ventana);
+    }
+    return PMPI_Win_free(ventana);
+}
+
+// Nivel 0 suspende el registro y cualquier otro lo reanuda. Los reportes de
+// los programas (reportar_fases, reportar_contadores, reportar_pool) lo usan
+// para que sus reducciones no aparezcan como comunicación del programa
+int MPI_Pcontrol(const int nivel, ...) {
+    registro_activo = nivel != 0;
+    return MPI_SUCCESS;
+}
+
+// Junta los registros de todos los procesos en el 0 (como texto, porque los
+// sitios ya resueltos son cadenas) y reporta antes de cerrar MPI
+int MPI_Finalize() {
+    double tiempo_total = PMPI_Wtime() - inicio_mpi;
+    int mi_rango, numero_procesos;
+    PMPI_Comm_rank(MPI_COMM_WORLD, &mi_rango);
+    PMPI_Comm_size(MPI_COMM_WORLD, &numero_procesos);
+
+    std::string texto = serializar(mi_rango);
+    int longitud = texto.size();
+    std::vector<int> longitudes(numero_procesos), desplazamientos(numero_procesos, 0);
+    PMPI_Gather(&longitud, 1, MPI_INT, longitudes.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+    std::string todo;
+    if (mi_rango == 0) {
+        for (int q = 1; q < numero_procesos; q++) desplazamientos[q] = desplazamientos[q - 1] + longitudes[q - 1];
+        todo.resize(desplazamientos[numero_procesos - 1] + longitudes[numero_procesos - 1]);
+    }
+    PMPI_Gatherv(texto.data(), longitud, MPI_CHAR, &todo[0], longitudes.data(), desplazamientos.data(), MPI_CHAR,
+                 0, MPI_COMM_WORLD);
+
+    double tiempo_maximo;
+    PMPI_Reduce(&tiempo_total, &tiempo_maximo, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    if (mi_rango == 0) {
+        std::vector<Fila> filas = deserializar(todo);
+        reportar(filas, numero_procesos, tiempo_maximo);
+        const char* ruta = getenv("PERFIL_PMPI_CSV");
+        std::string ruta_csv = ruta ? ruta : "perfil_pmpi.csv";
+        if (!ruta_csv.empty()) escribir_csv(ruta_csv, filas);
+    }
+    return PMPI_Finalize();
+}
+
+}  // extern "C"
@@ -0,0 +1,138 @@
+#ifndef POOL_BUFFERS_H
+#define POOL_BUFFERS_H
+
+#include <mpi.h>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+// Pool de buffers temporales de comunicación por proceso. Los bloques se
+// piden a MPI_Alloc_mem (memoria que MPI puede tener ya registrada para RDMA)
+// en clases de tamaño potencia de 2 y, al devolverse, quedan en la lista de
+// su clase para el próximo pedido: un bucle que pide y devuelve un buffer por
+// mensaje reserva memoria una sola vez. Lo usa solo el hilo que hace las
+// llamadas MPI (no es seguro entre hilos)
+const int CLASES_POOL = 48;
+const size_t BYTES_CLASE_MINIMA = 64;
+
+// Conteos del proceso: "pedidos" es lo que se habría reservado sin pool (un
+// buffer nuevo por pedido), "reservas" lo que realmente se pidió a MPI
+struct EstadisticasPool {
+    long long pedidos, bytes_pedidos;
+    long long reservas, bytes_reservados;
+};
+
+class PoolBuffers {
+public:
+    PoolBuffers() : estadisticas() {}
+    ~PoolBuffers() {
+        int finalizado;
+        MPI_Finalized(&finalizado);
+        if (!finalizado) vaciar();
+    }
+
+    // Clase de tamaño: la menor potencia de 2 (desde 64 B) que contiene "bytes"
+    static int clase_de(size_t bytes) {
+        int clase = 0;
+        while ((BYTES_CLASE_MINIMA << clase) < bytes) clase++;
+        return clase;
+    }
+
+    void* pedir(size_t bytes, int& clase) {
+        clase = clase_de(bytes);
+        estadisticas.pedidos++;
+        estadisticas.bytes_pedidos += bytes;
+        if (!libres[clase].empty()) {
+            void* bloque = libres[clase].back();
+            libres[clase].pop_back();
+            return bloque;
+        }
+        size_t tamano = BYTES_CLASE_MINIMA << clase;
+        void* bloque;
+        MPI_Alloc_mem((MPI_Aint)tamano, MPI_INFO_NULL, &bloque);
+        estadisticas.reservas++;
+        estadisticas.bytes_reservados += tamano;
+        return bloque;
+    }
+
+    void devolver(void* bloque, int clase) { libres[clase].push_back(bloque); }
+
+    // Libera los bloques devueltos; debe llamarse antes de MPI_Finalize
+    void vaciar() {
+        for (int clase = 0; clase < CLASES_POOL; clase++) {
+            for (void* bloque : libres[clase]) MPI_Free_mem(bloque);
+            libres[clase].clear();
+        }
+    }
+
+    const EstadisticasPool& obtener_estadisticas() const { return estadisticas; }
+
+private:
+    std::vector<void*> libres[CLASES_POOL];
+    EstadisticasPool estadisticas;
+};
+
+inline PoolBuffers& pool_buffers() {
+    static PoolBuffers pool;
+    return pool;
+}
+
+// Buffer de "elementos" T tomado del pool y devuelto al salir del ámbito:
+//   { BufferPool<double> temporal(n); MPI_Send(temporal.data(), n, ...); }
+template <typename T>
+class BufferPool {
+public:
+    explicit BufferPool(size_t elementos) : elementos(elementos) {
+        bloque = static_cast<T*>(pool_buffers().pedir(elementos * sizeof(T), clase));
+    }
+    ~BufferPool() { pool_buffers().devolver(bloque, clase); }
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    T* data() { return bloque; }
+    const T* data() const { return bloque; }
+    size_t size() const { return elementos; }
+    T& operator[](size_t i) { return bloque[i]; }
+    const T& operator[](size_t i) const { return bloque[i]; }
+
+    void swap(BufferPool& otro) {
+        std::swap(bloque, otro.bloque);
+        std::swap(clase, otro.clase);
+        std::swap(elementos, otro.elementos);
+    }
+
+private:
+    T* bloque;
+    int clase;
+    size_t elementos;
+};
+
+// Reservas y bytes sin pool (antes) y con pool (después), sumados entre los
+// procesos y el máximo de un proceso. Colectiva; imprime la raíz
+inline void reportar_pool(MPI_Comm comunicador, int raiz = 0) {
+    int mi_rango;
+    MPI_Comm_rank(comunicador, &mi_rango);
+    const EstadisticasPool& e = pool_buffers().obtener_estadisticas();
+    long long locales[4] = {e.pedidos, e.bytes_pedidos, e.reservas, e.bytes_reservados};
+    long long sumas[4], maximos[4];
+    // Sin registrar en perfil_pmpi.cpp (ver reportar_fases)
+    MPI_Pcontrol(0);
+    MPI_Reduce(locales, sumas, 4, MPI_LONG_LONG, MPI_SUM, raiz, comunicador);
+    MPI_Reduce(locales, maximos, 4, MPI_LONG_LONG, MPI_MAX, raiz, comunicador);
+    MPI_Pcontrol(1);
+    if (mi_rango != raiz || sumas[0] == 0) return;
+
+    std::cout << "\n=== POOL DE BUFFERS (MPI_Alloc_mem, clases potencia de 2) ===" << std::endl;
+    std::cout << "  " << std::left << std::setw(28) << "" << std::right << std::setw(10) << "Reservas"
+              << std::setw(16) << "Bytes" << std::setw(24) << "Bytes (máx. proceso)" << std::endl;
+    std::cout << "  " << std::left << std::setw(28) << "Sin pool (uno por pedido)" << std::right << std::setw(10)
+              << sumas[0] << std::setw(16) << sumas[1] << std::setw(23) << maximos[1] << std::endl;
+    std::cout << "  " << std::left << std::setw(28) << "Con pool" << std::right << std::setw(10) << sumas[2]
+              << std::setw(16) << sumas[3] << std::setw(23) << maximos[3] << std::endl;
+    std::cout << "Pedidos servidos con bloques reciclados: " << sumas[0] - sumas[2] << " de " << sumas[0]
+              << std::endl;
+}
+
+#endif
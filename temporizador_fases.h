@@ -0,0 +1,165 @@
+#ifndef TEMPORIZADOR_FASES_H
+#define TEMPORIZADOR_FASES_H
+
+#include <mpi.h>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+// Fases en que se divide el trabajo de los programas
+enum Fase {
+    FASE_ENTRADA,       // lectura de parámetros y generación de datos
+    FASE_DISTRIBUCION,  // reparto y movimiento de datos (Scatter, Send, Bcast, Alltoall)
+    FASE_CALCULO,       // cálculo local
+    FASE_REDUCCION,     // reducción y recolección de resultados (Reduce, Gather)
+    FASE_SALIDA,        // presentación de resultados
+    NUMERO_FASES
+};
+
+static const char* const NOMBRES_FASES[NUMERO_FASES] = {"entrada", "distribucion", "calculo", "reduccion",
+                                                        "salida"};
+
+// Reloj monótono de alta resolución (steady_clock), en segundos desde la
+// primera lectura del proceso: no retrocede con ajustes de la hora del sistema
+inline double reloj_monotono() {
+    static const std::chrono::steady_clock::time_point origen = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - origen).count();
+}
+
+// Resolución y costo de lectura del reloj, medidos una vez por proceso
+struct CalibracionReloj {
+    double resolucion;     // menor avance observable entre dos lecturas
+    double costo_lectura;  // lo que agrega una lectura a un intervalo medido
+};
+
+inline CalibracionReloj calibrar_reloj() {
+    const int MUESTRAS = 1000, LECTURAS = 100000;
+    CalibracionReloj calibracion;
+
+    calibracion.resolucion = 1.0;
+    for (int i = 0; i < MUESTRAS; i++) {
+        double anterior = reloj_monotono(), actual;
+        do {
+            actual = reloj_monotono();
+        } while (actual == anterior);
+        calibracion.resolucion = std::min(calibracion.resolucion, actual - anterior);
+    }
+
+    double inicio = reloj_monotono();
+    for (int i = 0; i < LECTURAS; i++) reloj_monotono();
+    calibracion.costo_lectura = (reloj_monotono() - inicio) / (LECTURAS + 1);
+    return calibracion;
+}
+
+inline const CalibracionReloj& calibracion_reloj() {
+    static const CalibracionReloj calibracion = calibrar_reloj();
+    return calibracion;
+}
+
+// Segundos acumulados por fase en este proceso
+inline double* tiempos_fases() {
+    static double acumulados[NUMERO_FASES] = {0.0};
+    return acumulados;
+}
+
+inline void reiniciar_fases() {
+    for (int fase = 0; fase < NUMERO_FASES; fase++) tiempos_fases()[fase] = 0.0;
+}
+
+// Suma al acumulado de su fase lo que dura su ámbito (o hasta detener()),
+// descontando el costo de leer el reloj:
+//   { TemporizadorFase t(FASE_CALCULO); ...cálculo... }
+class TemporizadorFase {
+public:
+    explicit TemporizadorFase(Fase fase) : fase(fase), activo(true), costo(calibracion_reloj().costo_lectura),
+                                           inicio(reloj_monotono()) {}
+    ~TemporizadorFase() { detener(); }
+
+    void detener() {
+        if (!activo) return;
+        tiempos_fases()[fase] += std::max(0.0, reloj_monotono() - inicio - costo);
+        activo = false;
+    }
+
+    // Vuelve a medir después de detener(), por ejemplo tras una pausa de otra fase
+    void reanudar() {
+        if (activo) return;
+        inicio = reloj_monotono();
+        activo = true;
+    }
+
+private:
+    Fase fase;
+    bool activo;
+    double costo;
+    double inicio;
+};
+
+// Mínimo, media y máximo entre los procesos de cada fase y el desbalance
+// (máx. / media: 1 es reparto perfecto). Colectiva sobre el comunicador; la
+// raíz imprime la tabla y una estimación de qué limita la ejecución:
+//  - cálculo:       media de la fase de cálculo
+//  - comunicación:  media de distribución + reducción (incluye esperas)
+//  - desbalance:    máx. - media del cálculo, lo que los demás esperan al más lento
+inline void reportar_fases(MPI_Comm comunicador, int raiz = 0) {
+    int mi_rango, numero_procesos;
+    MPI_Comm_rank(comunicador, &mi_rango);
+    MPI_Comm_size(comunicador, &numero_procesos);
+
+    // La última posición es el total del proceso
+    double locales[NUMERO_FASES + 1], minimos[NUMERO_FASES + 1], maximos[NUMERO_FASES + 1],
+        sumas[NUMERO_FASES + 1];
+    locales[NUMERO_FASES] = 0.0;
+    for (int fase = 0; fase < NUMERO_FASES; fase++) {
+        locales[fase] = tiempos_fases()[fase];
+        locales[NUMERO_FASES] += locales[fase];
+    }
+    // Las reducciones del reporte no son comunicación del programa: se
+    // suspende el registro de un perfilador PMPI (perfil_pmpi.cpp)
+    MPI_Pcontrol(0);
+    MPI_Reduce(locales, minimos, NUMERO_FASES + 1, MPI_DOUBLE, MPI_MIN, raiz, comunicador);
+    MPI_Reduce(locales, maximos, NUMERO_FASES + 1, MPI_DOUBLE, MPI_MAX, raiz, comunicador);
+    MPI_Reduce(locales, sumas, NUMERO_FASES + 1, MPI_DOUBLE, MPI_SUM, raiz, comunicador);
+    MPI_Pcontrol(1);
+    if (mi_rango != raiz) return;
+
+    std::ios formato(nullptr);
+    formato.copyfmt(std::cout);
+
+    const CalibracionReloj& calibracion = calibracion_reloj();
+    std::cout << "\n=== TIEMPOS POR FASE (" << numero_procesos << " procesos) ===" << std::endl;
+    std::cout << "Reloj monótono: resolución " << std::fixed << std::setprecision(1)
+              << calibracion.resolucion * 1e9 << " ns, lectura " << calibracion.costo_lectura * 1e9
+              << " ns (descontada)" << std::endl;
+    std::cout << "  " << std::left << std::setw(14) << "Fase" << std::right << std::setw(13) << "Mín. (s)"
+              << std::setw(12) << "Media (s)" << std::setw(13) << "Máx. (s)" << std::setw(13) << "Desbalance"
+              << std::endl;
+
+    double medias[NUMERO_FASES + 1];
+    for (int fase = 0; fase <= NUMERO_FASES; fase++) {
+        medias[fase] = sumas[fase] / numero_procesos;
+        std::cout << "  " << std::left << std::setw(14) << (fase < NUMERO_FASES ? NOMBRES_FASES[fase] : "total")
+                  << std::right << std::setprecision(6) << std::setw(12) << minimos[fase] << std::setw(12)
+                  << medias[fase] << std::setw(12) << maximos[fase] << std::setw(13);
+        if (medias[fase] > 0) std::cout << std::setprecision(2) << maximos[fase] / medias[fase];
+        else std::cout << "-";
+        std::cout << std::endl;
+    }
+
+    double calculo = medias[FASE_CALCULO];
+    double comunicacion = medias[FASE_DISTRIBUCION] + medias[FASE_REDUCCION];
+    double desbalance = maximos[FASE_CALCULO] - medias[FASE_CALCULO];
+    if (calculo + comunicacion > 0) {
+        std::cout << "Limitado por: "
+                  << (desbalance >= calculo && desbalance >= comunicacion ? "desbalance"
+                      : calculo >= comunicacion                           ? "cálculo"
+                                                                          : "comunicación")
+                  << std::setprecision(6) << " (cálculo " << calculo << " s, comunicación " << comunicacion
+                  << " s, desbalance " << desbalance << " s)" << std::endl;
+    }
+
+    std::cout.copyfmt(formato);
+}
+
+#endif